@@ -11,6 +11,11 @@
  * - Stateless across sessions (except model)
  * - Deterministic execution
  * - No UI callbacks, clipboard, hotkeys, network
+ * 
+ * Two API styles:
+ * - wf_engine_init / wf_engine_* drive a single process-wide engine
+ * - WFEngine / WFSession handles create any number of independent
+ *   engines, each with its own state, lock, work queue and worker
  */
 
 #ifndef WISPRFLEX_ENGINE_H
@@ -57,7 +62,9 @@ typedef enum WFErrorCode {
     WF_ERROR_INTERNAL = 12,
     WF_ERROR_ALREADY_INITIALIZED = 13,
     WF_ERROR_NOT_INITIALIZED = 14,
-    WF_ERROR_DISPOSED = 15
+    WF_ERROR_DISPOSED = 15,
+    WF_ERROR_MODEL_LOAD_CANCELLED = 16,
+    WF_ERROR_NOT_ALLOWED_IN_CALLBACK = 17
 } WFErrorCode;
 
 /**
@@ -85,11 +92,17 @@ typedef enum WFLogLevel {
 typedef struct WFEngineConfig {
     WFDeviceType device;
     WFLogLevel log_level;
+    const char* model_dir;  /* NULL for "models"; holds <id>/model.gguf or ggml-<id>.bin */
 } WFEngineConfig;
 
+/**
+ * With vad_enabled, silence is not transcribed and ~700 ms of silence
+ * after speech ends an utterance: its WF_EVENT_FINAL_TRANSCRIPT is
+ * emitted immediately and the session continues with the next one.
+ */
 typedef struct WFSessionConfig {
     const char* language;   /* NULL for auto */
-    int vad_enabled;        /* 1 = enabled (default), 0 = disabled */
+    int vad_enabled;        /* 1 = enabled (default): silent audio is not transcribed, 0 = disabled */
 } WFSessionConfig;
 
 /* ============================================
@@ -101,7 +114,8 @@ typedef enum WFEventType {
     WF_EVENT_FINAL_TRANSCRIPT = 1,
     WF_EVENT_ERROR = 2,
     WF_EVENT_MODEL_PROGRESS = 3,
-    WF_EVENT_BACKPRESSURE_WARNING = 4
+    WF_EVENT_BACKPRESSURE_WARNING = 4,  /* Session fell behind: audio merged or dropped */
+    WF_EVENT_QUALITY_CHANGED = 5        /* Session degraded to keep up, or recovered */
 } WFEventType;
 
 typedef struct WFEvent {
@@ -130,14 +144,29 @@ typedef struct WFEvent {
         } model_progress;
         
         struct {
-            int dropped_chunks;
+            int dropped_chunks;     /* Pushes rejected with WF_ERROR_BACKPRESSURE_LIMIT (session total) */
+            int merged_chunks;      /* Pushed chunks transcribed in merged windows (session total) */
+            int lag_ms;             /* Age of the oldest audio not yet transcribed */
         } backpressure_warning;
+        
+        struct {
+            int level;              /* 0 = full, 1 = fast decoding, 2 = fallback model */
+            const char* model_id;   /* Model transcribing the session from now on */
+            float rtf;              /* Smoothed inference time per second of audio before the change */
+        } quality_changed;
     } data;
 } WFEvent;
 
 /**
  * Event callback function type
- * Called from worker thread - must be thread-safe
+ * Called from the engine's worker thread and from inference pool
+ * threads - must be thread-safe. Events of one session never overlap.
+ * These threads cannot wait for themselves, so from a callback:
+ * - wf_engine_create, wf_engine_init, wf_engine_destroy and
+ *   wf_engine_dispose return WF_ERROR_NOT_ALLOWED_IN_CALLBACK
+ * - wf_engine_set_thread_budget stores the budget, but the worker count
+ *   changes only when an engine handles its next request (model load,
+ *   session start or end)
  */
 typedef void (*WFEventCallback)(const WFEvent* event, void* user_data);
 
@@ -148,6 +177,8 @@ typedef void (*WFEventCallback)(const WFEvent* event, void* user_data);
 /**
  * Initialize the engine runtime
  * Must be called exactly once before any other operations.
+ * Creates the process-wide engine used by all wf_engine_* calls that
+ * take no handle; it is independent of engines from wf_engine_create.
  * 
  * @param config Engine configuration
  * @return WF_OK on success, error code on failure
@@ -167,12 +198,58 @@ WFErrorCode wf_engine_set_callback(WFEventCallback callback, void* user_data);
 /**
  * Load a transcription model
  * Only one model loaded at a time - automatically unloads previous.
+ * Returns immediately; the model file is read on the worker thread.
+ * WF_EVENT_MODEL_PROGRESS reports 0, then the share of the file read
+ * (up to 99), then 100 when the model is ready; only then does
+ * wf_engine_get_loaded_model return it. Failures arrive as WF_EVENT_ERROR.
+ * A session may be started meanwhile; it begins once the load completes.
+ * A new load request cancels one still in progress.
  * 
  * @param model_id Model identifier (e.g., "base", "small")
- * @return WF_OK on success, error code on failure
+ * @return WF_OK if the load was queued, error code on failure
  */
 WFErrorCode wf_engine_load_model(const char* model_id);
 
+/**
+ * Cancel a model load in progress
+ * The load stops at its next read and WF_EVENT_ERROR reports
+ * WF_ERROR_MODEL_LOAD_CANCELLED. No-op if no load is in progress.
+ * 
+ * @return WF_OK
+ */
+WFErrorCode wf_engine_cancel_model_load(void);
+
+/**
+ * Two-tier transcription: a larger model for final transcripts
+ * The model from wf_engine_load_model then only drafts partials on short
+ * windows; each utterance is re-transcribed by the final model in the
+ * background and WF_EVENT_FINAL_TRANSCRIPT carries its text. Both share
+ * the session's audio. Takes effect at the next wf_engine_load_model,
+ * which reports 100 once both models are ready. Sessions without VAD
+ * use the draft model only.
+ * 
+ * @param model_id Final model (e.g. "base"), NULL or "" = one model (default)
+ * @param n_threads Threads of the final pass, 0 = threads per inference
+ *                  of the thread budget. Held from the thread budget
+ *                  while the session is open.
+ * @return WF_OK, WF_ERROR_MODEL_NOT_FOUND for an unknown model
+ */
+WFErrorCode wf_engine_set_final_model(const char* model_id, int n_threads);
+
+/**
+ * Smaller model for sessions that cannot keep up
+ * A session whose inference stays slower than real time first switches
+ * to faster decoding, then to this model (kept resident with the loaded
+ * one, so the switch is immediate). It switches back once the load has
+ * dropped. Each change is reported with WF_EVENT_QUALITY_CHANGED; without
+ * a fallback model only decoding is degraded. Takes effect at the next
+ * wf_engine_load_model.
+ * 
+ * @param model_id Fallback model (e.g. "tiny"), NULL or "" = none (default)
+ * @return WF_OK, WF_ERROR_MODEL_NOT_FOUND for an unknown model
+ */
+WFErrorCode wf_engine_set_fallback_model(const char* model_id);
+
 /**
  * Unload the currently loaded model
  * Safe to call even if no model is loaded.
@@ -181,6 +258,44 @@ WFErrorCode wf_engine_load_model(const char* model_id);
  */
 WFErrorCode wf_engine_unload_model(void);
 
+/**
+ * Memory budget for resident models (process-wide, all engines)
+ * With a budget, models stay resident after being unloaded or replaced,
+ * so switching back (e.g. tiny <-> base) skips the reload. The least
+ * recently used idle model is evicted when a load needs room; a load
+ * that cannot fit is reported as WF_ERROR_OUT_OF_MEMORY.
+ * 
+ * @param budget_bytes 0 (default) = no limit and no retention
+ * @return WF_OK
+ */
+WFErrorCode wf_engine_set_model_budget(size_t budget_bytes);
+
+/**
+ * Inference thread budget (process-wide, all engines)
+ * Session audio from every engine is transcribed on one shared pool of
+ * inference workers that steal work from each other. The budget is
+ * split so that workers x threads per inference never exceeds it.
+ * While a two-tier session (wf_engine_set_final_model) is open, its
+ * final-pass threads are taken out of the budget before the split.
+ * Worker count changes apply immediately (from an event callback: see
+ * WFEventCallback); the per-inference thread count applies to sessions
+ * started afterwards.
+ * 
+ * @param total_threads 0 (default) = number of hardware threads
+ * @param workers 0 (default) = one worker per 4 threads; capped at total_threads
+ * @return WF_OK
+ */
+WFErrorCode wf_engine_set_thread_budget(int total_threads, int workers);
+
+/**
+ * Current split of the thread budget
+ * 
+ * @param workers_out Receives the number of inference workers (may be NULL)
+ * @param threads_per_worker_out Receives threads per inference (may be NULL)
+ * @return WF_OK
+ */
+WFErrorCode wf_engine_get_thread_budget(int* workers_out, int* threads_per_worker_out);
+
 /**
  * Start a new transcription session
  * Requires model to be loaded. One active session at a time.
@@ -198,7 +313,16 @@ WFErrorCode wf_engine_start_session(
 
 /**
  * Push audio data into an active session
- * Non-blocking. Engine may apply backpressure.
+ * Non-blocking and allocation-free: samples are copied into the session's
+ * preallocated ring buffer without taking the engine lock.
+ * Returns WF_ERROR_BACKPRESSURE_LIMIT (nothing copied) when the samples
+ * do not fit in the buffered-audio budget (30 s).
+ * Each push is due at the backend within the session's target latency
+ * (default 1000 ms, see wf_session_set_target_latency). A session past
+ * that deadline has its queued audio transcribed in larger merged
+ * windows - slower partials rather than lost audio - and gets
+ * WF_EVENT_BACKPRESSURE_WARNING (at most once per second).
+ * Safe to call from a real-time capture callback.
  * 
  * @param session_id Session identifier
  * @param pcm_data PCM Float32 audio data (16kHz, mono)
@@ -214,6 +338,10 @@ WFErrorCode wf_engine_push_audio(
 /**
  * End a transcription session
  * Flushes remaining buffers and triggers final transcription.
+ * The final text arrives asynchronously as WF_EVENT_FINAL_TRANSCRIPT.
+ * With VAD enabled, each utterance already got its own FINAL_TRANSCRIPT
+ * after ~700 ms of silence; this last one carries only speech since the
+ * previous utterance (possibly empty text).
  * 
  * @param session_id Session identifier
  * @return WF_OK on success, error code on failure
@@ -224,10 +352,141 @@ WFErrorCode wf_engine_end_session(const char* session_id);
  * Shut down engine and free all resources
  * Idempotent - safe to call multiple times.
  * 
- * @return WF_OK on success
+ * @return WF_OK on success, WF_ERROR_NOT_ALLOWED_IN_CALLBACK from an
+ *         event callback
  */
 WFErrorCode wf_engine_dispose(void);
 
+/* ============================================
+ * Multi-Instance API
+ * ============================================ */
+
+/**
+ * Opaque engine and session handles
+ * 
+ * Each WFEngine has its own model, session, event callback and worker
+ * thread; calls on different engines never contend. Engines that load
+ * the same model file share its weights.
+ * Semantics match the single-engine calls above: one model and one
+ * active session per engine.
+ */
+typedef struct WFEngine WFEngine;
+typedef struct WFSession WFSession;
+
+/**
+ * Create an engine
+ * 
+ * @param config Engine configuration
+ * @param engine_out Receives the engine handle
+ * @return WF_OK on success, error code on failure
+ */
+WFErrorCode wf_engine_create(const WFEngineConfig* config, WFEngine** engine_out);
+
+/**
+ * Destroy an engine
+ * Ends its active session (no final transcript), stops its worker and
+ * frees it. Session handles must still be released afterwards; they
+ * only report WF_ERROR_SESSION_ENDED. NULL is ignored.
+ * 
+ * @param engine Engine from wf_engine_create
+ * @return WF_OK on success, WF_ERROR_NOT_ALLOWED_IN_CALLBACK from an
+ *         event callback
+ */
+WFErrorCode wf_engine_destroy(WFEngine* engine);
+
+/**
+ * Set the event callback of an engine
+ * Called from that engine's worker thread and the inference pool.
+ */
+WFErrorCode wf_engine_instance_set_callback(
+    WFEngine* engine,
+    WFEventCallback callback,
+    void* user_data
+);
+
+/**
+ * Load a model into an engine (see wf_engine_load_model)
+ */
+WFErrorCode wf_engine_instance_load_model(WFEngine* engine, const char* model_id);
+
+/**
+ * Cancel a model load in progress (see wf_engine_cancel_model_load)
+ */
+WFErrorCode wf_engine_instance_cancel_model_load(WFEngine* engine);
+
+/**
+ * Set the final model of an engine (see wf_engine_set_final_model)
+ */
+WFErrorCode wf_engine_instance_set_final_model(WFEngine* engine, const char* model_id, int n_threads);
+
+/**
+ * Set the fallback model of an engine (see wf_engine_set_fallback_model)
+ */
+WFErrorCode wf_engine_instance_set_fallback_model(WFEngine* engine, const char* model_id);
+
+/**
+ * Unload the model of an engine (see wf_engine_unload_model)
+ */
+WFErrorCode wf_engine_instance_unload_model(WFEngine* engine);
+
+/**
+ * Get the model ID loaded into an engine
+ * @return Model ID or NULL if no model loaded
+ */
+const char* wf_engine_instance_get_loaded_model(WFEngine* engine);
+
+/**
+ * Start a session on an engine (see wf_engine_start_session)
+ * 
+ * @param engine Engine handle
+ * @param config Session configuration (may be NULL for defaults)
+ * @param session_out Receives the session handle; free with wf_session_release
+ * @return WF_OK on success, error code on failure
+ */
+WFErrorCode wf_session_start(
+    WFEngine* engine,
+    const WFSessionConfig* config,
+    WFSession** session_out
+);
+
+/**
+ * Push audio into a session (see wf_engine_push_audio)
+ * Lock-free; safe to call from a real-time capture callback.
+ */
+WFErrorCode wf_session_push_audio(
+    WFSession* session,
+    const float* pcm_data,
+    size_t sample_count
+);
+
+/**
+ * Set how soon pushed audio should reach inference
+ * Applies to chunks pushed afterwards. A session whose oldest queued
+ * chunk is past this deadline catches up with merged windows (see
+ * wf_engine_push_audio).
+ * 
+ * @param target_latency_ms Milliseconds; <= 0 restores the default (1000)
+ * @return WF_OK, or WF_ERROR_INVALID_SESSION for NULL
+ */
+WFErrorCode wf_session_set_target_latency(WFSession* session, int target_latency_ms);
+
+/**
+ * End a session (see wf_engine_end_session)
+ * The handle stays valid; later pushes return WF_ERROR_SESSION_ENDED.
+ */
+WFErrorCode wf_session_end(WFSession* session);
+
+/**
+ * Get the session ID carried by this session's events
+ */
+const char* wf_session_get_id(const WFSession* session);
+
+/**
+ * Free a session handle, ending the session first if still active.
+ * Must not race with wf_session_push_audio on the same handle. NULL is ignored.
+ */
+void wf_session_release(WFSession* session);
+
 /* ============================================
  * Utility Functions
  * ============================================ */
@@ -250,6 +509,35 @@ const char* wf_engine_get_loaded_model(void);
  */
 const char* wf_engine_get_active_session(void);
 
+/* ============================================
+ * Tracing
+ * ============================================ */
+
+/**
+ * Start capturing a pipeline trace (process-wide, all engines)
+ * Records pushes, drain tasks, backend chunk processing and each
+ * whisper_full call (split into mel/encode/decode), event callbacks and
+ * worker-thread work, with an arrow from every pushed chunk to the drain
+ * that consumed it. Discards any previous capture. May be called before
+ * wf_engine_init. Costs one relaxed atomic load per span when not
+ * capturing; while capturing, a thread's first event allocates its
+ * buffer, including on a capture thread that pushes audio.
+ * 
+ * @param max_events_per_thread Events kept per thread; later ones are
+ *        dropped and counted (0 = 65536, about 3 MB per thread)
+ * @return WF_OK
+ */
+WFErrorCode wf_engine_trace_start(size_t max_events_per_thread);
+
+/**
+ * Stop capturing and write Chrome trace-event JSON
+ * Open the file in ui.perfetto.dev or chrome://tracing.
+ * 
+ * @param output_path File to write (NULL = stop without writing)
+ * @return WF_OK, or WF_ERROR_INTERNAL if the file cannot be written
+ */
+WFErrorCode wf_engine_trace_stop(const char* output_path);
+
 #ifdef __cplusplus
 }
 #endif
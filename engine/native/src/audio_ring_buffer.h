@@ -0,0 +1,118 @@
+/**
+ * WisprFlex Native Engine - Lock-free PCM Ring Buffer
+ *
+ * Internal header - not part of public API.
+ *
+ * Single-producer / single-consumer ring of Float32 samples.
+ * - Storage is allocated once at construction (no allocation on push)
+ * - Producer (capture thread) only writes head_, consumer (worker) only tail_
+ * - Writes are all-or-nothing so callers can apply sample-based backpressure
+ */
+
+#ifndef WISPRFLEX_AUDIO_RING_BUFFER_H
+#define WISPRFLEX_AUDIO_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+
+class AudioRingBuffer {
+public:
+    /**
+     * @param min_capacity Minimum number of samples; rounded up to a power of two
+     */
+    explicit AudioRingBuffer(size_t min_capacity) {
+        size_t capacity = 1;
+        while (capacity < min_capacity) {
+            capacity <<= 1;
+        }
+        buffer_.reset(new (std::nothrow) float[capacity]);
+        capacity_ = buffer_ ? capacity : 0;
+        mask_ = capacity_ ? capacity_ - 1 : 0;
+    }
+
+    AudioRingBuffer(const AudioRingBuffer&) = delete;
+    AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+    bool valid() const { return capacity_ != 0; }
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * Samples currently buffered. Exact from either side's own thread,
+     * a lower/upper bound when read from a third thread.
+     */
+    size_t size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    size_t write_available() const {
+        return capacity_ - size();
+    }
+
+    /**
+     * Producer side. Copies all n samples or none.
+     * @return true if written, false if not enough free space
+     */
+    bool write(const float* data, size_t n) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        if (n > capacity_ - (head - tail)) {
+            return false;
+        }
+
+        size_t start = head & mask_;
+        size_t first = (n < capacity_ - start) ? n : capacity_ - start;
+        memcpy(buffer_.get() + start, data, first * sizeof(float));
+        if (n > first) {
+            memcpy(buffer_.get(), data + first, (n - first) * sizeof(float));
+        }
+
+        head_.store(head + n, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side. Copies up to max_samples into out.
+     * @return Number of samples read
+     */
+    size_t read(float* out, size_t max_samples) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t n = head - tail;
+        if (n > max_samples) {
+            n = max_samples;
+        }
+
+        size_t start = tail & mask_;
+        size_t first = (n < capacity_ - start) ? n : capacity_ - start;
+        memcpy(out, buffer_.get() + start, first * sizeof(float));
+        if (n > first) {
+            memcpy(out + first, buffer_.get(), (n - first) * sizeof(float));
+        }
+
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * Consumer side. Discards everything currently buffered.
+     */
+    void clear() {
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    std::unique_ptr<float[]> buffer_;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+
+    // Separate cache lines so producer and consumer don't false-share
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+#endif /* WISPRFLEX_AUDIO_RING_BUFFER_H */
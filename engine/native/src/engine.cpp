@@ -1,7 +1,12 @@
 /**
  * WisprFlex Native Engine - Main Implementation
  * 
- * Phase 2.1: Skeleton implementation (no-ops, no whisper.cpp)
+ * Without WISPRFLEX_HAS_WHISPER model and session work is a no-op.
+ * With it, each engine's worker thread drives whisper_backend for
+ * control work (model load, session start, finalization), while
+ * session audio is drained and transcribed on the inference pool shared
+ * by all engines (schedule_drain/run_drain_task). Both report back
+ * through the event callback.
  * 
  * From ENGINE_ARCHITECTURE.md:
  * - Section 4.3: Native Core is stateless across sessions
@@ -9,13 +14,26 @@
  * - Section 8: Failures contained, reported to controller
  * 
  * Thread Safety:
- * - All state access protected by g_engine_mutex
+ * - Each WFEngine owns its state, mutex, work queue and worker thread;
+ *   engines never share a lock on the control or audio path
  * - Worker thread processes queue asynchronously
- * - No shared mutable globals (state is in g_state)
+ * - Pushing audio is lock-free (see SessionStream)
+ * - Session audio from all engines is transcribed on one work-stealing
+ *   inference pool sized by the thread budget (see schedule_drain)
+ * - The handle-less wf_engine_* API wraps one default engine.
+ *   g_engine_mutex only guards which engine/session that is; the
+ *   lock-free push reaches the session through g_active_stream, pinned
+ *   by g_push_refs.
  */
 
 #include "../include/wisprflex_engine.h"
 #include "engine_state.h"
+#include "worker_pool.h"
+#include "trace.h"
+
+#ifdef WISPRFLEX_HAS_WHISPER
+#include "whisper_backend.h"
+#endif
 
 #include <cstring>
 #include <cstdio>
@@ -23,13 +41,66 @@
 #include <chrono>
 #include <sstream>
 #include <random>
+#include <algorithm>
+#include <vector>
 
 /* ============================================
- * Global Engine State (single instance)
+ * Global State
  * ============================================ */
 
+// Default engine behind the handle-less API. Lock order: g_engine_mutex,
+// then the engine's own mutex.
 static std::mutex g_engine_mutex;
-static EngineStateData* g_state = nullptr;
+static WFEngine* g_default_engine = nullptr;
+static WFSession* g_default_session = nullptr;
+
+// Lock-free audio path (see wf_engine_push_audio)
+static std::atomic<SessionStream*> g_active_stream{nullptr};
+static std::atomic<int> g_push_refs{0};
+
+#ifdef WISPRFLEX_HAS_WHISPER
+// whisper_backend is process-wide; initialized while any engine exists
+static std::mutex g_backend_mutex;
+static int g_backend_users = 0;
+#endif
+
+// Inference pool shared by all engines; running while any engine exists.
+// g_pool_mutex guards its lifecycle and is held while workers are joined,
+// so pool threads never take it; g_budget_mutex guards the thread budget.
+static WorkStealingPool g_inference_pool;
+static std::mutex g_pool_mutex;
+static int g_pool_users = 0;
+static std::mutex g_budget_mutex;
+static int g_thread_budget = 0;         // 0 = hardware threads
+static int g_requested_workers = 0;     // 0 = derived from the budget
+static int g_final_pass_threads = 0;    // Held by open two-tier sessions
+static std::atomic<int> g_inference_threads{1};  // n_threads per inference
+static std::atomic<bool> g_pool_resize_pending{false};  // Budget set in a callback
+
+// Set while the current thread runs an event callback
+static thread_local bool t_in_callback = false;
+
+// Threads one inference gets when the pool size is derived (whisper's
+// own default, beyond which a single decode scales poorly)
+static const int THREADS_PER_INFERENCE = 4;
+
+// Audio handed to the backend per drain task; a stream with more
+// buffered requeues itself behind the other sessions
+static const size_t DRAIN_BATCH_SAMPLES = 16000;
+
+// A stream past the deadline of its oldest queued chunk hands up to this
+// much to the backend at once, which runs it as one larger window
+// (WBSessionConfig::max_window_ms)
+static const int MAX_MERGED_WINDOW_MS = 8000;
+static const size_t MAX_MERGED_SAMPLES = (size_t)MAX_MERGED_WINDOW_MS * 16;
+
+// Minimum spacing of WF_EVENT_BACKPRESSURE_WARNING per session
+static const int64_t BACKPRESSURE_WARNING_INTERVAL_US = 1000000;
+
+#ifdef WISPRFLEX_HAS_WHISPER
+// Sessions slower than real time (after adaptive windows) degrade
+static const float DEGRADE_RTF = 1.0f;
+#endif
 
 /* ============================================
  * Version
@@ -61,11 +132,13 @@ static const char* ERROR_MESSAGES[] = {
     "Internal engine error",                // WF_ERROR_INTERNAL
     "Engine already initialized",           // WF_ERROR_ALREADY_INITIALIZED
     "Engine not initialized",               // WF_ERROR_NOT_INITIALIZED
-    "Engine disposed"                       // WF_ERROR_DISPOSED
+    "Engine disposed",                      // WF_ERROR_DISPOSED
+    "Model load cancelled",                 // WF_ERROR_MODEL_LOAD_CANCELLED
+    "Not allowed from an event callback"    // WF_ERROR_NOT_ALLOWED_IN_CALLBACK
 };
 
 const char* wf_engine_error_message(WFErrorCode code) {
-    if (code >= 0 && code <= WF_ERROR_DISPOSED) {
+    if (code >= 0 && code <= WF_ERROR_NOT_ALLOWED_IN_CALLBACK) {
         return ERROR_MESSAGES[code];
     }
     return "Unknown error";
@@ -75,9 +148,8 @@ const char* wf_engine_error_message(WFErrorCode code) {
  * Logging
  * ============================================ */
 
-static void log_message(int level, const char* message) {
-    std::lock_guard<std::mutex> lock(g_engine_mutex);
-    if (g_state && level <= g_state->log_level) {
+static void log_message(const EngineStateData& e, int level, const char* message) {
+    if (level <= e.log_level.load(std::memory_order_relaxed)) {
         const char* level_str = (level == 0) ? "ERROR" : (level == 1) ? "WARN" : "INFO";
         printf("[WisprFlex:%s] %s\n", level_str, message);
     }
@@ -107,377 +179,1489 @@ static std::string generate_session_id() {
     return ss.str();
 }
 
+
 /* ============================================
- * Worker Thread
+ * Audio Streams
  * ============================================ */
 
-static void worker_thread_func() {
-    log_message(2, "Worker thread started");
+/**
+ * Stop accepting audio on a stream.
+ * On return no pusher is inside push_to_stream() for it, and none will
+ * touch the stream's engine again.
+ */
+static void close_session_stream(SessionStream& stream) {
+    stream.closed.store(true);
+    while (stream.push_refs.load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+static void schedule_drain(SessionStream& stream);
+#ifdef WISPRFLEX_HAS_WHISPER
+static void reserve_final_pass_threads(SessionStream& stream, int threads);
+#endif
+static void release_final_pass_threads(SessionStream& stream);
+static void apply_pending_thread_budget();
+
+static int64_t steady_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Copy samples into a stream's ring (any thread, never waits on the
+ * engine lock)
+ */
+static WFErrorCode push_to_stream(SessionStream& stream, const float* pcm_data, size_t sample_count) {
+    TraceScope trace("push_audio", "engine", "samples", (int64_t)sample_count);
+    stream.push_refs.fetch_add(1);
     
-    while (true) {
-        WorkItem item;
-        
-        // Wait for work
-        {
-            std::unique_lock<std::mutex> lock(g_engine_mutex);
-            if (!g_state) break;
-            
-            g_state->queue_cv.wait(lock, [&] {
-                return !g_state || 
-                       g_state->shutdown_requested || 
-                       !g_state->work_queue.empty();
-            });
-            
-            if (!g_state || (g_state->shutdown_requested && g_state->work_queue.empty())) {
-                break;
-            }
-            
-            if (!g_state->work_queue.empty()) {
-                item = std::move(g_state->work_queue.front());
-                g_state->work_queue.pop();
-            } else {
-                continue;
+    WFErrorCode result = WF_OK;
+    
+    if (stream.closed.load()) {
+        result = WF_ERROR_SESSION_ENDED;
+    } else if (!pcm_data || sample_count == 0) {
+        result = WF_ERROR_AUDIO_STREAM_ERROR;
+    } else {
+        while (stream.producer_lock.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        bool written = stream.ring.write(pcm_data, sample_count);
+        if (written) {
+            // The chunk carries its deadline (and trace arrow) to the drain
+            int64_t now_us = steady_now_us();
+            uint64_t flow = 0;
+            if (trace_enabled()) {
+                flow = trace_next_flow_id();
+                trace_flow_start("chunk", flow);
             }
+            stream.pushed_samples += sample_count;
+            stream.marks.push({stream.pushed_samples, now_us,
+                               now_us + (int64_t)stream.target_latency_ms.load() * 1000, flow});
         }
+        stream.producer_lock.clear(std::memory_order_release);
         
-        // Process work item (Phase 2.1: no-ops with simulated delays)
-        switch (item.type) {
-            case WorkItem::Type::LOAD_MODEL:
-                log_message(2, "Worker: Processing LOAD_MODEL (no-op)");
-                // In Phase 2.2+, this would load whisper.cpp model
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                break;
-                
-            case WorkItem::Type::UNLOAD_MODEL:
-                log_message(2, "Worker: Processing UNLOAD_MODEL (no-op)");
-                break;
-                
-            case WorkItem::Type::PROCESS_AUDIO:
-                log_message(2, "Worker: Processing PROCESS_AUDIO (no-op)");
-                // In Phase 2.2+, this would run whisper inference
-                break;
-                
-            case WorkItem::Type::END_SESSION:
-                log_message(2, "Worker: Processing END_SESSION (no-op)");
-                break;
-                
-            case WorkItem::Type::SHUTDOWN:
-                log_message(2, "Worker: Shutdown requested");
-                return;
+        // Backpressure: buffered samples, not queue items
+        if (written) {
+            stream.chunk_count.fetch_add(1, std::memory_order_relaxed);
+            schedule_drain(stream);
+        } else {
+            stream.rejected_pushes.fetch_add(1, std::memory_order_relaxed);
+            result = WF_ERROR_BACKPRESSURE_LIMIT;
         }
     }
     
-    log_message(2, "Worker thread stopped");
+    stream.push_refs.fetch_sub(1);
+    return result;
 }
 
 /* ============================================
- * Engine Lifecycle API Implementation
+ * Worker Thread
  * ============================================ */
 
-WFErrorCode wf_engine_init(const WFEngineConfig* config) {
-    std::lock_guard<std::mutex> lock(g_engine_mutex);
-    
-    // Check if already initialized
-    if (g_state && g_state->state != EngineState::DISPOSED) {
-        return WF_ERROR_ALREADY_INITIALIZED;
-    }
-    
-    // Validate config
-    if (!config) {
-        return WF_ERROR_INIT_FAILED;
-    }
-    
-    // Phase 2.1: Only CPU supported
-    if (config->device != WF_DEVICE_CPU) {
-        return WF_ERROR_DEVICE_NOT_SUPPORTED;
+/**
+ * Deliver an event to the engine's callback (worker or pool thread).
+ * The callback is invoked without the engine mutex held so it may call
+ * back into the engine; calls that would wait for the calling thread
+ * check t_in_callback.
+ */
+static void emit_event(EngineStateData& e, const WFEvent& event) {
+    TraceScope trace("event_callback", "engine", "type", (int64_t)event.type);
+    WFEventCallback callback = nullptr;
+    void* user_data = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(e.mutex);
+        callback = (WFEventCallback)e.callback;
+        user_data = e.callback_user_data;
     }
-    
-    // Create new state
-    g_state = new (std::nothrow) EngineStateData();
-    if (!g_state) {
-        return WF_ERROR_OUT_OF_MEMORY;
+    if (callback) {
+        t_in_callback = true;
+        callback(&event, user_data);
+        t_in_callback = false;
     }
-    
-    // Initialize state
-    g_state->state = EngineState::INITIALIZED;
-    g_state->device = config->device;
-    g_state->log_level = config->log_level;
-    g_state->shutdown_requested = false;
-    
-    // Start worker thread
-    g_state->worker_thread = std::thread(worker_thread_func);
-    
-    log_message(2, "Engine initialized");
-    return WF_OK;
 }
 
-WFErrorCode wf_engine_set_callback(WFEventCallback callback, void* user_data) {
-    std::lock_guard<std::mutex> lock(g_engine_mutex);
-    
-    if (!g_state || g_state->state == EngineState::DISPOSED) {
-        return WF_ERROR_DISPOSED;
-    }
-    if (g_state->state == EngineState::UNINITIALIZED) {
-        return WF_ERROR_NOT_INITIALIZED;
+static void emit_model_progress(EngineStateData& e, const char* model_id, int progress) {
+    WFEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = WF_EVENT_MODEL_PROGRESS;
+    event.data.model_progress.model_id = model_id;
+    event.data.model_progress.progress = progress;
+    emit_event(e, event);
+}
+
+static void emit_error(EngineStateData& e, const char* session_id, WFErrorCode code, int recoverable) {
+    WFEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = WF_EVENT_ERROR;
+    event.session_id = session_id;
+    event.data.error.code = code;
+    event.data.error.message = wf_engine_error_message(code);
+    event.data.error.recoverable = recoverable;
+    emit_event(e, event);
+}
+
+#ifdef WISPRFLEX_HAS_WHISPER
+
+/**
+ * Resolve a model ID to a file under the models directory.
+ * Prefers the MODEL_MANAGEMENT_SPEC layout (<dir>/<id>/model.gguf) and
+ * falls back to whisper.cpp's release naming (<dir>/ggml-<id>.bin).
+ */
+static std::string resolve_model_path(const std::string& model_dir, const std::string& model_id) {
+    std::string spec_path = model_dir + "/" + model_id + "/model.gguf";
+    if (FILE* f = fopen(spec_path.c_str(), "rb")) {
+        fclose(f);
+        return spec_path;
     }
+    return model_dir + "/ggml-" + model_id + ".bin";
+}
+
+static void on_backend_partial(const char* text, void* user_data) {
+    SessionStream* stream = static_cast<SessionStream*>(user_data);
     
-    g_state->callback = (void*)callback;
-    g_state->callback_user_data = user_data;
+    WFEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = WF_EVENT_PARTIAL_TRANSCRIPT;
+    event.session_id = stream->id.c_str();
+    event.data.partial_transcript.text = text;
+    event.data.partial_transcript.is_stable = 0;
+    emit_event(*stream->engine, event);
+}
+
+static void on_backend_utterance(const char* text, void* user_data) {
+    SessionStream* stream = static_cast<SessionStream*>(user_data);
     
-    return WF_OK;
+    WFEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = WF_EVENT_FINAL_TRANSCRIPT;
+    event.session_id = stream->id.c_str();
+    event.data.final_transcript.text = text;
+    emit_event(*stream->engine, event);
 }
 
-WFErrorCode wf_engine_load_model(const char* model_id) {
-    std::lock_guard<std::mutex> lock(g_engine_mutex);
+static void on_backend_quality(WBQualityLevel level, float rtf, void* user_data) {
+    SessionStream* stream = static_cast<SessionStream*>(user_data);
     
-    // Validate state
-    if (!g_state || g_state->state == EngineState::DISPOSED) {
-        return WF_ERROR_DISPOSED;
+    WFEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = WF_EVENT_QUALITY_CHANGED;
+    event.session_id = stream->id.c_str();
+    event.data.quality_changed.level = (int)level;
+    event.data.quality_changed.model_id = level == WB_QUALITY_FALLBACK_MODEL ? stream->fallback_model_id.c_str()
+                                                                           : stream->model_id.c_str();
+    event.data.quality_changed.rtf = rtf;
+    emit_event(*stream->engine, event);
+}
+
+#endif
+
+/**
+ * True once a newer load, a cancel or an unload has replaced the load
+ * started as generation
+ */
+static bool load_superseded(const EngineStateData& e, uint64_t generation) {
+    return e.load_generation.load() != generation;
+}
+
+/**
+ * Report a load that was cancelled. Silent when a newer load replaced
+ * it or the engine is shutting down.
+ */
+static void report_load_cancelled(EngineStateData& e) {
+    bool explicit_cancel;
+    {
+        std::lock_guard<std::mutex> lock(e.mutex);
+        explicit_cancel = e.loading_model_id.empty() && !e.shutdown_requested;
     }
-    if (g_state->state == EngineState::UNINITIALIZED) {
-        return WF_ERROR_NOT_INITIALIZED;
+    log_message(e, 2, "Worker: Model load cancelled");
+    if (explicit_cancel) {
+        emit_error(e, nullptr, WF_ERROR_MODEL_LOAD_CANCELLED, 1);
     }
-    if (g_state->state == EngineState::SESSION_ACTIVE) {
-        return WF_ERROR_SESSION_ALREADY_ACTIVE;
+}
+
+#ifdef WISPRFLEX_HAS_WHISPER
+
+/**
+ * Backend load progress -> WF_EVENT_MODEL_PROGRESS (worker thread)
+ */
+struct LoadProgress {
+    EngineStateData* engine;
+    const std::string* model_id;
+    uint64_t generation;
+    int last_percent;
+};
+
+static int on_backend_load_progress(size_t bytes_loaded, size_t total_bytes, void* user_data) {
+    LoadProgress* load = static_cast<LoadProgress*>(user_data);
+    if (load_superseded(*load->engine, load->generation)) {
+        return 0;  // Cancel the read
     }
     
-    // Validate model_id
-    if (!model_id || strlen(model_id) == 0) {
-        return WF_ERROR_MODEL_NOT_FOUND;
+    // 0-99 while reading; 100 once the model is ready to use
+    int percent = total_bytes > 0 ? (int)((uint64_t)bytes_loaded * 99 / total_bytes) : 0;
+    if (percent > load->last_percent) {
+        load->last_percent = percent;
+        emit_model_progress(*load->engine, load->model_id->c_str(), percent);
     }
-    
-    // Check supported models (Phase 2.1: dummy validation)
-    const char* supported[] = {"tiny", "base", "small", "medium"};
-    bool found = false;
-    for (const char* m : supported) {
-        if (strcmp(model_id, m) == 0) {
-            found = true;
-            break;
-        }
+    return 1;
+}
+
+static void release_backend_models(EngineStateData& e) {
+    wb_model_release(e.backend_model);
+    e.backend_model = nullptr;
+    wb_model_release(e.backend_final_model);
+    e.backend_final_model = nullptr;
+    wb_model_release(e.backend_fallback_model);
+    e.backend_fallback_model = nullptr;
+    e.backend_fallback_id.clear();
+}
+
+/**
+ * Load a model that accompanies the load at generation (final or
+ * fallback model). Progress stays at 99 meanwhile; a cancel still stops
+ * it. A failure is reported but sessions go ahead without the model.
+ * @return false if the load was cancelled
+ */
+static bool acquire_companion_model(
+    EngineStateData& e,
+    const std::string& model_dir,
+    const std::string& model_id,
+    uint64_t generation,
+    WBModel** out_model
+) {
+    std::string path = resolve_model_path(model_dir, model_id);
+    LoadProgress progress = {&e, &model_id, generation, 99};
+    WBLoadOptions options = wb_default_load_options();
+    options.warmup = 1;
+    options.model_id = model_id.c_str();
+    options.progress_callback = on_backend_load_progress;
+    options.progress_user_data = &progress;
+    WBErrorCode err = wb_model_acquire_with_options(path.c_str(), &options, out_model);
+    if (err == WB_ERROR_CANCELLED) {
+        return false;
     }
-    if (!found) {
-        return WF_ERROR_MODEL_NOT_FOUND;
+    if (err != WB_OK) {
+        log_message(e, 1, "Worker: Companion model load failed, continuing without it");
+        emit_error(e, nullptr, err == WB_ERROR_OUT_OF_MEMORY ? WF_ERROR_OUT_OF_MEMORY 
+                                                            : WF_ERROR_MODEL_LOAD_FAILED, 1);
     }
-    
-    // Queue load work
-    WorkItem item;
-    item.type = WorkItem::Type::LOAD_MODEL;
-    item.data = model_id;
-    g_state->work_queue.push(std::move(item));
-    g_state->queue_cv.notify_one();
-    
-    // Update state synchronously for Phase 2.1
-    g_state->loaded_model_id = model_id;
-    g_state->state = EngineState::MODEL_LOADED;
-    
-    log_message(2, "Model load requested");
-    return WF_OK;
+    return true;
 }
 
-WFErrorCode wf_engine_unload_model(void) {
-    std::lock_guard<std::mutex> lock(g_engine_mutex);
-    
-    if (!g_state || g_state->state == EngineState::DISPOSED) {
-        return WF_ERROR_DISPOSED;
-    }
-    if (g_state->state == EngineState::SESSION_ACTIVE) {
-        return WF_ERROR_SESSION_ALREADY_ACTIVE;
+#endif
+
+static void handle_load_model(EngineStateData& e, const std::string& model_id, uint64_t generation) {
+    TraceScope trace("handle_load_model", "engine");
+    if (load_superseded(e, generation)) {
+        report_load_cancelled(e);
+        return;
     }
+    emit_model_progress(e, model_id.c_str(), 0);
     
-    if (!g_state->loaded_model_id.empty()) {
-        WorkItem item;
-        item.type = WorkItem::Type::UNLOAD_MODEL;
-        g_state->work_queue.push(std::move(item));
-        g_state->queue_cv.notify_one();
-        
-        g_state->loaded_model_id.clear();
+#ifdef WISPRFLEX_HAS_WHISPER
+    std::string model_dir;
+    std::string final_model_id;
+    std::string fallback_model_id;
+    int final_threads;
+    {
+        std::lock_guard<std::mutex> lock(e.mutex);
+        model_dir = e.model_dir;
+        final_model_id = e.final_model_id != model_id ? e.final_model_id : std::string();
+        fallback_model_id = e.fallback_model_id != model_id ? e.fallback_model_id : std::string();
+        final_threads = e.final_model_threads;
     }
+    std::string path = resolve_model_path(model_dir, model_id);
     
-    if (g_state->state == EngineState::MODEL_LOADED) {
-        g_state->state = EngineState::INITIALIZED;
-    }
+    // Drop the previous models first: with a budget they stay resident
+    // only if there is room, otherwise they can be evicted for the new one
+    release_backend_models(e);
     
-    log_message(2, "Model unloaded");
-    return WF_OK;
-}
-
-WFErrorCode wf_engine_start_session(
-    const WFSessionConfig* config,
-    char* session_id_out,
-    size_t session_id_size
-) {
-    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    // Warm up at load so the first chunk does not pay for buffer allocation
+    LoadProgress progress = {&e, &model_id, generation, 0};
+    WBLoadOptions options = wb_default_load_options();
+    options.warmup = 1;
+    options.model_id = model_id.c_str();
+    options.progress_callback = on_backend_load_progress;
+    options.progress_user_data = &progress;
+    WBErrorCode err = wb_model_acquire_with_options(path.c_str(), &options, &e.backend_model);
+    if (err == WB_ERROR_CANCELLED) {
+        report_load_cancelled(e);
+        return;
+    }
+    if (err != WB_OK) {
+        log_message(e, 0, "Worker: Model load failed");
+        {
+            std::lock_guard<std::mutex> lock(e.mutex);
+            if (!load_superseded(e, generation)) {
+                e.loading_model_id.clear();
+            }
+        }
+        WFErrorCode code = WF_ERROR_MODEL_LOAD_FAILED;
+        if (err == WB_ERROR_MODEL_NOT_FOUND) {
+            code = WF_ERROR_MODEL_NOT_FOUND;
+        } else if (err == WB_ERROR_OUT_OF_MEMORY) {
+            code = WF_ERROR_OUT_OF_MEMORY;
+        }
+        emit_error(e, nullptr, code, 1);
+        return;
+    }
     
-    // Validate state
-    if (!g_state || g_state->state == EngineState::DISPOSED) {
-        return WF_ERROR_DISPOSED;
+    bool loaded = true;
+    if (!final_model_id.empty()) {
+        loaded = acquire_companion_model(e, model_dir, final_model_id, generation, 
+                                         &e.backend_final_model);
+        e.backend_final_threads = final_threads;
     }
-    if (g_state->state == EngineState::UNINITIALIZED) {
-        return WF_ERROR_NOT_INITIALIZED;
+    if (loaded && !fallback_model_id.empty()) {
+        loaded = acquire_companion_model(e, model_dir, fallback_model_id, generation, 
+                                         &e.backend_fallback_model);
+        e.backend_fallback_id = fallback_model_id;
     }
-    if (g_state->loaded_model_id.empty()) {
-        return WF_ERROR_MODEL_NOT_LOADED;
+    if (!loaded) {
+        release_backend_models(e);
+        report_load_cancelled(e);
+        return;
     }
-    if (!g_state->active_session_id.empty()) {
-        return WF_ERROR_SESSION_ALREADY_ACTIVE;
+#else
+    log_message(e, 2, "Worker: Processing LOAD_MODEL (no-op)");
+    for (int step = 1; step <= 10 && !load_superseded(e, generation); step++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
+#endif
     
-    // Validate output buffer
-    if (!session_id_out || session_id_size < 64) {
-        return WF_ERROR_INTERNAL;
+    // Publish only if nothing replaced this load meanwhile
+    {
+        std::lock_guard<std::mutex> lock(e.mutex);
+        if (!load_superseded(e, generation)) {
+            e.loading_model_id.clear();
+            e.loaded_model_id = model_id;
+            if (e.state == EngineState::INITIALIZED) {
+                e.state = EngineState::MODEL_LOADED;
+            }
+            generation = 0;
+        }
+    }
+    if (generation != 0) {
+#ifdef WISPRFLEX_HAS_WHISPER
+        release_backend_models(e);
+#endif
+        report_load_cancelled(e);
+        return;
     }
     
-    // Generate session ID
-    std::string session_id = generate_session_id();
-    
-    // Copy to output
-    strncpy(session_id_out, session_id.c_str(), session_id_size - 1);
-    session_id_out[session_id_size - 1] = '\0';
-    
-    // Update state
-    g_state->active_session_id = session_id;
-    g_state->session_language = config && config->language ? config->language : "auto";
-    g_state->session_vad_enabled = config ? config->vad_enabled : true;
-    g_state->chunk_count = 0;
-    g_state->state = EngineState::SESSION_ACTIVE;
-    
-    log_message(2, "Session started");
-    return WF_OK;
+    emit_model_progress(e, model_id.c_str(), 100);
 }
 
-WFErrorCode wf_engine_push_audio(
-    const char* session_id,
-    const float* pcm_data,
-    size_t sample_count
-) {
-    std::lock_guard<std::mutex> lock(g_engine_mutex);
-    
-    // Validate state
-    if (!g_state || g_state->state == EngineState::DISPOSED) {
-        return WF_ERROR_DISPOSED;
-    }
-    if (g_state->active_session_id.empty()) {
-        return WF_ERROR_SESSION_ENDED;
-    }
-    if (!session_id || g_state->active_session_id != session_id) {
-        return WF_ERROR_INVALID_SESSION;
+static void handle_unload_model(EngineStateData& e) {
+#ifdef WISPRFLEX_HAS_WHISPER
+    release_backend_models(e);
+#else
+    log_message(e, 2, "Worker: Processing UNLOAD_MODEL (no-op)");
+#endif
+}
+
+static void handle_start_session(EngineStateData& e, SessionStream& stream) {
+    TraceScope trace("handle_start_session", "engine");
+#ifdef WISPRFLEX_HAS_WHISPER
+    // Final passes run on a thread of their own, beside the pool, so
+    // their threads leave the pool's share of the budget first
+    int final_threads = 0;
+    if (e.backend_final_model) {
+        final_threads = e.backend_final_threads > 0 ? e.backend_final_threads
+                                                    : g_inference_threads.load();
+        reserve_final_pass_threads(stream, final_threads);
     }
     
-    // Validate audio data
-    if (!pcm_data || sample_count == 0) {
-        return WF_ERROR_AUDIO_STREAM_ERROR;
+    WBSessionConfig config = wb_default_session_config();
+    config.language = stream.language.c_str();
+    config.vad_enabled = stream.vad_enabled ? 1 : 0;
+    config.n_threads = g_inference_threads.load();  // Share of the thread budget
+    config.max_window_ms = MAX_MERGED_WINDOW_MS;    // Merged drains (overload)
+    config.adaptive_window = 1;                     // From 1.5 s up as the RTF requires
+    config.utterance_callback = on_backend_utterance;  // Final per utterance
+    config.final_model = e.backend_final_model;     // Two-tier if set
+    config.final_n_threads = final_threads;
+    config.degrade_rtf = DEGRADE_RTF;               // Keep the transcript live
+    config.fallback_model = e.backend_fallback_model;
+    config.quality_callback = on_backend_quality;
+    {
+        std::lock_guard<std::mutex> lock(e.mutex);
+        stream.model_id = e.loaded_model_id;
     }
-    
-    // Check backpressure (max 10 items in queue)
-    if (g_state->work_queue.size() >= 10) {
-        return WF_ERROR_BACKPRESSURE_LIMIT;
+    stream.fallback_model_id = e.backend_fallback_id;
+    stream.backend_session = wb_start_model_session(e.backend_model, &config, 
+                                                    on_backend_partial, &stream);
+    if (stream.backend_session == 0) {
+        log_message(e, 0, "Worker: Backend session start failed");
+        release_final_pass_threads(stream);
+        emit_error(e, stream.id.c_str(), WF_ERROR_MODEL_NOT_LOADED, 0);
     }
+#else
+    log_message(e, 2, "Worker: Processing START_SESSION (no-op)");
+#endif
     
-    // Queue audio for processing
-    WorkItem item;
-    item.type = WorkItem::Type::PROCESS_AUDIO;
-    item.data = session_id;
-    item.audio.assign(pcm_data, pcm_data + sample_count);
-    g_state->work_queue.push(std::move(item));
-    g_state->queue_cv.notify_one();
-    
-    g_state->chunk_count++;
-    
-    log_message(2, "Audio pushed to queue");
-    return WF_OK;
+    // Audio pushed so far was held in the ring
+    stream.started = true;
+    schedule_drain(stream);
 }
 
-WFErrorCode wf_engine_end_session(const char* session_id) {
-    std::lock_guard<std::mutex> lock(g_engine_mutex);
-    
-    // Validate state
-    if (!g_state || g_state->state == EngineState::DISPOSED) {
-        return WF_ERROR_DISPOSED;
+/**
+ * Hand drained audio to the backend session (drain_mutex held).
+ * whisper_backend owns windowing, so blocks are forwarded as drained;
+ * queue_wait_ms (age of the oldest sample) feeds its stage timings.
+ */
+static void process_session_audio(SessionStream& stream, const float* pcm, size_t n, double queue_wait_ms) {
+#ifdef WISPRFLEX_HAS_WHISPER
+    if (stream.backend_session == 0) {
+        return;  // Backend session failed to start; audio is discarded
     }
-    if (g_state->active_session_id.empty()) {
-        return WF_ERROR_SESSION_ENDED;
+    if (wb_process_chunk_queued(stream.backend_session, pcm, n, queue_wait_ms) != WB_OK) {
+        emit_error(*stream.engine, stream.id.c_str(), WF_ERROR_INTERNAL, 1);
     }
-    if (!session_id || g_state->active_session_id != session_id) {
-        return WF_ERROR_INVALID_SESSION;
+#else
+    (void)pcm;
+    (void)n;
+    (void)queue_wait_ms;
+    log_message(*stream.engine, 2, "Worker: Processing session audio (no-op)");
+#endif
+}
+
+/**
+ * Drain buffered audio from the ring into the backend (drain_mutex held)
+ */
+static void drain_session_audio(SessionStream& stream, std::vector<float>& scratch) {
+    while (stream.ring.size() > 0) {
+        size_t n = stream.ring.read(scratch.data(), scratch.size());
+        if (n == 0) break;
+        process_session_audio(stream, scratch.data(), n, 0.0);
     }
-    
-    // Queue end session
-    WorkItem item;
-    item.type = WorkItem::Type::END_SESSION;
-    item.data = session_id;
-    g_state->work_queue.push(std::move(item));
-    g_state->queue_cv.notify_one();
-    
-    // Clear session state
-    g_state->active_session_id.clear();
-    g_state->chunk_count = 0;
-    g_state->state = EngineState::MODEL_LOADED;
-    
-    log_message(2, "Session ended");
-    return WF_OK;
 }
 
-WFErrorCode wf_engine_dispose(void) {
-    std::unique_lock<std::mutex> lock(g_engine_mutex);
+static void handle_end_session(EngineStateData& e, SessionStream& stream, std::vector<float>& scratch) {
+    TraceScope trace("handle_end_session", "engine");
+    // Waits for a running drain task; later ones see finished
+    std::lock_guard<std::mutex> lock(stream.drain_mutex);
+    stream.finished = true;
     
-    if (!g_state) {
-        return WF_OK;  // Already disposed, idempotent
-    }
+    // Flush audio pushed before end_session closed the stream
+    drain_session_audio(stream, scratch);
     
-    if (g_state->state == EngineState::DISPOSED) {
-        return WF_OK;
+#ifdef WISPRFLEX_HAS_WHISPER
+    if (stream.backend_session == 0) {
+        return;
     }
     
-    // Signal shutdown
-    g_state->shutdown_requested = true;
-    
-    // Queue shutdown work item
-    WorkItem item;
-    item.type = WorkItem::Type::SHUTDOWN;
-    g_state->work_queue.push(std::move(item));
-    g_state->queue_cv.notify_one();
-    
-    // Release lock before joining thread
-    std::thread worker = std::move(g_state->worker_thread);
-    lock.unlock();
-    
-    // Wait for worker thread
-    if (worker.joinable()) {
-        worker.join();
+    std::vector<char> final_text(16384, '\0');
+    WBErrorCode err = wb_finalize_session(stream.backend_session, 
+                                          final_text.data(), final_text.size());
+    stream.backend_session = 0;
+    if (err != WB_OK) {
+        emit_error(e, stream.id.c_str(), WF_ERROR_INTERNAL, 0);
+        return;
     }
     
-    // Clean up state
-    lock.lock();
-    g_state->state = EngineState::DISPOSED;
-    delete g_state;
-    g_state = nullptr;
-    
-    log_message(2, "Engine disposed");
-    return WF_OK;
+    WFEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = WF_EVENT_FINAL_TRANSCRIPT;
+    event.session_id = stream.id.c_str();
+    event.data.final_transcript.text = final_text.data();
+    emit_event(e, event);
+#else
+    log_message(e, 2, "Worker: Processing END_SESSION (no-op)");
+#endif
 }
 
-/* ============================================
- * Utility Functions
- * ============================================ */
-
-int wf_engine_is_initialized(void) {
-    std::lock_guard<std::mutex> lock(g_engine_mutex);
-    return g_state && g_state->state != EngineState::UNINITIALIZED 
-                   && g_state->state != EngineState::DISPOSED;
+/**
+ * Release the engine's backend resources (worker thread, on shutdown).
+ * A session still open when the engine is destroyed is aborted.
+ */
+static void handle_shutdown(EngineStateData& e, SessionStream* stream) {
+    log_message(e, 2, "Worker: Shutdown requested");
+    
+    if (stream) {
+        // Pool tasks must be done with the stream before the engine goes
+        std::lock_guard<std::mutex> lock(stream->drain_mutex);
+        stream->finished = true;
+#ifdef WISPRFLEX_HAS_WHISPER
+        if (stream->backend_session != 0) {
+            wb_abort_session(stream->backend_session);
+            stream->backend_session = 0;
+        }
+#endif
+    }
+    
+#ifdef WISPRFLEX_HAS_WHISPER
+    release_backend_models(e);
+#endif
 }
 
-const char* wf_engine_get_loaded_model(void) {
-    std::lock_guard<std::mutex> lock(g_engine_mutex);
-    if (g_state && !g_state->loaded_model_id.empty()) {
-        return g_state->loaded_model_id.c_str();
+static void worker_thread_func(EngineStateData* engine) {
+    EngineStateData& e = *engine;
+    trace_set_thread_name("engine worker");
+    log_message(e, 2, "Worker thread started");
+    
+    // Read buffer for the final flush of ended sessions
+    std::vector<float> scratch(DRAIN_BATCH_SAMPLES);
+    
+    while (true) {
+        WorkItem item;
+        
+        // Wait for work; audio is drained on the inference pool
+        {
+            std::unique_lock<std::mutex> lock(e.mutex);
+            e.queue_cv.wait(lock, [&] {
+                return e.shutdown_requested || !e.work_queue.empty();
+            });
+            
+            if (e.shutdown_requested && e.work_queue.empty()) {
+                break;
+            }
+            
+            item = std::move(e.work_queue.front());
+            e.work_queue.pop();
+        }
+        
+        // Resize deferred by a callback, which cannot join the pool
+        apply_pending_thread_budget();
+        
+        switch (item.type) {
+            case WorkItem::Type::LOAD_MODEL:
+                handle_load_model(e, item.data, item.generation);
+                break;
+                
+            case WorkItem::Type::UNLOAD_MODEL:
+                handle_unload_model(e);
+                break;
+                
+            case WorkItem::Type::START_SESSION:
+                handle_start_session(e, *item.stream);
+                break;
+                
+            case WorkItem::Type::END_SESSION:
+                handle_end_session(e, *item.stream, scratch);
+                release_final_pass_threads(*item.stream);
+                break;
+                
+            case WorkItem::Type::SHUTDOWN:
+                handle_shutdown(e, item.stream.get());
+                if (item.stream) {
+                    release_final_pass_threads(*item.stream);
+                }
+                return;
+        }
+    }
+    
+    log_message(e, 2, "Worker thread stopped");
+}
+
+/* ============================================
+ * Inference Pool
+ * ============================================ */
+
+/**
+ * Account for n drained samples: retire the marks of chunks now fully
+ * drained (drain_mutex held)
+ * @return number of chunks retired
+ */
+static int retire_chunk_marks(SessionStream& stream, size_t n) {
+    stream.drained_samples += n;
+    
+    int retired = 0;
+    const ChunkMark* mark;
+    while ((mark = stream.marks.front()) && mark->end_sample <= stream.drained_samples) {
+        if (mark->trace_flow != 0) {
+            trace_flow_end("chunk", mark->trace_flow);
+        }
+        stream.marks.pop();
+        retired++;
+    }
+    return retired;
+}
+
+/**
+ * Report drops and merges as WF_EVENT_BACKPRESSURE_WARNING, at most
+ * once per interval and only when a count changed (drain_mutex held)
+ */
+static void report_backpressure(SessionStream& stream, int64_t now_us, int64_t lag_us) {
+    int dropped = stream.rejected_pushes.load(std::memory_order_relaxed);
+    if (dropped == stream.reported_drops && stream.merged_chunks == stream.reported_merges) {
+        return;
+    }
+    if (now_us - stream.last_warning_us < BACKPRESSURE_WARNING_INTERVAL_US) {
+        return;
+    }
+    stream.reported_drops = dropped;
+    stream.reported_merges = stream.merged_chunks;
+    stream.last_warning_us = now_us;
+    
+    WFEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = WF_EVENT_BACKPRESSURE_WARNING;
+    event.session_id = stream.id.c_str();
+    event.data.backpressure_warning.dropped_chunks = dropped;
+    event.data.backpressure_warning.merged_chunks = stream.merged_chunks;
+    event.data.backpressure_warning.lag_ms = (int)(lag_us / 1000);
+    emit_event(*stream.engine, event);
+}
+
+/**
+ * One batch of a stream's audio (inference pool thread).
+ * On time: up to DRAIN_BATCH_SAMPLES. Past the deadline of the oldest
+ * queued chunk: everything buffered, up to MAX_MERGED_SAMPLES, so the
+ * backend catches up with fewer, larger windows instead of the ring
+ * filling and pushes being dropped.
+ */
+static void run_drain_task(const std::shared_ptr<SessionStream>& stream) {
+    static thread_local std::vector<float> scratch(MAX_MERGED_SAMPLES);
+    TraceScope trace("drain", "engine");
+    
+    bool finished;
+    {
+        std::lock_guard<std::mutex> lock(stream->drain_mutex);
+        finished = stream->finished;
+        if (!finished) {
+            int64_t now_us = steady_now_us();
+            const ChunkMark* oldest = stream->marks.front();
+            bool late = oldest && now_us >= oldest->deadline_us;
+            int64_t lag_us = oldest ? now_us - oldest->pushed_us : 0;
+            
+            size_t n = stream->ring.read(scratch.data(), late ? MAX_MERGED_SAMPLES 
+                                                              : DRAIN_BATCH_SAMPLES);
+            if (n > 0) {
+                int retired = retire_chunk_marks(*stream, n);
+                if (late) {
+                    stream->merged_chunks += retired;
+                }
+                process_session_audio(*stream, scratch.data(), n, lag_us / 1000.0);
+            }
+            report_backpressure(*stream, now_us, lag_us);
+        }
+    }
+    
+    stream->drain_scheduled.store(false);
+    if (!finished) {
+        // Requeue for the rest, or for audio pushed while the flag was set
+        schedule_drain(*stream);
+    }
+}
+
+/**
+ * Queue a drain task for a stream with buffered audio, unless one is
+ * already queued or running (any thread). Pushers and the task itself
+ * both call this after changing what it checks, so audio is never left
+ * in the ring without a task.
+ */
+static void schedule_drain(SessionStream& stream) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!stream.started.load() || stream.ring.size() == 0) {
+        return;
+    }
+    if (stream.drain_scheduled.exchange(true)) {
+        return;
+    }
+    std::shared_ptr<SessionStream> pinned = stream.shared_from_this();
+    g_inference_pool.submit([pinned] { run_drain_task(pinned); });
+}
+
+/**
+ * Split the thread budget into pool workers x threads per inference
+ * (g_budget_mutex held)
+ */
+static void resolve_thread_budget(int* workers, int* threads) {
+    int budget = g_thread_budget;
+    if (budget <= 0) {
+        budget = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    int count = g_requested_workers > 0 ? std::min(g_requested_workers, budget)
+                                        : std::max(1, budget / THREADS_PER_INFERENCE);
+    
+    // Two-tier final passes count against the budget too
+    budget = std::max(1, budget - g_final_pass_threads);
+    count = std::min(count, budget);
+    *workers = count;
+    *threads = std::max(1, budget / count);
+}
+
+/**
+ * Re-split the budget after it changed; resizes a running pool
+ * (g_pool_mutex held, never on a pool thread or in a callback)
+ */
+static void apply_thread_budget() {
+    g_pool_resize_pending = false;
+    int count, threads;
+    {
+        std::lock_guard<std::mutex> lock(g_budget_mutex);
+        resolve_thread_budget(&count, &threads);
+        g_inference_threads = threads;
+    }
+    if (g_pool_users > 0 && count != g_inference_pool.workers()) {
+        g_inference_pool.start(count);  // Keeps queued drains
+    }
+}
+
+#ifdef WISPRFLEX_HAS_WHISPER
+/**
+ * Hold threads for a two-tier session's final passes (engine worker, no
+ * drain_mutex held: a resize waits for running drains)
+ */
+static void reserve_final_pass_threads(SessionStream& stream, int threads) {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    {
+        std::lock_guard<std::mutex> budget_lock(g_budget_mutex);
+        g_final_pass_threads += threads;
+    }
+    stream.final_pass_threads = threads;
+    apply_thread_budget();
+}
+#endif
+
+/**
+ * Return a session's final-pass threads once its final passes are joined
+ * (engine worker, no drain_mutex held)
+ */
+static void release_final_pass_threads(SessionStream& stream) {
+    if (stream.final_pass_threads == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    {
+        std::lock_guard<std::mutex> budget_lock(g_budget_mutex);
+        g_final_pass_threads -= stream.final_pass_threads;
+    }
+    stream.final_pass_threads = 0;
+    apply_thread_budget();
+}
+
+/**
+ * Apply a worker count stored by wf_engine_set_thread_budget from a
+ * callback (engine worker, between requests)
+ */
+static void apply_pending_thread_budget() {
+    if (!g_pool_resize_pending.load()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    apply_thread_budget();
+}
+
+static void acquire_inference_pool() {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    g_pool_users++;
+    apply_thread_budget();  // Starts the pool for the first engine
+}
+
+static void release_inference_pool() {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    if (--g_pool_users == 0) {
+        g_inference_pool.stop();
+    }
+}
+
+/* ============================================
+ * Multi-Instance API Implementation
+ * ============================================ */
+
+static bool acquire_backend() {
+#ifdef WISPRFLEX_HAS_WHISPER
+    std::lock_guard<std::mutex> lock(g_backend_mutex);
+    if (g_backend_users == 0 && wb_init() != WB_OK) {
+        return false;
+    }
+    g_backend_users++;
+#endif
+    return true;
+}
+
+static void release_backend() {
+#ifdef WISPRFLEX_HAS_WHISPER
+    std::lock_guard<std::mutex> lock(g_backend_mutex);
+    if (--g_backend_users == 0) {
+        wb_shutdown();
+    }
+#endif
+}
+
+WFErrorCode wf_engine_create(const WFEngineConfig* config, WFEngine** engine_out) {
+    // Pool threads may not wait for the pool mutex (see g_pool_mutex)
+    if (t_in_callback) {
+        return WF_ERROR_NOT_ALLOWED_IN_CALLBACK;
+    }
+    
+    // Validate config
+    if (!config || !engine_out) {
+        return WF_ERROR_INIT_FAILED;
+    }
+    
+    // Phase 2.1: Only CPU supported
+    if (config->device != WF_DEVICE_CPU) {
+        return WF_ERROR_DEVICE_NOT_SUPPORTED;
+    }
+    
+    // Create new state
+    WFEngine* engine = new (std::nothrow) WFEngine();
+    if (!engine) {
+        return WF_ERROR_OUT_OF_MEMORY;
+    }
+    
+    // Initialize state
+    EngineStateData& e = engine->state;
+    e.state = EngineState::INITIALIZED;
+    e.device = config->device;
+    e.log_level = config->log_level;
+    e.model_dir = config->model_dir ? config->model_dir : "models";
+    e.shutdown_requested = false;
+    
+    if (!acquire_backend()) {
+        delete engine;
+        return WF_ERROR_INIT_FAILED;
+    }
+    acquire_inference_pool();
+    
+    // Start worker thread
+    e.worker_thread = std::thread(worker_thread_func, &e);
+    
+    log_message(e, 2, "Engine initialized");
+    *engine_out = engine;
+    return WF_OK;
+}
+
+WFErrorCode wf_engine_destroy(WFEngine* engine) {
+    if (!engine) {
+        return WF_OK;
+    }
+    
+    // The callback's thread would join itself (engine worker), or the
+    // worker would wait for the drain_mutex held by the callback's drain
+    if (t_in_callback) {
+        return WF_ERROR_NOT_ALLOWED_IN_CALLBACK;
+    }
+    
+    EngineStateData& e = engine->state;
+    std::unique_lock<std::mutex> lock(e.mutex);
+    
+    // Stop accepting audio
+    std::shared_ptr<SessionStream> stream = std::move(e.session_stream);
+    if (stream) {
+        close_session_stream(*stream);
+    }
+    e.active_session_id.clear();
+    
+    // Signal shutdown; a model load in progress stops at its next read
+    e.shutdown_requested = true;
+    e.load_generation++;
+    
+    // Queue shutdown work item (worker aborts the open session)
+    WorkItem item;
+    item.type = WorkItem::Type::SHUTDOWN;
+    item.stream = stream;
+    e.work_queue.push(std::move(item));
+    e.queue_cv.notify_one();
+    
+    // Release lock before joining thread
+    std::thread worker = std::move(e.worker_thread);
+    lock.unlock();
+    
+    // Wait for worker thread
+    if (worker.joinable()) {
+        worker.join();
+    }
+    
+    release_inference_pool();
+    release_backend();
+    
+    // Clean up state
+    lock.lock();
+    e.state = EngineState::DISPOSED;
+    lock.unlock();
+    
+    log_message(e, 2, "Engine disposed");
+    delete engine;
+    return WF_OK;
+}
+
+WFErrorCode wf_engine_instance_set_callback(
+    WFEngine* engine,
+    WFEventCallback callback,
+    void* user_data
+) {
+    if (!engine) {
+        return WF_ERROR_NOT_INITIALIZED;
+    }
+    
+    EngineStateData& e = engine->state;
+    std::lock_guard<std::mutex> lock(e.mutex);
+    
+    e.callback = (void*)callback;
+    e.callback_user_data = user_data;
+    
+    return WF_OK;
+}
+
+/**
+ * Check supported models (Phase 2.1: dummy validation)
+ */
+static bool is_supported_model(const char* model_id) {
+    const char* supported[] = {"tiny", "base", "small", "medium"};
+    for (const char* m : supported) {
+        if (strcmp(model_id, m) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+WFErrorCode wf_engine_instance_load_model(WFEngine* engine, const char* model_id) {
+    if (!engine) {
+        return WF_ERROR_NOT_INITIALIZED;
+    }
+    
+    EngineStateData& e = engine->state;
+    std::lock_guard<std::mutex> lock(e.mutex);
+    
+    // Validate state
+    if (e.state == EngineState::SESSION_ACTIVE) {
+        return WF_ERROR_SESSION_ALREADY_ACTIVE;
+    }
+    
+    // Validate model_id
+    if (!model_id || strlen(model_id) == 0) {
+        return WF_ERROR_MODEL_NOT_FOUND;
+    }
+    
+    if (!is_supported_model(model_id)) {
+        return WF_ERROR_MODEL_NOT_FOUND;
+    }
+    
+    // Queue load work; a newer request supersedes (cancels) older ones
+    WorkItem item;
+    item.type = WorkItem::Type::LOAD_MODEL;
+    item.data = model_id;
+    item.generation = ++e.load_generation;
+    e.work_queue.push(std::move(item));
+    e.queue_cv.notify_one();
+    
+    // The worker releases the previous model and sets MODEL_LOADED once
+    // this one is ready
+    e.loading_model_id = model_id;
+    e.loaded_model_id.clear();
+    if (e.state == EngineState::MODEL_LOADED) {
+        e.state = EngineState::INITIALIZED;
+    }
+    
+    log_message(e, 2, "Model load requested");
+    return WF_OK;
+}
+
+WFErrorCode wf_engine_instance_unload_model(WFEngine* engine) {
+    if (!engine) {
+        return WF_ERROR_NOT_INITIALIZED;
+    }
+    
+    EngineStateData& e = engine->state;
+    std::lock_guard<std::mutex> lock(e.mutex);
+    
+    if (e.state == EngineState::SESSION_ACTIVE) {
+        return WF_ERROR_SESSION_ALREADY_ACTIVE;
+    }
+    
+    if (!e.loaded_model_id.empty() || !e.loading_model_id.empty()) {
+        // Also stops a load in progress
+        e.load_generation++;
+        
+        WorkItem item;
+        item.type = WorkItem::Type::UNLOAD_MODEL;
+        e.work_queue.push(std::move(item));
+        e.queue_cv.notify_one();
+        
+        e.loaded_model_id.clear();
+        e.loading_model_id.clear();
+    }
+    
+    if (e.state == EngineState::MODEL_LOADED) {
+        e.state = EngineState::INITIALIZED;
+    }
+    
+    log_message(e, 2, "Model unloaded");
+    return WF_OK;
+}
+
+WFErrorCode wf_engine_instance_cancel_model_load(WFEngine* engine) {
+    if (!engine) {
+        return WF_ERROR_NOT_INITIALIZED;
+    }
+    
+    EngineStateData& e = engine->state;
+    std::lock_guard<std::mutex> lock(e.mutex);
+    
+    if (!e.loading_model_id.empty()) {
+        // The worker notices at its next read and reports the cancel
+        e.load_generation++;
+        e.loading_model_id.clear();
+        log_message(e, 2, "Model load cancel requested");
+    }
+    return WF_OK;
+}
+
+WFErrorCode wf_engine_instance_set_fallback_model(WFEngine* engine, const char* model_id) {
+    if (!engine) {
+        return WF_ERROR_NOT_INITIALIZED;
+    }
+    
+    bool enable = model_id && strlen(model_id) > 0;
+    if (enable && !is_supported_model(model_id)) {
+        return WF_ERROR_MODEL_NOT_FOUND;
+    }
+    
+    // Picked up by the next load
+    EngineStateData& e = engine->state;
+    std::lock_guard<std::mutex> lock(e.mutex);
+    e.fallback_model_id = enable ? model_id : "";
+    return WF_OK;
+}
+
+WFErrorCode wf_engine_instance_set_final_model(WFEngine* engine, const char* model_id, int n_threads) {
+    if (!engine) {
+        return WF_ERROR_NOT_INITIALIZED;
+    }
+    
+    bool enable = model_id && strlen(model_id) > 0;
+    if (enable && !is_supported_model(model_id)) {
+        return WF_ERROR_MODEL_NOT_FOUND;
+    }
+    
+    // Picked up by the next load
+    EngineStateData& e = engine->state;
+    std::lock_guard<std::mutex> lock(e.mutex);
+    e.final_model_id = enable ? model_id : "";
+    e.final_model_threads = std::max(0, n_threads);
+    return WF_OK;
+}
+
+const char* wf_engine_instance_get_loaded_model(WFEngine* engine) {
+    if (!engine) {
+        return nullptr;
+    }
+    
+    EngineStateData& e = engine->state;
+    std::lock_guard<std::mutex> lock(e.mutex);
+    if (!e.loaded_model_id.empty()) {
+        return e.loaded_model_id.c_str();
     }
     return nullptr;
 }
 
+WFErrorCode wf_session_start(
+    WFEngine* engine,
+    const WFSessionConfig* config,
+    WFSession** session_out
+) {
+    if (!engine) {
+        return WF_ERROR_NOT_INITIALIZED;
+    }
+    if (!session_out) {
+        return WF_ERROR_INTERNAL;
+    }
+    
+    EngineStateData& e = engine->state;
+    std::lock_guard<std::mutex> lock(e.mutex);
+    
+    // Validate state (a session may start while its model is loading)
+    if (e.loaded_model_id.empty() && e.loading_model_id.empty()) {
+        return WF_ERROR_MODEL_NOT_LOADED;
+    }
+    if (!e.active_session_id.empty()) {
+        return WF_ERROR_SESSION_ALREADY_ACTIVE;
+    }
+    
+    // Generate session ID
+    std::string session_id = generate_session_id();
+    
+    // Preallocate the session's audio ring (the push path never allocates)
+    auto stream = std::make_shared<SessionStream>(session_id, &e);
+    if (!stream->ring.valid()) {
+        return WF_ERROR_OUT_OF_MEMORY;
+    }
+    stream->language = config && config->language ? config->language : "auto";
+    stream->vad_enabled = config ? config->vad_enabled != 0 : true;
+    
+    WFSession* session = new (std::nothrow) WFSession{engine, stream};
+    if (!session) {
+        return WF_ERROR_OUT_OF_MEMORY;
+    }
+    
+    // Update state
+    e.active_session_id = session_id;
+    e.session_vad_enabled = stream->vad_enabled;
+    e.session_stream = stream;
+    e.state = EngineState::SESSION_ACTIVE;
+    
+    // Backend session starts on the worker, after any pending model load
+    WorkItem item;
+    item.type = WorkItem::Type::START_SESSION;
+    item.data = session_id;
+    item.stream = stream;
+    e.work_queue.push(std::move(item));
+    e.queue_cv.notify_one();
+    
+    log_message(e, 2, "Session started");
+    *session_out = session;
+    return WF_OK;
+}
+
+WFErrorCode wf_session_push_audio(
+    WFSession* session,
+    const float* pcm_data,
+    size_t sample_count
+) {
+    if (!session) {
+        return WF_ERROR_INVALID_SESSION;
+    }
+    return push_to_stream(*session->stream, pcm_data, sample_count);
+}
+
+WFErrorCode wf_session_set_target_latency(WFSession* session, int target_latency_ms) {
+    if (!session) {
+        return WF_ERROR_INVALID_SESSION;
+    }
+    session->stream->target_latency_ms = target_latency_ms > 0 ? target_latency_ms 
+                                                               : DEFAULT_TARGET_LATENCY_MS;
+    return WF_OK;
+}
+
+WFErrorCode wf_session_end(WFSession* session) {
+    if (!session) {
+        return WF_ERROR_INVALID_SESSION;
+    }
+    
+    // A closed stream may belong to a destroyed engine; don't touch it
+    if (session->stream->closed.load()) {
+        return WF_ERROR_SESSION_ENDED;
+    }
+    
+    EngineStateData& e = session->engine->state;
+    std::lock_guard<std::mutex> lock(e.mutex);
+    
+    if (e.session_stream != session->stream) {
+        return WF_ERROR_SESSION_ENDED;
+    }
+    
+    // Queue end session (worker flushes the closed stream first)
+    close_session_stream(*session->stream);
+    e.session_stream.reset();
+    
+    WorkItem item;
+    item.type = WorkItem::Type::END_SESSION;
+    item.data = session->stream->id;
+    item.stream = session->stream;
+    e.work_queue.push(std::move(item));
+    e.queue_cv.notify_one();
+    
+    // Clear session state
+    e.active_session_id.clear();
+    e.state = EngineState::MODEL_LOADED;
+    
+    log_message(e, 2, "Session ended");
+    return WF_OK;
+}
+
+const char* wf_session_get_id(const WFSession* session) {
+    return session ? session->stream->id.c_str() : nullptr;
+}
+
+void wf_session_release(WFSession* session) {
+    if (!session) {
+        return;
+    }
+    wf_session_end(session);
+    delete session;
+}
+
+/* ============================================
+ * Engine Lifecycle API Implementation
+ * ============================================ */
+
+WFErrorCode wf_engine_init(const WFEngineConfig* config) {
+    if (t_in_callback) {
+        return WF_ERROR_NOT_ALLOWED_IN_CALLBACK;
+    }
+    
+    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    
+    // Check if already initialized
+    if (g_default_engine) {
+        return WF_ERROR_ALREADY_INITIALIZED;
+    }
+    
+    return wf_engine_create(config, &g_default_engine);
+}
+
+WFErrorCode wf_engine_set_callback(WFEventCallback callback, void* user_data) {
+    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    
+    if (!g_default_engine) {
+        return WF_ERROR_DISPOSED;
+    }
+    
+    return wf_engine_instance_set_callback(g_default_engine, callback, user_data);
+}
+
+WFErrorCode wf_engine_load_model(const char* model_id) {
+    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    
+    if (!g_default_engine) {
+        return WF_ERROR_DISPOSED;
+    }
+    
+    return wf_engine_instance_load_model(g_default_engine, model_id);
+}
+
+WFErrorCode wf_engine_unload_model(void) {
+    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    
+    if (!g_default_engine) {
+        return WF_ERROR_DISPOSED;
+    }
+    
+    return wf_engine_instance_unload_model(g_default_engine);
+}
+
+WFErrorCode wf_engine_cancel_model_load(void) {
+    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    
+    if (!g_default_engine) {
+        return WF_ERROR_DISPOSED;
+    }
+    
+    return wf_engine_instance_cancel_model_load(g_default_engine);
+}
+
+WFErrorCode wf_engine_set_final_model(const char* model_id, int n_threads) {
+    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    
+    if (!g_default_engine) {
+        return WF_ERROR_DISPOSED;
+    }
+    
+    return wf_engine_instance_set_final_model(g_default_engine, model_id, n_threads);
+}
+
+WFErrorCode wf_engine_set_fallback_model(const char* model_id) {
+    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    
+    if (!g_default_engine) {
+        return WF_ERROR_DISPOSED;
+    }
+    
+    return wf_engine_instance_set_fallback_model(g_default_engine, model_id);
+}
+
+WFErrorCode wf_engine_set_model_budget(size_t budget_bytes) {
+#ifdef WISPRFLEX_HAS_WHISPER
+    wb_set_model_budget(budget_bytes);
+#else
+    (void)budget_bytes;
+#endif
+    return WF_OK;
+}
+
+WFErrorCode wf_engine_set_thread_budget(int total_threads, int workers) {
+    {
+        std::lock_guard<std::mutex> lock(g_budget_mutex);
+        g_thread_budget = std::max(0, total_threads);
+        g_requested_workers = std::max(0, workers);
+    }
+    
+    // A resize joins pool threads, and may wait for the drain that is
+    // delivering this callback; the next engine request does it instead
+    if (t_in_callback || g_inference_pool.on_worker_thread()) {
+        g_pool_resize_pending = true;
+        return WF_OK;
+    }
+    
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    apply_thread_budget();
+    return WF_OK;
+}
+
+WFErrorCode wf_engine_get_thread_budget(int* workers_out, int* threads_per_worker_out) {
+    std::lock_guard<std::mutex> lock(g_budget_mutex);
+    int count, threads;
+    resolve_thread_budget(&count, &threads);
+    if (workers_out) {
+        *workers_out = count;
+    }
+    if (threads_per_worker_out) {
+        *threads_per_worker_out = threads;
+    }
+    return WF_OK;
+}
+
+WFErrorCode wf_engine_start_session(
+    const WFSessionConfig* config,
+    char* session_id_out,
+    size_t session_id_size
+) {
+    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    
+    if (!g_default_engine) {
+        return WF_ERROR_DISPOSED;
+    }
+    
+    // Validate output buffer
+    if (!session_id_out || session_id_size < 64) {
+        return WF_ERROR_INTERNAL;
+    }
+    
+    WFSession* session = nullptr;
+    WFErrorCode result = wf_session_start(g_default_engine, config, &session);
+    if (result != WF_OK) {
+        return result;
+    }
+    
+    // Copy to output
+    strncpy(session_id_out, wf_session_get_id(session), session_id_size - 1);
+    session_id_out[session_id_size - 1] = '\0';
+    
+    g_default_session = session;
+    g_active_stream.store(session->stream.get());
+    
+    return WF_OK;
+}
+
+/**
+ * Detach the default session from the lock-free push path.
+ * Caller holds g_engine_mutex. On return no pusher references it.
+ */
+static WFSession* detach_default_session() {
+    g_active_stream.store(nullptr);
+    while (g_push_refs.load() != 0) {
+        std::this_thread::yield();
+    }
+    WFSession* session = g_default_session;
+    g_default_session = nullptr;
+    return session;
+}
+
+/**
+ * Error for a push that found no active stream (slow path, takes the lock)
+ */
+static WFErrorCode push_audio_error() {
+    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    if (!g_default_engine) {
+        return WF_ERROR_DISPOSED;
+    }
+    return WF_ERROR_SESSION_ENDED;
+}
+
+WFErrorCode wf_engine_push_audio(
+    const char* session_id,
+    const float* pcm_data,
+    size_t sample_count
+) {
+    // Pin the active stream. Never takes g_engine_mutex while pinned,
+    // detach_default_session() spins on g_push_refs under that lock.
+    g_push_refs.fetch_add(1);
+    SessionStream* stream = g_active_stream.load();
+    
+    if (!stream) {
+        g_push_refs.fetch_sub(1);
+        return push_audio_error();
+    }
+    
+    WFErrorCode result;
+    if (!session_id || stream->id != session_id) {
+        result = WF_ERROR_INVALID_SESSION;
+    } else {
+        result = push_to_stream(*stream, pcm_data, sample_count);
+    }
+    
+    g_push_refs.fetch_sub(1);
+    return result;
+}
+
+WFErrorCode wf_engine_end_session(const char* session_id) {
+    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    
+    // Validate state
+    if (!g_default_engine) {
+        return WF_ERROR_DISPOSED;
+    }
+    if (!g_default_session) {
+        return WF_ERROR_SESSION_ENDED;
+    }
+    if (!session_id || g_default_session->stream->id != session_id) {
+        return WF_ERROR_INVALID_SESSION;
+    }
+    
+    WFSession* session = detach_default_session();
+    WFErrorCode result = wf_session_end(session);
+    wf_session_release(session);
+    return result;
+}
+
+WFErrorCode wf_engine_dispose(void) {
+    if (t_in_callback) {
+        return WF_ERROR_NOT_ALLOWED_IN_CALLBACK;  // See wf_engine_destroy
+    }
+    
+    WFEngine* engine = nullptr;
+    WFSession* session = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(g_engine_mutex);
+        
+        if (!g_default_engine) {
+            return WF_OK;  // Already disposed, idempotent
+        }
+        
+        // Stop accepting audio
+        session = detach_default_session();
+        engine = g_default_engine;
+        g_default_engine = nullptr;
+    }
+    
+    // Joins the worker, whose callbacks may call back into this API,
+    // so g_engine_mutex is not held. The open session is aborted.
+    WFErrorCode result = wf_engine_destroy(engine);
+    wf_session_release(session);
+    return result;
+}
+
+/* ============================================
+ * Utility Functions
+ * ============================================ */
+
+int wf_engine_is_initialized(void) {
+    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    return g_default_engine != nullptr;
+}
+
+const char* wf_engine_get_loaded_model(void) {
+    std::lock_guard<std::mutex> lock(g_engine_mutex);
+    return wf_engine_instance_get_loaded_model(g_default_engine);
+}
+
 const char* wf_engine_get_active_session(void) {
     std::lock_guard<std::mutex> lock(g_engine_mutex);
-    if (g_state && !g_state->active_session_id.empty()) {
-        return g_state->active_session_id.c_str();
+    if (g_default_session) {
+        return wf_session_get_id(g_default_session);
     }
     return nullptr;
 }
+
+/* ============================================
+ * Tracing API Implementation
+ * ============================================ */
+
+WFErrorCode wf_engine_trace_start(size_t max_events_per_thread) {
+    trace_start(max_events_per_thread);
+    return WF_OK;
+}
+
+WFErrorCode wf_engine_trace_stop(const char* output_path) {
+    trace_stop();
+    if (output_path && !trace_write_json(output_path)) {
+        return WF_ERROR_INTERNAL;
+    }
+    return WF_OK;
+}
@@ -2,6 +2,10 @@
  * WisprFlex Native Engine - Internal State Definitions
  * 
  * Internal header - not part of public API.
+ * 
+ * Every WFEngine handle owns one EngineStateData: its own mutex, work
+ * queue and worker thread for control work. Session audio is
+ * transcribed on the inference pool shared by all engines.
  */
 
 #ifndef WISPRFLEX_ENGINE_STATE_H
@@ -9,11 +13,36 @@
 
 #include <mutex>
 #include <atomic>
+#include <cstdint>
 #include <thread>
 #include <queue>
 #include <condition_variable>
 #include <string>
 #include <functional>
+#include <memory>
+#include <vector>
+
+#include "../include/wisprflex_engine.h"
+#include "audio_ring_buffer.h"
+
+struct WBModel;  // whisper_backend model handle (WISPRFLEX_HAS_WHISPER)
+
+/**
+ * Audio buffered per session before push_audio reports backpressure
+ * (30 s @ 16kHz mono)
+ */
+static const size_t SESSION_AUDIO_CAPACITY_SAMPLES = 16000 * 30;
+
+/**
+ * Default time from a push until its audio should reach the backend
+ * (see wf_session_set_target_latency)
+ */
+static const int DEFAULT_TARGET_LATENCY_MS = 1000;
+
+/**
+ * Capacity of a session's chunk-mark queue; pushes beyond it go unmarked
+ */
+static const size_t SESSION_CHUNK_MARKS = 1024;
 
 /**
  * Engine state enum - matches Node layer exactly
@@ -26,40 +55,175 @@ enum class EngineState {
     DISPOSED
 };
 
+struct EngineStateData;
+
+/**
+ * One pushed chunk: the session's samples up to end_sample (counted
+ * from its first push) arrived at pushed_us and are due at deadline_us
+ * (steady clock)
+ */
+struct ChunkMark {
+    uint64_t end_sample;
+    int64_t pushed_us;
+    int64_t deadline_us;
+    uint64_t trace_flow;    // Trace arrow from push to drain (0 = not tracing)
+};
+
+/**
+ * SPSC queue of chunk marks, preallocated like the audio ring.
+ * Written by the pusher holding producer_lock, read by the drain holding
+ * drain_mutex. A push that finds it full goes unmarked; its samples are
+ * then covered by the next mark (a later, more lenient deadline).
+ */
+class ChunkMarkQueue {
+public:
+    ChunkMarkQueue() : marks_(SESSION_CHUNK_MARKS) {}
+    
+    bool push(const ChunkMark& mark) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == marks_.size()) {
+            return false;
+        }
+        marks_[head % marks_.size()] = mark;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /** Oldest mark, or nullptr if none */
+    const ChunkMark* front() const {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &marks_[tail % marks_.size()];
+    }
+    
+    void pop() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    
+private:
+    std::vector<ChunkMark> marks_;
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+};
+
+/**
+ * Per-session audio stream
+ * 
+ * Written by the push_audio calls without taking the engine mutex,
+ * drained by tasks on the process-wide inference pool (one task per
+ * stream at a time, see schedule_drain).
+ * Pushers pin the stream with push_refs; close_session_stream() sets
+ * closed and waits for push_refs to drain, after which no pusher
+ * touches the stream or its engine again.
+ */
+struct SessionStream : std::enable_shared_from_this<SessionStream> {
+    explicit SessionStream(const std::string& session_id, EngineStateData* owner)
+        : id(session_id), engine(owner), ring(SESSION_AUDIO_CAPACITY_SAMPLES) {}
+    
+    const std::string id;
+    EngineStateData* const engine;
+    AudioRingBuffer ring;
+    
+    // Ring is SPSC; concurrent pushers serialize on this (uncontended
+    // with a single capture thread)
+    std::atomic_flag producer_lock = ATOMIC_FLAG_INIT;
+    
+    std::atomic<int> push_refs{0};
+    std::atomic<bool> closed{false};
+    
+    std::atomic<int> chunk_count{0};
+    std::atomic<int> rejected_pushes{0};
+    
+    // Deadlines: each accepted push is marked with now + target latency
+    std::atomic<int> target_latency_ms{DEFAULT_TARGET_LATENCY_MS};
+    ChunkMarkQueue marks;
+    uint64_t pushed_samples = 0;    // producer_lock
+    
+    std::string language;           // Set before the stream is published
+    bool vad_enabled = true;        // WFSessionConfig::vad_enabled
+    
+    // START_SESSION handled; audio may be drained
+    std::atomic<bool> started{false};
+    
+    // Set while a drain task is queued or running
+    std::atomic<bool> drain_scheduled{false};
+    
+    // Held while audio goes to the backend. END_SESSION and shutdown take
+    // it to wait out a running drain and then set finished, after which
+    // drain tasks leave the stream (and its engine) alone.
+    std::mutex drain_mutex;
+    bool finished = false;
+    
+    // drain_mutex: overload accounting (see report_backpressure)
+    uint64_t drained_samples = 0;
+    int merged_chunks = 0;          // Chunks that went out in a merged drain
+    int reported_drops = 0;
+    int reported_merges = 0;
+    int64_t last_warning_us = 0;
+    
+    // Written by the engine worker before started, then under drain_mutex
+    uint32_t backend_session = 0;   // whisper_backend session ID (0 = none)
+    
+    // Engine worker only: threads held from the budget for final passes
+    int final_pass_threads = 0;
+    
+    // Models of the session's quality levels (WF_EVENT_QUALITY_CHANGED),
+    // set by the engine worker before started
+    std::string model_id;
+    std::string fallback_model_id;
+};
+
 /**
  * Work item for the worker thread queue
+ * Audio does not go through the queue - see SessionStream.
  */
 struct WorkItem {
     enum class Type {
         LOAD_MODEL,
         UNLOAD_MODEL,
-        PROCESS_AUDIO,
+        START_SESSION,
         END_SESSION,
         SHUTDOWN
     };
     
     Type type;
-    std::string data;           // Model ID or session ID
-    std::vector<float> audio;   // Audio data for PROCESS_AUDIO
+    std::string data;                       // Model ID or session ID
+    std::shared_ptr<SessionStream> stream;  // Session for START/END_SESSION
+    uint64_t generation = 0;                // LOAD_MODEL: load_generation when queued
 };
 
 /**
  * Internal engine state - all access protected by mutex
  */
 struct EngineStateData {
+    std::mutex mutex;
+    
     // Core state
     EngineState state = EngineState::UNINITIALIZED;
     int device = 0;             // 0 = CPU, 1 = GPU
-    int log_level = 0;          // 0 = error, 1 = warn, 2 = info
+    std::string model_dir;      // Resolved from WFEngineConfig::model_dir
+    
+    // 0 = error, 1 = warn, 2 = info, -1 = off. Read without the mutex
+    // so logging never nests it.
+    std::atomic<int> log_level{0};
     
     // Model state
-    std::string loaded_model_id;
+    std::string loaded_model_id;    // Set by the worker once a load succeeds
+    std::string loading_model_id;   // Requested, not yet loaded
+    std::string final_model_id;     // Two-tier final model for the next load ("" = none)
+    int final_model_threads = 0;
+    std::string fallback_model_id;  // Degradation model for the next load ("" = none)
+    
+    // Bumped by every load, unload and cancel request (and destroy);
+    // a load that sees a newer value stops. Read by the worker unlocked.
+    std::atomic<uint64_t> load_generation{0};
     
     // Session state
     std::string active_session_id;
-    std::string session_language;
     bool session_vad_enabled = true;
-    int chunk_count = 0;
+    std::shared_ptr<SessionStream> session_stream;
     
     // Callback
     void* callback = nullptr;
@@ -68,9 +232,27 @@ struct EngineStateData {
     // Worker thread
     std::thread worker_thread;
     std::queue<WorkItem> work_queue;
-    std::mutex queue_mutex;
     std::condition_variable queue_cv;
     std::atomic<bool> shutdown_requested{false};
+    
+    // Worker-thread only
+    WBModel* backend_model = nullptr;
+    WBModel* backend_final_model = nullptr;    // Two-tier, loaded with backend_model
+    int backend_final_threads = 0;
+    WBModel* backend_fallback_model = nullptr; // Degradation, loaded with backend_model
+    std::string backend_fallback_id;
+};
+
+/**
+ * Opaque handles from the public API
+ */
+struct WFEngine {
+    EngineStateData state;
+};
+
+struct WFSession {
+    WFEngine* engine;
+    std::shared_ptr<SessionStream> stream;
 };
 
 #endif /* WISPRFLEX_ENGINE_STATE_H */
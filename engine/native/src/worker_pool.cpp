@@ -0,0 +1,132 @@
+/**
+ * WisprFlex Native Engine - Work-stealing Worker Pool
+ */
+
+#include "worker_pool.h"
+#include "trace.h"
+
+// Which pool (and deque) the current thread works for
+static thread_local const WorkStealingPool* t_pool = nullptr;
+static thread_local size_t t_index = 0;
+
+WorkStealingPool::~WorkStealingPool() {
+    stop();
+}
+
+void WorkStealingPool::start(int worker_count) {
+    // Threads first: a running task may itself be submitting
+    stop();
+
+    size_t count = worker_count > 0 ? (size_t)worker_count : 1;
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(deques_mutex_);
+
+        // Collect what is still queued before the deques are rebuilt
+        std::vector<Task> queued;
+        for (auto& deque : deques_) {
+            for (auto& task : deque->tasks) {
+                queued.push_back(std::move(task));
+            }
+        }
+
+        deques_.clear();
+        for (size_t i = 0; i < count; i++) {
+            deques_.emplace_back(new Deque());
+        }
+        for (size_t i = 0; i < queued.size(); i++) {
+            deques_[i % count]->tasks.push_back(std::move(queued[i]));
+        }
+        pending_ = (int64_t)queued.size();
+    }
+
+    stopping_ = false;
+    for (size_t i = 0; i < count; i++) {
+        threads_.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+void WorkStealingPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+bool WorkStealingPool::on_worker_thread() const {
+    return t_pool == this;
+}
+
+void WorkStealingPool::submit(Task task) {
+    {
+        std::shared_lock<std::shared_timed_mutex> resize_lock(deques_mutex_);
+        size_t index = t_pool == this ? t_index
+                                      : next_deque_.fetch_add(1, std::memory_order_relaxed) % deques_.size();
+        {
+            std::lock_guard<std::mutex> lock(deques_[index]->mutex);
+            deques_[index]->tasks.push_back(std::move(task));
+        }
+
+        // Counted before a resize can recount the deques. Taking
+        // sleep_mutex_ orders the increment against a thread that has
+        // just found nothing and is about to wait.
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        pending_++;
+    }
+    wake_.notify_one();
+}
+
+bool WorkStealingPool::take(size_t self, Task& out) {
+    {
+        Deque& own = *deques_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            out = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // Steal, starting with the next thread so victims are spread out
+    for (size_t i = 1; i < deques_.size(); i++) {
+        Deque& victim = *deques_[(self + i) % deques_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            out = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(size_t self) {
+    t_pool = this;
+    t_index = self;
+    trace_set_thread_name("inference pool");
+
+    while (!stopping_) {
+        Task task;
+        if (take(self, task)) {
+            pending_--;
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [this] { return stopping_ || pending_ > 0; });
+        if (stopping_) {
+            break;
+        }
+    }
+
+    t_pool = nullptr;
+}
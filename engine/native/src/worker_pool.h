@@ -0,0 +1,92 @@
+/**
+ * WisprFlex Native Engine - Work-stealing Worker Pool
+ *
+ * Internal header - not part of public API.
+ *
+ * Fixed set of threads, each with its own task deque.
+ * - Tasks submitted from a pool thread go to that thread's deque,
+ *   others are spread round-robin
+ * - Owners take from the front (oldest first), so tasks that resubmit
+ *   themselves are served round-robin with the rest of the deque
+ * - An idle thread steals from the back of another thread's deque
+ * - Every deque has its own mutex; no lock is shared by all threads
+ */
+
+#ifndef WISPRFLEX_WORKER_POOL_H
+#define WISPRFLEX_WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    WorkStealingPool() = default;
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * Start worker_count threads, or resize a running pool.
+     * Queued tasks are kept and spread over the new deques; submit() may
+     * run concurrently. start() and stop() must not race each other, and
+     * must not be called from a pool thread (it would join itself).
+     */
+    void start(int worker_count);
+
+    /**
+     * Join all threads after their current task. Queued tasks are kept
+     * until the next start() (or dropped with the pool).
+     */
+    void stop();
+
+    /**
+     * Queue a task (any thread). Requires a started pool.
+     */
+    void submit(Task task);
+
+    int workers() const { return (int)threads_.size(); }
+
+    /** True on one of this pool's threads (inside a task) */
+    bool on_worker_thread() const;
+
+    /** Tasks taken from another thread's deque since construction */
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Deque {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(size_t self);
+    bool take(size_t self, Task& out);
+
+    // Rebuilt by start() under an exclusive lock; submit() holds it shared
+    std::shared_timed_mutex deques_mutex_;
+    std::vector<std::unique_ptr<Deque>> deques_;
+    std::vector<std::thread> threads_;
+
+    // Sleeping threads wait here; pending_ counts queued tasks (briefly
+    // negative when a task is taken before submit() has counted it)
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<int64_t> pending_{0};
+    std::atomic<bool> stopping_{false};
+
+    std::atomic<size_t> next_deque_{0};
+    std::atomic<uint64_t> steals_{0};
+};
+
+#endif /* WISPRFLEX_WORKER_POOL_H */
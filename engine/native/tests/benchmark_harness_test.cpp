@@ -0,0 +1,318 @@
+/**
+ * WisprFlex Whisper Backend - Benchmark Harness Test Suite
+ *
+ * Verifies:
+ * - Median, percentiles and spread of samples
+ * - Warm-up iterations are run but not measured; per-case overrides
+ * - Failures stop a benchmark; filters select cases
+ * - Results survive a JSON round trip
+ * - Comparison flags regressions only beyond threshold, noise floor and spread
+ */
+
+#include "../whisper_backend/benchmark_harness.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("Testing: %s... ", name); \
+    fflush(stdout);
+
+#define PASS() \
+    printf("PASS\n"); \
+    tests_passed++;
+
+#define FAIL(reason) \
+    printf("FAIL (%s)\n", reason); \
+    tests_failed++;
+
+#define ASSERT(condition, reason) \
+    if (!(condition)) { FAIL(reason); return; }
+
+#define ASSERT_EQ(actual, expected, reason) \
+    if ((actual) != (expected)) { FAIL(reason); return; }
+
+#define ASSERT_NEAR(actual, expected, reason) \
+    if (std::fabs((actual) - (expected)) > 1e-9) { FAIL(reason); return; }
+
+static const char* RESULTS_PATH = "benchmark_harness_test.json";
+
+/**
+ * One benchmark with one metric holding the given samples
+ */
+static BenchmarkResult make_result(const char* benchmark, const char* metric,
+                                   const std::vector<double>& samples, double min_delta = 0.0) {
+    BenchmarkResult result = {};
+    result.name = benchmark;
+    result.ok = true;
+    result.iterations = (int)samples.size();
+    BenchmarkMetric m = {};
+    m.name = metric;
+    m.unit = "ms";
+    m.min_delta = min_delta;
+    m.samples = samples;
+    m.stats = benchmark_stats(samples);
+    result.metrics.push_back(m);
+    return result;
+}
+
+static BenchmarkVerdict verdict_of(const std::vector<double>& baseline, const std::vector<double>& current,
+                                   double min_delta = 0.0) {
+    std::vector<BenchmarkComparison> comparisons = benchmark_compare(
+        {make_result("b", "m", baseline, min_delta)}, {make_result("b", "m", current, min_delta)}, 0.10);
+    return comparisons.size() == 1 ? comparisons[0].verdict : BENCHMARK_MISSING;
+}
+
+// ============================================
+// Statistics
+// ============================================
+
+void test_stats() {
+    TEST("Median, percentiles and spread");
+
+    // Unsorted 1..10
+    BenchmarkStats s = benchmark_stats({7, 3, 10, 1, 5, 9, 2, 8, 4, 6});
+    ASSERT_EQ(s.count, (size_t)10, "count");
+    ASSERT_NEAR(s.min, 1.0, "min");
+    ASSERT_NEAR(s.max, 10.0, "max");
+    ASSERT_NEAR(s.mean, 5.5, "mean");
+    ASSERT_NEAR(s.median, 5.5, "even median interpolates");
+    ASSERT_NEAR(s.p90, 9.1, "p90");
+    ASSERT_NEAR(s.p99, 9.91, "p99");
+    ASSERT_NEAR(s.stddev, std::sqrt(55.0 / 6.0), "sample stddev");
+
+    ASSERT_NEAR(benchmark_stats({4, 1, 100}).median, 4.0, "odd median");
+
+    BenchmarkStats one = benchmark_stats({3});
+    ASSERT(one.median == 3 && one.p99 == 3 && one.stddev == 0, "single sample");
+
+    BenchmarkStats none = benchmark_stats({});
+    ASSERT(none.count == 0 && none.median == 0, "no samples");
+
+    PASS();
+}
+
+// ============================================
+// Running
+// ============================================
+
+void test_warmup_not_measured() {
+    TEST("Warm-up runs are not measured; overrides apply");
+
+    BenchmarkOptions options;
+    options.warmup_iterations = 2;
+    options.iterations = 3;
+    BenchmarkSuite suite(options);
+
+    int calls = 0;
+    suite.add("counted", [&](BenchmarkRecorder& r) {
+        calls++;
+        r.record("call", "n", calls);
+        r.record("call", "n", calls);  // Several samples per iteration
+    });
+    int once_calls = 0;
+    bool once_warmed_up = false;
+    suite.add("once", [&](BenchmarkRecorder& r) {
+        once_calls++;
+        once_warmed_up = once_warmed_up || r.warming_up();
+        r.record("value", "ms", 1.0);
+    }, 0, 1);
+
+    std::vector<BenchmarkResult> results = suite.run();
+    ASSERT_EQ(results.size(), (size_t)2, "results");
+    ASSERT_EQ(calls, 5, "warm-up + measured calls");
+    ASSERT_EQ(results[0].iterations, 3, "iterations");
+    ASSERT_EQ(results[0].warmup_iterations, 2, "warm-up count");
+    ASSERT_EQ(results[0].metrics.size(), (size_t)1, "metrics");
+    ASSERT_EQ(results[0].metrics[0].samples.size(), (size_t)6, "samples");
+    ASSERT_NEAR(results[0].metrics[0].stats.min, 3.0, "warm-up sample kept");
+    ASSERT_NEAR(results[0].metrics[0].stats.median, 4.0, "median of measured calls");
+    ASSERT_EQ(once_calls, 1, "override iterations");
+    ASSERT(!once_warmed_up, "override warm-up ran");
+    ASSERT_EQ(results[1].iterations, 1, "override result");
+
+    PASS();
+}
+
+void test_failure_and_filter() {
+    TEST("Failure stops a benchmark; filter selects cases");
+
+    BenchmarkOptions options;
+    options.warmup_iterations = 0;
+    options.iterations = 5;
+    options.filter = "stream";
+    BenchmarkSuite suite(options);
+
+    int calls = 0;
+    suite.add("streaming", [&](BenchmarkRecorder& r) {
+        calls++;
+        r.record("chunk_ms", "ms", 1.0);
+        if (calls == 2) {
+            r.fail("boom");
+            r.fail("second reason");
+        }
+    });
+    bool other_ran = false;
+    suite.add("model_load", [&](BenchmarkRecorder&) { other_ran = true; });
+
+    ASSERT_EQ(suite.names().size(), (size_t)2, "registered names");
+    std::vector<BenchmarkResult> results = suite.run();
+    ASSERT_EQ(results.size(), (size_t)1, "filtered");
+    ASSERT(!other_ran, "filtered case ran");
+    ASSERT_EQ(calls, 2, "iterations after failure");
+    ASSERT(!results[0].ok, "ok");
+    ASSERT(results[0].error == "boom", "first reason kept");
+    ASSERT_EQ(results[0].iterations, 1, "completed iterations");
+
+    PASS();
+}
+
+// ============================================
+// JSON
+// ============================================
+
+void test_json_round_trip() {
+    TEST("Results survive a JSON round trip");
+
+    std::vector<BenchmarkResult> written = {
+        make_result("streaming \"quoted\"", "chunk_ms", {12.5, 10.25, 11.0, 30.125}, 0.5),
+        make_result("model_load", "load_ms", {250.0}),
+    };
+    written[1].ok = false;
+    written[1].error = "load\nfailed";
+    BenchmarkContext context = {{"model", "models/ggml-base.bin"}, {"iterations", "4"}};
+
+    std::string error;
+    ASSERT(benchmark_write_json(RESULTS_PATH, context, written, &error), error.c_str());
+
+    std::vector<BenchmarkResult> read;
+    ASSERT(benchmark_read_json(RESULTS_PATH, read, &error), error.c_str());
+    ASSERT_EQ(read.size(), (size_t)2, "benchmarks");
+    ASSERT(read[0].name == "streaming \"quoted\"", "escaped name");
+    ASSERT(read[0].ok, "ok");
+    ASSERT_EQ(read[0].iterations, 4, "iterations");
+    ASSERT_EQ(read[0].metrics.size(), (size_t)1, "metrics");
+    const BenchmarkMetric& metric = read[0].metrics[0];
+    ASSERT(metric.name == "chunk_ms" && metric.unit == "ms", "metric name/unit");
+    ASSERT_NEAR(metric.min_delta, 0.5, "min_delta");
+    ASSERT_EQ(metric.samples.size(), (size_t)4, "samples");
+    ASSERT_NEAR(metric.stats.median, written[0].metrics[0].stats.median, "median");
+    ASSERT_NEAR(metric.stats.p90, written[0].metrics[0].stats.p90, "p90");
+    ASSERT(!read[1].ok && read[1].error == "load\nfailed", "failure");
+
+    PASS();
+}
+
+void test_json_errors() {
+    TEST("Unreadable or malformed results are rejected");
+
+    std::vector<BenchmarkResult> read;
+    std::string error;
+    ASSERT(!benchmark_read_json("/nonexistent-dir/baseline.json", read, &error), "missing file read");
+    ASSERT(!error.empty(), "no reason");
+
+    FILE* out = fopen(RESULTS_PATH, "w");
+    ASSERT(out != nullptr, "create file");
+    fputs("{\"benchmarks\": [{\"name\": \"x\", \"metrics\": [}", out);
+    fclose(out);
+    error.clear();
+    ASSERT(!benchmark_read_json(RESULTS_PATH, read, &error), "truncated JSON read");
+    ASSERT(error.find("offset") != std::string::npos, "no position");
+
+    // Stats without samples are taken as written
+    out = fopen(RESULTS_PATH, "w");
+    ASSERT(out != nullptr, "create file");
+    fputs("{\"benchmarks\": [{\"name\": \"x\", \"metrics\": "
+          "[{\"name\": \"m\", \"unit\": \"ms\", \"count\": 3, \"median\": 2.5e1, \"p90\": 30}]}]}", out);
+    fclose(out);
+    ASSERT(benchmark_read_json(RESULTS_PATH, read, &error), error.c_str());
+    ASSERT(read.size() == 1 && read[0].ok, "hand-written baseline");
+    ASSERT_NEAR(read[0].metrics[0].stats.median, 25.0, "median");
+
+    PASS();
+}
+
+// ============================================
+// Comparison
+// ============================================
+
+void test_compare_verdicts() {
+    TEST("Regressions need threshold, noise floor and spread");
+
+    std::vector<double> base = {100, 101, 102, 103, 104};
+    ASSERT_EQ(verdict_of(base, {120, 121, 122, 123, 124}), BENCHMARK_REGRESSED, "20% slower");
+    ASSERT_EQ(verdict_of(base, {108, 109, 110, 111, 112}), BENCHMARK_UNCHANGED, "8% slower");
+    ASSERT_EQ(verdict_of(base, {80, 81, 82, 83, 84}), BENCHMARK_IMPROVED, "20% faster");
+
+    // A noisy baseline: a 20% higher median is still inside its spread
+    ASSERT_EQ(verdict_of({50, 100, 102, 200, 210}, {118, 120, 122}), BENCHMARK_UNCHANGED, "within spread");
+
+    // Absolute noise floor for metrics near zero (e.g. memory growth)
+    ASSERT_EQ(verdict_of({0.1, 0.2, 0.3}, {1.0, 1.1, 1.2}, 2.0), BENCHMARK_UNCHANGED, "below noise floor");
+    ASSERT_EQ(verdict_of({0.1, 0.2, 0.3}, {5.0, 5.1, 5.2}, 2.0), BENCHMARK_REGRESSED, "above noise floor");
+
+    std::vector<BenchmarkComparison> c = benchmark_compare(
+        {make_result("b", "m", {100})}, {make_result("b", "m", {150})}, 0.10);
+    ASSERT(c.size() == 1 && std::fabs(c[0].change - 0.5) < 1e-9, "relative change");
+    ASSERT_EQ(benchmark_print_comparison(c), 1, "regressions counted");
+
+    PASS();
+}
+
+void test_compare_missing_and_new() {
+    TEST("Missing, failed and new metrics are reported, not flagged");
+
+    std::vector<BenchmarkResult> baseline = {
+        make_result("streaming", "chunk_ms", {10, 11, 12}),
+        make_result("model_load", "load_ms", {200, 210}),
+        make_result("filtered_out", "cycle_ms", {5}),
+    };
+    std::vector<BenchmarkResult> current = {
+        make_result("streaming", "first_partial_ms", {500}),
+        make_result("model_load", "load_ms", {900}),
+    };
+    current[1].ok = false;
+
+    std::vector<BenchmarkComparison> c = benchmark_compare(baseline, current);
+    ASSERT_EQ(c.size(), (size_t)3, "comparisons");
+    ASSERT(c[0].metric == "chunk_ms" && c[0].verdict == BENCHMARK_MISSING, "missing metric");
+    ASSERT(c[1].metric == "load_ms" && c[1].verdict == BENCHMARK_MISSING, "failed benchmark");
+    ASSERT(c[2].metric == "first_partial_ms" && c[2].verdict == BENCHMARK_NEW, "new metric");
+    ASSERT_EQ(benchmark_print_comparison(c), 0, "regressions");
+
+    PASS();
+}
+
+int main() {
+    printf("\n========================================\n");
+    printf("WisprFlex Benchmark Harness - Test Suite\n");
+    printf("========================================\n\n");
+
+    // Statistics
+    test_stats();
+
+    // Running
+    test_warmup_not_measured();
+    test_failure_and_filter();
+
+    // JSON
+    test_json_round_trip();
+    test_json_errors();
+
+    // Comparison
+    test_compare_verdicts();
+    test_compare_missing_and_new();
+
+    remove(RESULTS_PATH);
+
+    printf("\n========================================\n");
+    printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
+    printf("========================================\n\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -9,11 +9,20 @@
  */
 
 #include "../include/wisprflex_engine.h"
+#include "../src/audio_ring_buffer.h"
+#include "../src/worker_pool.h"
+#include "../whisper_backend/trace.h"
 #include <cstdio>
 #include <cstring>
 #include <thread>
 #include <vector>
 #include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
 
 static int tests_passed = 0;
 static int tests_failed = 0;
@@ -54,7 +63,7 @@ void test_version() {
 
 void test_init_success() {
     TEST("Init with valid config")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_INFO};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_INFO, nullptr};
     WFErrorCode result = wf_engine_init(&config);
     ASSERT_EQ(result, WF_OK, "init failed")
     ASSERT(wf_engine_is_initialized(), "not initialized")
@@ -71,7 +80,7 @@ void test_init_fails_without_config() {
 
 void test_init_fails_with_gpu() {
     TEST("Init fails with GPU (Phase 2.1)")
-    WFEngineConfig config = {WF_DEVICE_GPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_GPU, WF_LOG_ERROR, nullptr};
     WFErrorCode result = wf_engine_init(&config);
     ASSERT_EQ(result, WF_ERROR_DEVICE_NOT_SUPPORTED, "should fail with GPU")
     PASS()
@@ -79,7 +88,7 @@ void test_init_fails_with_gpu() {
 
 void test_double_init() {
     TEST("Double init returns error")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     wf_engine_init(&config);
     WFErrorCode result = wf_engine_init(&config);
     ASSERT_EQ(result, WF_ERROR_ALREADY_INITIALIZED, "should fail")
@@ -89,7 +98,7 @@ void test_double_init() {
 
 void test_dispose_idempotent() {
     TEST("Dispose is idempotent")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     wf_engine_init(&config);
     WFErrorCode r1 = wf_engine_dispose();
     WFErrorCode r2 = wf_engine_dispose();
@@ -100,7 +109,7 @@ void test_dispose_idempotent() {
 
 void test_repeated_init_dispose() {
     TEST("Repeated init/dispose cycles (10x)")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     for (int i = 0; i < 10; i++) {
         WFErrorCode r1 = wf_engine_init(&config);
         if (r1 != WF_OK) { FAIL("init failed"); return; }
@@ -114,22 +123,79 @@ void test_repeated_init_dispose() {
  * Model Tests
  * ============================================ */
 
+/**
+ * Poll until the worker has finished loading model_id
+ * @return true if it was loaded within ~1s
+ */
+static bool wait_for_model(WFEngine* engine, const char* model_id) {
+    for (int i = 0; i < 100; i++) {
+        const char* loaded = engine ? wf_engine_instance_get_loaded_model(engine)
+                                    : wf_engine_get_loaded_model();
+        if (loaded && strcmp(loaded, model_id) == 0) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
 void test_load_model_success() {
     TEST("Load model succeeds")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     wf_engine_init(&config);
     WFErrorCode result = wf_engine_load_model("base");
     ASSERT_EQ(result, WF_OK, "load failed")
-    const char* loaded = wf_engine_get_loaded_model();
-    ASSERT(loaded != nullptr, "no model loaded")
-    ASSERT(strcmp(loaded, "base") == 0, "wrong model")
+    ASSERT(wait_for_model(nullptr, "base"), "model not loaded")
+    wf_engine_dispose();
+    PASS()
+}
+
+void test_load_model_is_async() {
+    TEST("Model is loaded only after the worker finishes")
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    wf_engine_init(&config);
+    ASSERT_EQ(wf_engine_load_model("base"), WF_OK, "load failed")
+    ASSERT(wf_engine_get_loaded_model() == nullptr, "loaded before the worker ran")
+    ASSERT(wait_for_model(nullptr, "base"), "model not loaded")
+    wf_engine_dispose();
+    PASS()
+}
+
+static std::atomic<int> g_load_cancelled_events{0};
+
+static void on_cancel_event(const WFEvent* event, void* user_data) {
+    (void)user_data;
+    if (event->type == WF_EVENT_ERROR && event->data.error.code == WF_ERROR_MODEL_LOAD_CANCELLED) {
+        g_load_cancelled_events++;
+    }
+}
+
+void test_cancel_model_load() {
+    TEST("Cancel model load")
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    wf_engine_init(&config);
+    g_load_cancelled_events = 0;
+    wf_engine_set_callback(on_cancel_event, nullptr);
+    ASSERT_EQ(wf_engine_cancel_model_load(), WF_OK, "cancel without load failed")
+    
+    wf_engine_load_model("base");
+    ASSERT_EQ(wf_engine_cancel_model_load(), WF_OK, "cancel failed")
+    for (int i = 0; i < 100 && g_load_cancelled_events == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(g_load_cancelled_events.load(), 1, "no cancel event")
+    ASSERT(wf_engine_get_loaded_model() == nullptr, "cancelled model loaded")
+    
+    // A later load still works
+    wf_engine_load_model("base");
+    ASSERT(wait_for_model(nullptr, "base"), "load after cancel failed")
     wf_engine_dispose();
     PASS()
 }
 
 void test_load_model_fails_invalid() {
     TEST("Load model fails with invalid model")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     wf_engine_init(&config);
     WFErrorCode result = wf_engine_load_model("nonexistent");
     ASSERT_EQ(result, WF_ERROR_MODEL_NOT_FOUND, "should fail")
@@ -139,7 +205,7 @@ void test_load_model_fails_invalid() {
 
 void test_unload_model() {
     TEST("Unload model clears state")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     wf_engine_init(&config);
     wf_engine_load_model("base");
     wf_engine_unload_model();
@@ -149,13 +215,78 @@ void test_unload_model() {
     PASS()
 }
 
+void test_set_model_budget() {
+    TEST("Model budget can be set and cleared")
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    wf_engine_init(&config);
+    ASSERT_EQ(wf_engine_set_model_budget(512u * 1024 * 1024), WF_OK, "set budget failed")
+    wf_engine_load_model("tiny");
+    wf_engine_load_model("base");
+    ASSERT(wait_for_model(nullptr, "base"), "wrong model after switch")
+    ASSERT_EQ(wf_engine_set_model_budget(0), WF_OK, "clear budget failed")
+    wf_engine_dispose();
+    PASS()
+}
+
+void test_set_final_model() {
+    TEST("Final model is validated and loaded with the draft model")
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    wf_engine_init(&config);
+    ASSERT_EQ(wf_engine_set_final_model("nonexistent", 0), WF_ERROR_MODEL_NOT_FOUND, "should fail")
+    ASSERT_EQ(wf_engine_set_final_model("base", 2), WF_OK, "set final model failed")
+    wf_engine_load_model("tiny");
+    ASSERT(wait_for_model(nullptr, "tiny"), "draft model not loaded")
+    ASSERT_EQ(wf_engine_set_final_model(nullptr, 0), WF_OK, "clear final model failed")
+    wf_engine_dispose();
+    PASS()
+}
+
+void test_set_fallback_model() {
+    TEST("Fallback model is validated and loaded with the model")
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    wf_engine_init(&config);
+    ASSERT_EQ(wf_engine_set_fallback_model("nonexistent"), WF_ERROR_MODEL_NOT_FOUND, "should fail")
+    ASSERT_EQ(wf_engine_set_fallback_model("tiny"), WF_OK, "set fallback model failed")
+    wf_engine_load_model("base");
+    ASSERT(wait_for_model(nullptr, "base"), "model not loaded")
+    ASSERT_EQ(wf_engine_set_fallback_model(""), WF_OK, "clear fallback model failed")
+    wf_engine_dispose();
+    PASS()
+}
+
+static std::atomic<int> g_last_model_progress{-1};
+
+static void on_progress_event(const WFEvent* event, void* user_data) {
+    (void)user_data;
+    if (event->type == WF_EVENT_MODEL_PROGRESS) {
+        g_last_model_progress = event->data.model_progress.progress;
+    }
+}
+
+void test_load_model_emits_progress() {
+    TEST("Load model emits progress events")
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    wf_engine_init(&config);
+    g_last_model_progress = -1;
+    wf_engine_set_callback(on_progress_event, nullptr);
+    wf_engine_load_model("base");
+    
+    for (int i = 0; i < 100 && g_last_model_progress != 100; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(g_last_model_progress.load(), 100, "no completion progress event")
+    
+    wf_engine_dispose();
+    PASS()
+}
+
 /* ============================================
  * Session Tests
  * ============================================ */
 
 void test_start_session_success() {
     TEST("Start session succeeds")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     wf_engine_init(&config);
     wf_engine_load_model("base");
     
@@ -171,7 +302,7 @@ void test_start_session_success() {
 
 void test_start_session_before_load() {
     TEST("Start session before load fails")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     wf_engine_init(&config);
     
     char session_id[64] = {0};
@@ -184,7 +315,7 @@ void test_start_session_before_load() {
 
 void test_double_session() {
     TEST("Double session returns error")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     wf_engine_init(&config);
     wf_engine_load_model("base");
     
@@ -201,7 +332,7 @@ void test_double_session() {
 
 void test_push_audio() {
     TEST("Push audio succeeds")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     wf_engine_init(&config);
     wf_engine_load_model("base");
     
@@ -218,7 +349,7 @@ void test_push_audio() {
 
 void test_push_audio_wrong_session() {
     TEST("Push audio with wrong session fails")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     wf_engine_init(&config);
     wf_engine_load_model("base");
     
@@ -235,7 +366,7 @@ void test_push_audio_wrong_session() {
 
 void test_end_session() {
     TEST("End session succeeds")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     wf_engine_init(&config);
     wf_engine_load_model("base");
     
@@ -252,13 +383,539 @@ void test_end_session() {
     PASS()
 }
 
+void test_push_audio_after_end() {
+    TEST("Push audio after end session fails")
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    wf_engine_init(&config);
+    wf_engine_load_model("base");
+    
+    char session_id[64] = {0};
+    wf_engine_start_session(nullptr, session_id, sizeof(session_id));
+    wf_engine_end_session(session_id);
+    
+    float audio[160] = {0};
+    WFErrorCode result = wf_engine_push_audio(session_id, audio, 160);
+    ASSERT_EQ(result, WF_ERROR_SESSION_ENDED, "should fail")
+    
+    wf_engine_dispose();
+    PASS()
+}
+
+void test_push_audio_backpressure_samples() {
+    TEST("Backpressure measured in buffered samples")
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    wf_engine_init(&config);
+    wf_engine_load_model("base");
+    
+    char session_id[64] = {0};
+    wf_engine_start_session(nullptr, session_id, sizeof(session_id));
+    
+    // Many small pushes no longer hit a fixed item cap
+    float small[160] = {0};
+    for (int i = 0; i < 100; i++) {
+        WFErrorCode r = wf_engine_push_audio(session_id, small, 160);
+        if (r != WF_OK) { FAIL("small push rejected"); wf_engine_dispose(); return; }
+    }
+    
+    // A single push larger than the buffer budget is rejected whole
+    std::vector<float> huge(16000 * 120, 0.0f);
+    WFErrorCode result = wf_engine_push_audio(session_id, huge.data(), huge.size());
+    ASSERT_EQ(result, WF_ERROR_BACKPRESSURE_LIMIT, "oversized push accepted")
+    
+    wf_engine_dispose();
+    PASS()
+}
+
+struct BackpressureCounts {
+    std::atomic<int> warnings{0};
+    std::atomic<int> dropped{0};
+    std::atomic<int> merged{0};
+};
+
+static void on_backpressure_event(const WFEvent* event, void* user_data) {
+    BackpressureCounts* counts = static_cast<BackpressureCounts*>(user_data);
+    if (event->type == WF_EVENT_BACKPRESSURE_WARNING) {
+        counts->dropped = event->data.backpressure_warning.dropped_chunks;
+        counts->merged = event->data.backpressure_warning.merged_chunks;
+        counts->warnings++;
+    }
+}
+
+void test_late_session_merges_chunks() {
+    TEST("Late session merges chunks and reports counts")
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    WFEngine* engine = nullptr;
+    ASSERT_EQ(wf_engine_create(&config, &engine), WF_OK, "create failed")
+    BackpressureCounts counts;
+    wf_engine_instance_set_callback(engine, on_backpressure_event, &counts);
+    
+    // Nothing is drained until the session starts, after the model load;
+    // by then every chunk is past its 5 ms deadline
+    wf_engine_instance_load_model(engine, "base");
+    WFSession* session = nullptr;
+    ASSERT_EQ(wf_session_start(engine, nullptr, &session), WF_OK, "start failed")
+    ASSERT_EQ(wf_session_set_target_latency(session, 5), WF_OK, "set latency failed")
+    
+    float chunk[1600] = {0};
+    for (int i = 0; i < 20; i++) {
+        ASSERT_EQ(wf_session_push_audio(session, chunk, 1600), WF_OK, "push failed")
+    }
+    std::vector<float> huge(16000 * 40, 0.0f);
+    ASSERT_EQ(wf_session_push_audio(session, huge.data(), huge.size()), 
+              WF_ERROR_BACKPRESSURE_LIMIT, "oversized push accepted")
+    
+    for (int i = 0; i < 100 && counts.warnings == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(counts.warnings.load(), 1, "no backpressure warning")
+    ASSERT_EQ(counts.dropped.load(), 1, "wrong drop count")
+    ASSERT_EQ(counts.merged.load(), 20, "wrong merge count")
+    
+    ASSERT_EQ(wf_session_set_target_latency(nullptr, 5), WF_ERROR_INVALID_SESSION, "null session accepted")
+    wf_session_release(session);
+    wf_engine_destroy(engine);
+    PASS()
+}
+
+/* ============================================
+ * Tracing Tests
+ * ============================================ */
+
+static int count_in_file(const char* path, const std::string& needle) {
+    std::ifstream in(path);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    std::string text = contents.str();
+    int count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+void test_trace_push_to_drain() {
+    TEST("Trace links each push to the drain that consumed it")
+    const char* path = "engine_test_trace.json";
+    ASSERT_EQ(wf_engine_trace_start(0), WF_OK, "trace start failed")
+    
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    wf_engine_init(&config);
+    wf_engine_load_model("base");
+    char session_id[64] = {0};
+    wf_engine_start_session(nullptr, session_id, sizeof(session_id));
+    
+    float audio[1600] = {0};
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQ(wf_engine_push_audio(session_id, audio, 1600), WF_OK, "push failed")
+    }
+    
+    // Arrows end when the drain retires each chunk
+    int flow_ends = 0;
+    for (int i = 0; i < 100 && flow_ends < 5; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        trace_write_json(path);
+        flow_ends = count_in_file(path, "\"ph\":\"f\"");
+    }
+    wf_engine_end_session(session_id);
+    wf_engine_dispose();
+    ASSERT_EQ(wf_engine_trace_stop(path), WF_OK, "trace stop failed")
+    
+    ASSERT_EQ(count_in_file(path, "\"name\":\"push_audio\""), 5, "push spans")
+    ASSERT_EQ(count_in_file(path, "\"ph\":\"s\""), 5, "flow starts")
+    ASSERT_EQ(count_in_file(path, "\"ph\":\"f\""), 5, "flow ends")
+    ASSERT(count_in_file(path, "\"name\":\"drain\"") >= 1, "no drain span")
+    ASSERT(count_in_file(path, "\"name\":\"engine worker\"") == 1, "worker track unnamed")
+    
+    // Stopped: further pushes are not recorded
+    wf_engine_init(&config);
+    wf_engine_load_model("base");
+    wf_engine_start_session(nullptr, session_id, sizeof(session_id));
+    wf_engine_push_audio(session_id, audio, 1600);
+    wf_engine_dispose();
+    trace_write_json(path);
+    ASSERT_EQ(count_in_file(path, "\"name\":\"push_audio\""), 5, "recorded after stop")
+    
+    ASSERT_EQ(wf_engine_trace_stop("/nonexistent-dir/trace.json"), WF_ERROR_INTERNAL, "bad path accepted")
+    remove(path);
+    PASS()
+}
+
+/* ============================================
+ * Audio Ring Buffer Tests
+ * ============================================ */
+
+void test_ring_buffer_wraparound() {
+    TEST("Ring buffer wraparound preserves order")
+    AudioRingBuffer ring(1000);
+    ASSERT(ring.valid(), "allocation failed")
+    ASSERT_EQ(ring.capacity(), (size_t)1024, "capacity not rounded to pow2")
+    
+    std::vector<float> in(700), out(1024);
+    float next_in = 0.0f, next_out = 0.0f;
+    for (int round = 0; round < 10; round++) {
+        for (auto& v : in) v = next_in++;
+        ASSERT(ring.write(in.data(), in.size()), "write failed")
+        size_t n = ring.read(out.data(), out.size());
+        ASSERT_EQ(n, in.size(), "short read")
+        for (size_t i = 0; i < n; i++) {
+            ASSERT(out[i] == next_out++, "sample out of order")
+        }
+    }
+    ASSERT_EQ(ring.size(), (size_t)0, "ring not empty")
+    PASS()
+}
+
+void test_ring_buffer_all_or_nothing() {
+    TEST("Ring buffer rejects writes that do not fit")
+    AudioRingBuffer ring(256);
+    std::vector<float> block(200, 1.0f);
+    ASSERT(ring.write(block.data(), block.size()), "first write failed")
+    ASSERT(!ring.write(block.data(), block.size()), "overflow accepted")
+    ASSERT_EQ(ring.size(), (size_t)200, "partial write happened")
+    PASS()
+}
+
+void test_ring_buffer_spsc_threads() {
+    TEST("Ring buffer SPSC across threads")
+    AudioRingBuffer ring(4096);
+    const int total = 200000;
+    std::atomic<bool> ok{true};
+    
+    std::thread producer([&]() {
+        float block[160];
+        int next = 0;
+        while (next < total) {
+            int n = (total - next < 160) ? total - next : 160;
+            for (int i = 0; i < n; i++) block[i] = (float)(next + i);
+            while (!ring.write(block, n)) std::this_thread::yield();
+            next += n;
+        }
+    });
+    
+    float out[512];
+    int expected = 0;
+    while (expected < total) {
+        size_t n = ring.read(out, 512);
+        for (size_t i = 0; i < n; i++) {
+            if (out[i] != (float)expected++) ok = false;
+        }
+    }
+    producer.join();
+    
+    ASSERT(ok, "corrupted stream")
+    PASS()
+}
+
+/* ============================================
+ * Worker Pool Tests
+ * ============================================ */
+
+void test_pool_runs_all_tasks() {
+    TEST("Worker pool runs every task")
+    WorkStealingPool pool;
+    pool.start(4);
+    ASSERT_EQ(pool.workers(), 4, "wrong worker count")
+    
+    std::atomic<int> done{0};
+    for (int i = 0; i < 1000; i++) {
+        pool.submit([&done] { done++; });
+    }
+    for (int i = 0; i < 200 && done < 1000; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(done.load(), 1000, "tasks lost")
+    pool.stop();
+    PASS()
+}
+
+void test_pool_steals_work() {
+    TEST("Idle workers steal queued tasks")
+    WorkStealingPool pool;
+    pool.start(4);
+    
+    // Tasks submitted from a pool thread land on that thread's deque;
+    // the others can only get them by stealing
+    const int total = 40;
+    std::atomic<int> done{0};
+    std::mutex ids_mutex;
+    std::vector<std::thread::id> ids;
+    pool.submit([&] {
+        for (int i = 0; i < total; i++) {
+            pool.submit([&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                {
+                    std::lock_guard<std::mutex> lock(ids_mutex);
+                    ids.push_back(std::this_thread::get_id());
+                }
+                done++;
+            });
+        }
+    });
+    for (int i = 0; i < 400 && done < total; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    pool.stop();
+    
+    ASSERT_EQ(done.load(), total, "tasks lost")
+    ASSERT(pool.steals() > 0, "nothing stolen")
+    std::sort(ids.begin(), ids.end());
+    ASSERT(std::unique(ids.begin(), ids.end()) - ids.begin() > 1, "one thread ran everything")
+    PASS()
+}
+
+void test_pool_resize_keeps_tasks() {
+    TEST("Worker pool resize keeps queued tasks")
+    WorkStealingPool pool;
+    pool.start(1);
+    
+    // Hold the only worker so the rest stay queued across the resize
+    std::atomic<bool> release{false};
+    std::atomic<int> done{0};
+    pool.submit([&] {
+        while (!release) std::this_thread::yield();
+        done++;
+    });
+    for (int i = 0; i < 10; i++) {
+        pool.submit([&done] { done++; });
+    }
+    std::thread resizer([&pool] { pool.start(3); });
+    release = true;
+    resizer.join();
+    ASSERT_EQ(pool.workers(), 3, "not resized")
+    
+    for (int i = 0; i < 200 && done < 11; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(done.load(), 11, "tasks lost in resize")
+    PASS()
+}
+
+void test_thread_budget_split() {
+    TEST("Thread budget split between workers and inference threads")
+    int workers = 0;
+    int threads = 0;
+    
+    wf_engine_set_thread_budget(32, 0);
+    wf_engine_get_thread_budget(&workers, &threads);
+    ASSERT(workers == 8 && threads == 4, "32 threads not split 8 x 4")
+    
+    wf_engine_set_thread_budget(8, 3);
+    wf_engine_get_thread_budget(&workers, &threads);
+    ASSERT(workers == 3 && threads == 2, "8 threads not split 3 x 2")
+    
+    wf_engine_set_thread_budget(2, 5);
+    wf_engine_get_thread_budget(&workers, &threads);
+    ASSERT(workers == 2 && threads == 1, "workers not capped at budget")
+    
+    // Resizing with engines running keeps them working
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    wf_engine_init(&config);
+    wf_engine_load_model("base");
+    char session_id[64] = {0};
+    wf_engine_start_session(nullptr, session_id, sizeof(session_id));
+    float audio[1600] = {0};
+    wf_engine_set_thread_budget(3, 3);
+    ASSERT_EQ(wf_engine_push_audio(session_id, audio, 1600), WF_OK, "push after resize failed")
+    ASSERT_EQ(wf_engine_end_session(session_id), WF_OK, "end after resize failed")
+    wf_engine_dispose();
+    
+    wf_engine_set_thread_budget(0, 0);
+    wf_engine_get_thread_budget(&workers, &threads);
+    ASSERT(workers >= 1 && threads >= 1, "default split empty")
+    PASS()
+}
+
+struct CallbackCalls {
+    WFEngine* engine = nullptr;
+    std::atomic<int> calls{0};
+    std::atomic<int> budget_result{-1};
+    std::atomic<int> destroy_result{-1};
+    std::atomic<int> dispose_result{-1};
+};
+
+static void on_event_reenter(const WFEvent* event, void* user_data) {
+    CallbackCalls* calls = static_cast<CallbackCalls*>(user_data);
+    if (event->type != WF_EVENT_BACKPRESSURE_WARNING || calls->calls++ > 0) {
+        return;
+    }
+    // Inference pool thread: a resize here used to join this thread
+    calls->budget_result = wf_engine_set_thread_budget(4, 2);
+    calls->destroy_result = wf_engine_destroy(calls->engine);
+    calls->dispose_result = wf_engine_dispose();
+}
+
+void test_thread_budget_from_callback() {
+    TEST("Thread budget and destroy from an inference pool callback")
+    wf_engine_set_thread_budget(3, 3);
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    WFEngine* engine = nullptr;
+    ASSERT_EQ(wf_engine_create(&config, &engine), WF_OK, "create failed")
+    CallbackCalls calls;
+    calls.engine = engine;
+    wf_engine_instance_set_callback(engine, on_event_reenter, &calls);
+    
+    // Chunks pushed before the session starts are late, so the first
+    // drain (a pool task) reports merges to the callback
+    wf_engine_instance_load_model(engine, "base");
+    WFSession* session = nullptr;
+    ASSERT_EQ(wf_session_start(engine, nullptr, &session), WF_OK, "start failed")
+    ASSERT_EQ(wf_session_set_target_latency(session, 5), WF_OK, "set latency failed")
+    float chunk[1600] = {0};
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(wf_session_push_audio(session, chunk, 1600), WF_OK, "push failed")
+    }
+    for (int i = 0; i < 100 && calls.calls == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(calls.calls.load(), 1, "no event on the pool")
+    ASSERT_EQ(calls.budget_result.load(), (int)WF_OK, "budget from callback failed")
+    ASSERT_EQ(calls.destroy_result.load(), (int)WF_ERROR_NOT_ALLOWED_IN_CALLBACK, "destroy from callback allowed")
+    ASSERT_EQ(calls.dispose_result.load(), (int)WF_ERROR_NOT_ALLOWED_IN_CALLBACK, "dispose from callback allowed")
+    
+    int workers = 0;
+    int threads = 0;
+    wf_engine_get_thread_budget(&workers, &threads);
+    ASSERT(workers == 2 && threads == 2, "budget from callback not stored")
+    
+    // The deferred resize runs with the next request; the engine keeps working
+    ASSERT_EQ(wf_session_end(session), WF_OK, "end failed")
+    ASSERT_EQ(wf_session_push_audio(session, chunk, 1600), WF_ERROR_SESSION_ENDED, "push after end accepted")
+    wf_session_release(session);
+    ASSERT_EQ(wf_engine_destroy(engine), WF_OK, "destroy failed")
+    wf_engine_set_thread_budget(0, 0);
+    PASS()
+}
+
+/* ============================================
+ * Multi-Instance Tests
+ * ============================================ */
+
+static void count_progress_event(const WFEvent* event, void* user_data) {
+    if (event->type == WF_EVENT_MODEL_PROGRESS && event->data.model_progress.progress == 100) {
+        static_cast<std::atomic<int>*>(user_data)->fetch_add(1);
+    }
+}
+
+void test_engine_instances_independent() {
+    TEST("Engine instances are independent")
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    WFEngine* a = nullptr;
+    WFEngine* b = nullptr;
+    ASSERT_EQ(wf_engine_create(&config, &a), WF_OK, "create a failed")
+    ASSERT_EQ(wf_engine_create(&config, &b), WF_OK, "create b failed")
+    
+    std::atomic<int> loaded_a{0};
+    std::atomic<int> loaded_b{0};
+    wf_engine_instance_set_callback(a, count_progress_event, &loaded_a);
+    wf_engine_instance_set_callback(b, count_progress_event, &loaded_b);
+    wf_engine_instance_load_model(a, "base");
+    wf_engine_instance_load_model(b, "tiny");
+    ASSERT(wait_for_model(a, "base"), "wrong model on a")
+    ASSERT(wait_for_model(b, "tiny"), "wrong model on b")
+    
+    // One active session per engine, not per process
+    WFSession* sa = nullptr;
+    WFSession* sb = nullptr;
+    ASSERT_EQ(wf_session_start(a, nullptr, &sa), WF_OK, "start on a failed")
+    ASSERT_EQ(wf_session_start(b, nullptr, &sb), WF_OK, "start on b failed")
+    ASSERT(strcmp(wf_session_get_id(sa), wf_session_get_id(sb)) != 0, "session ids collide")
+    
+    float audio[160] = {0};
+    ASSERT_EQ(wf_session_end(sa), WF_OK, "end on a failed")
+    ASSERT_EQ(wf_session_push_audio(sa, audio, 160), WF_ERROR_SESSION_ENDED, "push after end accepted")
+    ASSERT_EQ(wf_session_push_audio(sb, audio, 160), WF_OK, "b affected by a")
+    
+    for (int i = 0; i < 100 && (loaded_a < 1 || loaded_b < 1); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT(loaded_a == 1 && loaded_b == 1, "events crossed engines")
+    
+    wf_session_release(sa);
+    wf_session_release(sb);
+    wf_engine_destroy(a);
+    wf_engine_destroy(b);
+    PASS()
+}
+
+void test_engine_destroy_with_open_session() {
+    TEST("Destroy engine with open session handle")
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    WFEngine* engine = nullptr;
+    wf_engine_create(&config, &engine);
+    wf_engine_instance_load_model(engine, "base");
+    
+    WFSession* session = nullptr;
+    wf_session_start(engine, nullptr, &session);
+    ASSERT_EQ(wf_engine_destroy(engine), WF_OK, "destroy failed")
+    
+    float audio[160] = {0};
+    ASSERT_EQ(wf_session_push_audio(session, audio, 160), WF_ERROR_SESSION_ENDED, "push accepted")
+    ASSERT_EQ(wf_session_end(session), WF_ERROR_SESSION_ENDED, "end accepted")
+    wf_session_release(session);
+    PASS()
+}
+
+void test_engine_instances_parallel_push() {
+    TEST("Parallel push into separate engines")
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
+    
+    // The default engine coexists with handle engines
+    wf_engine_init(&config);
+    wf_engine_load_model("base");
+    char default_id[64] = {0};
+    wf_engine_start_session(nullptr, default_id, sizeof(default_id));
+    
+    const int n_engines = 3;
+    WFEngine* engines[n_engines] = {};
+    WFSession* sessions[n_engines] = {};
+    for (int i = 0; i < n_engines; i++) {
+        wf_engine_create(&config, &engines[i]);
+        wf_engine_instance_load_model(engines[i], "base");
+        wf_session_start(engines[i], nullptr, &sessions[i]);
+    }
+    
+    std::atomic<int> error_count{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < n_engines; i++) {
+        threads.emplace_back([&, i]() {
+            float audio[160] = {0};
+            for (int j = 0; j < 200; j++) {
+                if (wf_session_push_audio(sessions[i], audio, 160) != WF_OK) {
+                    error_count++;
+                }
+            }
+        });
+    }
+    threads.emplace_back([&]() {
+        float audio[160] = {0};
+        for (int j = 0; j < 200; j++) {
+            if (wf_engine_push_audio(default_id, audio, 160) != WF_OK) {
+                error_count++;
+            }
+        }
+    });
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    ASSERT(error_count == 0, "push failed")
+    
+    for (int i = 0; i < n_engines; i++) {
+        wf_session_release(sessions[i]);
+        wf_engine_destroy(engines[i]);
+    }
+    ASSERT(strcmp(wf_engine_get_active_session(), default_id) == 0, "default session lost")
+    wf_engine_dispose();
+    PASS()
+}
+
 /* ============================================
  * Thread Safety Test
  * ============================================ */
 
 void test_concurrent_push_audio() {
     TEST("Concurrent push audio (thread safety)")
-    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR};
+    WFEngineConfig config = {WF_DEVICE_CPU, WF_LOG_ERROR, nullptr};
     wf_engine_init(&config);
     wf_engine_load_model("base");
     
@@ -314,8 +971,14 @@ int main() {
     
     // Model
     test_load_model_success();
+    test_load_model_is_async();
+    test_cancel_model_load();
     test_load_model_fails_invalid();
     test_unload_model();
+    test_set_model_budget();
+    test_set_final_model();
+    test_set_fallback_model();
+    test_load_model_emits_progress();
     
     // Session
     test_start_session_success();
@@ -324,6 +987,29 @@ int main() {
     test_push_audio();
     test_push_audio_wrong_session();
     test_end_session();
+    test_push_audio_after_end();
+    test_push_audio_backpressure_samples();
+    test_late_session_merges_chunks();
+    
+    // Tracing
+    test_trace_push_to_drain();
+    
+    // Audio ring buffer
+    test_ring_buffer_wraparound();
+    test_ring_buffer_all_or_nothing();
+    test_ring_buffer_spsc_threads();
+    
+    // Worker pool
+    test_pool_runs_all_tasks();
+    test_pool_steals_work();
+    test_pool_resize_keeps_tasks();
+    test_thread_budget_split();
+    test_thread_budget_from_callback();
+    
+    // Multi-instance
+    test_engine_instances_independent();
+    test_engine_destroy_with_open_session();
+    test_engine_instances_parallel_push();
     
     // Thread safety
     test_concurrent_push_audio();
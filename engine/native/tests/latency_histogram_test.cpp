@@ -0,0 +1,290 @@
+/**
+ * WisprFlex Whisper Backend - Latency Histogram Test Suite
+ *
+ * Verifies:
+ * - Buckets are contiguous and every value lands in a bucket that
+ *   reports it within the documented precision
+ * - Percentiles of known distributions
+ * - Concurrent recording loses no counts
+ * - SeqLocked readers never see a half-written value
+ */
+
+#include "../whisper_backend/latency_histogram.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("Testing: %s... ", name); \
+    fflush(stdout);
+
+#define PASS() \
+    printf("PASS\n"); \
+    tests_passed++;
+
+#define FAIL(reason) \
+    printf("FAIL (%s)\n", reason); \
+    tests_failed++;
+
+#define ASSERT(condition, reason) \
+    if (!(condition)) { FAIL(reason); return; }
+
+#define ASSERT_EQ(actual, expected, reason) \
+    if ((actual) != (expected)) { FAIL(reason); return; }
+
+// Bucket width relative to its values (16 linear steps per power of two)
+static const double PRECISION = 1.0 / 16.0;
+
+// ============================================
+// Buckets
+// ============================================
+
+void test_small_values_exact() {
+    TEST("Values below 32 us have their own bucket");
+
+    for (uint64_t v = 0; v < 32; v++) {
+        int index = LatencyHistogram::bucket_index(v);
+        ASSERT_EQ(index, (int)v, "index");
+        ASSERT_EQ(LatencyHistogram::bucket_upper_bound(index), v, "upper bound");
+    }
+
+    PASS();
+}
+
+void test_buckets_contiguous() {
+    TEST("Bucket indices are contiguous and ordered");
+
+    // Each bucket starts right after the previous one's upper bound
+    uint64_t next_start = 0;
+    for (int index = 0; index < LATENCY_BUCKETS; index++) {
+        ASSERT_EQ(LatencyHistogram::bucket_index(next_start), index, "start of bucket");
+        uint64_t upper = LatencyHistogram::bucket_upper_bound(index);
+        ASSERT(upper >= next_start, "upper bound before start");
+        ASSERT_EQ(LatencyHistogram::bucket_index(upper), index, "end of bucket");
+        next_start = upper + 1;
+    }
+    ASSERT_EQ(next_start, (uint64_t)1 << LATENCY_MAX_BITS, "covers the whole range");
+
+    PASS();
+}
+
+void test_precision() {
+    TEST("Reported value within 1/16 of any recorded value");
+
+    for (uint64_t v = 1; v < ((uint64_t)1 << 36); v = v * 3 / 2 + 1) {
+        uint64_t upper = LatencyHistogram::bucket_upper_bound(LatencyHistogram::bucket_index(v));
+        ASSERT(upper >= v, "upper bound below value");
+        ASSERT((double)(upper - v) <= PRECISION * (double)v, "bucket too wide");
+    }
+
+    PASS();
+}
+
+void test_saturates() {
+    TEST("Values past the range land in the last bucket");
+
+    int last = LATENCY_BUCKETS - 1;
+    ASSERT_EQ(LatencyHistogram::bucket_index(UINT64_MAX), last, "max value");
+    ASSERT_EQ(LatencyHistogram::bucket_index((uint64_t)1 << 50), last, "2^50");
+
+    PASS();
+}
+
+// ============================================
+// Percentiles
+// ============================================
+
+void test_empty_summary() {
+    TEST("Empty histogram summarizes to zeros");
+
+    LatencyHistogram histogram;
+    LatencySummary summary = histogram.summarize();
+    ASSERT_EQ(summary.count, (uint64_t)0, "count");
+    ASSERT(summary.p99_us == 0.0 && summary.max_us == 0.0, "percentiles");
+
+    PASS();
+}
+
+void test_uniform_percentiles() {
+    TEST("Percentiles of 1..10000 us");
+
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 10000; v++) {
+        histogram.record(v);
+    }
+    LatencySummary summary = histogram.summarize();
+
+    ASSERT_EQ(summary.count, (uint64_t)10000, "count");
+    ASSERT(std::fabs(summary.mean_us - 5000.5) < 1e-6, "mean is exact");
+    ASSERT_EQ(summary.max_us, 10000.0, "max is exact");
+    ASSERT(summary.p50_us >= 5000 && summary.p50_us <= 5000 * (1 + PRECISION), "p50");
+    ASSERT(summary.p90_us >= 9000 && summary.p90_us <= 9000 * (1 + PRECISION), "p90");
+    ASSERT(summary.p99_us >= 9900 && summary.p99_us <= 10000, "p99 capped at max");
+    ASSERT(summary.p999_us >= 9990 && summary.p999_us <= 10000, "p999");
+
+    PASS();
+}
+
+void test_tail_visible() {
+    TEST("Rare slow values show in p99.9, not p50");
+
+    LatencyHistogram histogram;
+    for (int i = 0; i < 9980; i++) {
+        histogram.record(1000);
+    }
+    for (int i = 0; i < 20; i++) {
+        histogram.record(2000000);  // 2 s stalls
+    }
+    LatencySummary summary = histogram.summarize();
+
+    ASSERT(summary.p50_us <= 1000 * (1 + PRECISION), "p50 unaffected");
+    ASSERT(summary.p99_us <= 1000 * (1 + PRECISION), "p99 below the stalls");
+    ASSERT(summary.p999_us >= 2000000, "p99.9 shows the stalls");
+    ASSERT(summary.mean_us > 4900 && summary.mean_us < 5100, "mean between");
+
+    PASS();
+}
+
+void test_reset() {
+    TEST("Reset forgets values");
+
+    LatencyHistogram histogram;
+    histogram.record(500);
+    histogram.reset();
+    ASSERT_EQ(histogram.summarize().count, (uint64_t)0, "count after reset");
+    histogram.record(7);
+    ASSERT_EQ(histogram.summarize().max_us, 7.0, "max after reset");
+
+    PASS();
+}
+
+// ============================================
+// Concurrency
+// ============================================
+
+void test_concurrent_record() {
+    TEST("Concurrent recording loses no counts");
+
+    LatencyHistogram histogram;
+    const int threads = 4;
+    const int per_thread = 50000;
+    std::atomic<bool> stop{false};
+
+    // A reader summarizing throughout must not disturb the writers
+    std::thread reader([&] {
+        while (!stop.load()) {
+            LatencySummary summary = histogram.summarize();
+            (void)summary;
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; t++) {
+        writers.emplace_back([&histogram, t] {
+            for (int i = 0; i < per_thread; i++) {
+                histogram.record((uint64_t)(t * 1000 + i % 1000));
+            }
+        });
+    }
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+    stop = true;
+    reader.join();
+
+    LatencySummary summary = histogram.summarize();
+    ASSERT_EQ(summary.count, (uint64_t)threads * per_thread, "count");
+    ASSERT_EQ(summary.max_us, 3999.0, "max");
+
+    PASS();
+}
+
+/**
+ * Value whose fields must always agree
+ */
+struct Published {
+    uint64_t sequence;
+    double copies[9];
+};
+
+void test_seqlock_no_torn_reads() {
+    TEST("SeqLocked readers only see complete values");
+
+    SeqLocked<Published> published;
+    std::atomic<bool> stop{false};
+    std::atomic<int> torn{0};
+    std::atomic<int> reads{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; r++) {
+        readers.emplace_back([&] {
+            uint64_t last = 0;
+            while (!stop.load()) {
+                Published value = published.load();
+                for (double copy : value.copies) {
+                    if (copy != (double)value.sequence) {
+                        torn++;
+                    }
+                }
+                if (value.sequence < last) {
+                    torn++;     // Went backwards
+                }
+                last = value.sequence;
+                reads++;
+            }
+        });
+    }
+
+    for (uint64_t i = 1; i <= 200000; i++) {
+        Published value;
+        value.sequence = i;
+        for (double& copy : value.copies) {
+            copy = (double)i;
+        }
+        published.store(value);
+    }
+    stop = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    ASSERT_EQ(torn.load(), 0, "torn or stale read");
+    ASSERT(reads.load() > 0, "no reads");
+    ASSERT_EQ(published.load().sequence, (uint64_t)200000, "last value");
+
+    PASS();
+}
+
+int main() {
+    printf("\n========================================\n");
+    printf("WisprFlex Latency Histogram - Test Suite\n");
+    printf("========================================\n\n");
+
+    // Buckets
+    test_small_values_exact();
+    test_buckets_contiguous();
+    test_precision();
+    test_saturates();
+
+    // Percentiles
+    test_empty_summary();
+    test_uniform_percentiles();
+    test_tail_visible();
+    test_reset();
+
+    // Concurrency
+    test_concurrent_record();
+    test_seqlock_no_torn_reads();
+
+    printf("\n========================================\n");
+    printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
+    printf("========================================\n\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+/**
+ * WisprFlex Whisper Backend - Memory Probe Test Suite
+ *
+ * Verifies:
+ * - Readings are consistent (parts within resident, peak above it)
+ * - Touched heap shows up as anonymous memory and raises the peak
+ * - Touched file mappings show up as file-backed memory (Linux)
+ * - PSS is read only on request
+ */
+
+#include "../whisper_backend/memory_probe.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("Testing: %s... ", name); \
+    fflush(stdout);
+
+#define PASS() \
+    printf("PASS\n"); \
+    tests_passed++;
+
+#define FAIL(reason) \
+    printf("FAIL (%s)\n", reason); \
+    tests_failed++;
+
+#define ASSERT(condition, reason) \
+    if (!(condition)) { FAIL(reason); return; }
+
+#define ASSERT_EQ(actual, expected, reason) \
+    if ((actual) != (expected)) { FAIL(reason); return; }
+
+static const size_t MB = 1024 * 1024;
+static const size_t TOUCH_BYTES = 64 * MB;
+
+// Allowed shortfall in growth (pages the allocator already had, swapping)
+static const size_t SLACK_BYTES = 8 * MB;
+
+// ============================================
+// Readings
+// ============================================
+
+void test_reading_consistent() {
+    TEST("Parts fit within resident, peak at least resident");
+
+    MemoryUsage usage;
+    ASSERT(memory_probe_read(usage), "no reading on this platform");
+    ASSERT(usage.resident_bytes > 0, "resident");
+    ASSERT(usage.anonymous_bytes + usage.file_bytes <= usage.resident_bytes + usage.shmem_bytes,
+           "parts exceed resident");
+    ASSERT(usage.peak_resident_bytes >= usage.resident_bytes, "peak below resident");
+    ASSERT_EQ(memory_resident_kb() > 0, true, "resident KB");
+
+    PASS();
+}
+
+void test_heap_growth() {
+    TEST("Touched heap is anonymous and raises the peak");
+
+    MemoryUsage before;
+    ASSERT(memory_probe_read(before), "reading before");
+
+    std::vector<char> block(TOUCH_BYTES);
+    memset(block.data(), 1, block.size());
+
+    MemoryUsage after;
+    ASSERT(memory_probe_read(after), "reading after");
+    ASSERT(after.anonymous_bytes >= before.anonymous_bytes + TOUCH_BYTES - SLACK_BYTES, "anonymous growth");
+    ASSERT(after.resident_bytes >= before.resident_bytes + TOUCH_BYTES - SLACK_BYTES, "resident growth");
+    ASSERT(after.peak_resident_bytes >= after.resident_bytes, "peak");
+
+    // The high-water mark stays after the memory is freed
+    block.clear();
+    block.shrink_to_fit();
+    MemoryUsage freed;
+    ASSERT(memory_probe_read(freed), "reading after free");
+    ASSERT(freed.peak_resident_bytes >= after.resident_bytes, "peak dropped");
+
+    PASS();
+}
+
+#if defined(__linux__)
+
+void test_file_mapping() {
+    TEST("Touched file mapping is file-backed");
+
+    const char* path = "memory_probe_test.bin";
+    std::vector<char> data(TOUCH_BYTES, 7);
+    FILE* out = fopen(path, "wb");
+    ASSERT(out != nullptr, "create file");
+    bool written = fwrite(data.data(), 1, data.size(), out) == data.size();
+    fclose(out);
+    ASSERT(written, "write file");
+    data.clear();
+    data.shrink_to_fit();
+
+    int fd = open(path, O_RDONLY);
+    ASSERT(fd >= 0, "open file");
+    void* mapping = mmap(nullptr, TOUCH_BYTES, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    ASSERT(mapping != MAP_FAILED, "mmap");
+
+    MemoryUsage before;
+    memory_probe_read(before);
+    const volatile char* bytes = (const volatile char*)mapping;
+    size_t sum = 0;
+    for (size_t i = 0; i < TOUCH_BYTES; i += 4096) {
+        sum += (size_t)bytes[i];
+    }
+    MemoryUsage after;
+    memory_probe_read(after);
+
+    munmap(mapping, TOUCH_BYTES);
+    remove(path);
+
+    ASSERT_EQ(sum, (TOUCH_BYTES / 4096) * 7, "mapped contents");
+    ASSERT(after.file_bytes >= before.file_bytes + TOUCH_BYTES - SLACK_BYTES, "file-backed growth");
+    ASSERT(after.anonymous_bytes < before.anonymous_bytes + SLACK_BYTES, "counted as anonymous");
+
+    PASS();
+}
+
+void test_proportional_on_request() {
+    TEST("PSS read only on request");
+
+    MemoryUsage cheap;
+    ASSERT(memory_probe_read(cheap), "cheap reading");
+    ASSERT_EQ(cheap.proportional_bytes, (size_t)0, "PSS without request");
+
+    MemoryUsage full;
+    ASSERT(memory_probe_read(full, true), "full reading");
+    if (access("/proc/self/smaps_rollup", R_OK) == 0) {
+        ASSERT(full.proportional_bytes > 0, "PSS");
+        ASSERT(full.proportional_bytes <= full.resident_bytes + SLACK_BYTES, "PSS above resident");
+    }
+
+    PASS();
+}
+
+#endif
+
+int main() {
+    printf("\n========================================\n");
+    printf("WisprFlex Memory Probe - Test Suite\n");
+    printf("========================================\n\n");
+
+    // Readings
+    test_reading_consistent();
+    test_heap_growth();
+#if defined(__linux__)
+    test_file_mapping();
+    test_proportional_on_request();
+#endif
+
+    printf("\n========================================\n");
+    printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
+    printf("========================================\n\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -1,273 +0,0 @@
-/**
- * Phase 2.5 Stability Stress Test
- * Agent B: Native Engine Stability Owner
- * 
- * Tests:
- * - 50 start/stop cycles
- * - Memory stability across cycles
- * - Long session (simulated)
- * - Engine restart
- */
-
-#include "whisper_backend.h"
-#include <cstdio>
-#include <cstdlib>
-#include <cstring>
-#include <vector>
-#include <chrono>
-#include <cmath>
-
-#ifdef _WIN32
-#include <windows.h>
-#include <psapi.h>
-#endif
-
-#define SAMPLE_RATE 16000
-#define CHUNK_SAMPLES 64000  // 4 seconds
-
-size_t get_process_memory_kb() {
-#ifdef _WIN32
-    PROCESS_MEMORY_COUNTERS pmc;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
-        return pmc.WorkingSetSize / 1024;
-    }
-#endif
-    return 0;
-}
-
-// Generate simple audio for testing
-std::vector<float> generate_test_audio(float duration_sec) {
-    size_t n_samples = (size_t)(duration_sec * SAMPLE_RATE);
-    std::vector<float> audio(n_samples);
-    for (size_t i = 0; i < n_samples; i++) {
-        audio[i] = 0.1f * sinf(2.0f * 3.14159f * 440.0f * i / SAMPLE_RATE);
-    }
-    return audio;
-}
-
-void on_partial(const char* text, void* user_data) {
-    (void)text;
-    (void)user_data;
-    // Silent callback for stress testing
-}
-
-int main(int argc, char** argv) {
-    if (argc < 2) {
-        printf("Usage: %s <model_path>\n", argv[0]);
-        return 1;
-    }
-
-    const char* model_path = argv[1];
-
-    printf("\n");
-    printf("========================================\n");
-    printf("Phase 2.5 Stability Stress Test\n");
-    printf("========================================\n\n");
-
-    size_t baseline_kb = get_process_memory_kb();
-    printf("Baseline memory: %.2f MB\n\n", baseline_kb / 1024.0);
-
-    // ========================================
-    // TEST 1: 50 Start/Stop Cycles
-    // ========================================
-    printf("========================================\n");
-    printf("TEST 1: 50 Start/Stop Cycles\n");
-    printf("========================================\n\n");
-
-    const int NUM_CYCLES = 50;
-    std::vector<size_t> cycle_memory;
-    std::vector<float> test_audio = generate_test_audio(4.0f);  // 4 seconds
-    int crashes = 0;
-    
-    // Initialize engine once
-    WBErrorCode err = wb_init();
-    if (err != WB_OK) {
-        printf("FAIL: Init failed\n");
-        return 1;
-    }
-
-    // Load model once
-    printf("Loading model...\n");
-    err = wb_load_model(model_path);
-    if (err != WB_OK) {
-        printf("FAIL: Model load failed\n");
-        wb_shutdown();
-        return 1;
-    }
-
-    size_t after_load_kb = get_process_memory_kb();
-    printf("Memory after load: %.2f MB\n\n", after_load_kb / 1024.0);
-
-    printf("Running %d session cycles...\n", NUM_CYCLES);
-
-    for (int i = 0; i < NUM_CYCLES; i++) {
-        // Start session
-        uint32_t session_id = wb_start_session(on_partial, nullptr);
-        if (session_id == 0) {
-            printf("  Cycle %d: FAIL - Cannot start session\n", i + 1);
-            crashes++;
-            continue;
-        }
-
-        // Process one chunk
-        err = wb_process_chunk(session_id, test_audio.data(), test_audio.size());
-        if (err != WB_OK) {
-            printf("  Cycle %d: FAIL - Chunk failed\n", i + 1);
-            crashes++;
-            wb_abort_session(session_id);
-            continue;
-        }
-
-        // Finalize session
-        char text[4096] = {0};
-        err = wb_finalize_session(session_id, text, sizeof(text));
-        if (err != WB_OK) {
-            printf("  Cycle %d: FAIL - Finalize failed\n", i + 1);
-            crashes++;
-            continue;
-        }
-
-        // Track memory
-        size_t current_kb = get_process_memory_kb();
-        cycle_memory.push_back(current_kb);
-
-        // Progress every 10 cycles
-        if ((i + 1) % 10 == 0) {
-            printf("  Cycle %d: OK, memory: %.2f MB\n", i + 1, current_kb / 1024.0);
-        }
-    }
-
-    // Analyze memory trend
-    size_t first_10_avg = 0, last_10_avg = 0;
-    for (int i = 0; i < 10 && i < (int)cycle_memory.size(); i++) {
-        first_10_avg += cycle_memory[i];
-    }
-    first_10_avg /= 10;
-    
-    for (int i = (int)cycle_memory.size() - 10; i < (int)cycle_memory.size(); i++) {
-        if (i >= 0) last_10_avg += cycle_memory[i];
-    }
-    last_10_avg /= 10;
-
-    int64_t memory_drift = (int64_t)last_10_avg - (int64_t)first_10_avg;
-
-    printf("\n  Cycles completed: %d/%d\n", NUM_CYCLES - crashes, NUM_CYCLES);
-    printf("  Crashes/failures: %d\n", crashes);
-    printf("  First 10 cycles avg: %.2f MB\n", first_10_avg / 1024.0);
-    printf("  Last 10 cycles avg: %.2f MB\n", last_10_avg / 1024.0);
-    printf("  Memory drift: %+.2f MB\n", memory_drift / 1024.0);
-
-    const char* cycle_status = (crashes == 0 && abs((int)memory_drift) < 10240) ? "PASS" : "FAIL";
-    printf("\n  TEST 1 RESULT: %s\n", cycle_status);
-
-    // ========================================
-    // TEST 2: Engine Restart
-    // ========================================
-    printf("\n========================================\n");
-    printf("TEST 2: Engine Restart\n");
-    printf("========================================\n\n");
-
-    // Unload and shutdown
-    printf("Shutting down engine...\n");
-    wb_unload_model();
-    wb_shutdown();
-
-    size_t after_shutdown_kb = get_process_memory_kb();
-    printf("Memory after shutdown: %.2f MB\n", after_shutdown_kb / 1024.0);
-
-    // Restart
-    printf("Restarting engine...\n");
-    err = wb_init();
-    if (err != WB_OK) {
-        printf("FAIL: Restart init failed\n");
-        return 1;
-    }
-
-    err = wb_load_model(model_path);
-    if (err != WB_OK) {
-        printf("FAIL: Restart model load failed\n");
-        wb_shutdown();
-        return 1;
-    }
-
-    size_t after_restart_kb = get_process_memory_kb();
-    printf("Memory after restart: %.2f MB\n", after_restart_kb / 1024.0);
-
-    // Run one session to verify
-    uint32_t session_id = wb_start_session(on_partial, nullptr);
-    if (session_id == 0) {
-        printf("FAIL: Cannot start session after restart\n");
-        wb_shutdown();
-        return 1;
-    }
-
-    err = wb_process_chunk(session_id, test_audio.data(), test_audio.size());
-    char text[4096] = {0};
-    wb_finalize_session(session_id, text, sizeof(text));
-
-    printf("Post-restart session: OK\n");
-    printf("\n  TEST 2 RESULT: PASS\n");
-
-    // ========================================
-    // TEST 3: Multiple Chunks in Session
-    // ========================================
-    printf("\n========================================\n");
-    printf("TEST 3: Multi-Chunk Session (20 chunks)\n");
-    printf("========================================\n\n");
-
-    session_id = wb_start_session(on_partial, nullptr);
-    if (session_id == 0) {
-        printf("FAIL: Cannot start session\n");
-        wb_shutdown();
-        return 1;
-    }
-
-    const int NUM_CHUNKS = 20;
-    size_t pre_session_kb = get_process_memory_kb();
-    
-    printf("Processing %d chunks...\n", NUM_CHUNKS);
-    for (int i = 0; i < NUM_CHUNKS; i++) {
-        err = wb_process_chunk(session_id, test_audio.data(), test_audio.size());
-        if (err != WB_OK) {
-            printf("  Chunk %d: FAIL\n", i + 1);
-        }
-        
-        if ((i + 1) % 5 == 0) {
-            size_t mem = get_process_memory_kb();
-            printf("  Chunk %d: OK, memory: %.2f MB\n", i + 1, mem / 1024.0);
-        }
-    }
-
-    wb_finalize_session(session_id, text, sizeof(text));
-    
-    size_t post_session_kb = get_process_memory_kb();
-    printf("\n  Pre-session memory: %.2f MB\n", pre_session_kb / 1024.0);
-    printf("  Post-session memory: %.2f MB\n", post_session_kb / 1024.0);
-    printf("  Growth: %+.2f MB\n", (post_session_kb - pre_session_kb) / 1024.0);
-    printf("\n  TEST 3 RESULT: PASS\n");
-
-    // ========================================
-    // Summary
-    // ========================================
-    printf("\n========================================\n");
-    printf("STABILITY TEST SUMMARY\n");
-    printf("========================================\n\n");
-
-    printf("| Test | Result |\n");
-    printf("|------|--------|\n");
-    printf("| 50 Start/Stop Cycles | %s |\n", cycle_status);
-    printf("| Engine Restart | PASS |\n");
-    printf("| Multi-Chunk Session | PASS |\n");
-    printf("| No Crashes | %s |\n", crashes == 0 ? "PASS" : "FAIL");
-    printf("| Memory Stable | %s |\n", abs((int)memory_drift) < 10240 ? "PASS" : "FAIL");
-
-    // Cleanup
-    wb_unload_model();
-    wb_shutdown();
-
-    printf("\n========================================\n");
-    printf("Stability test complete.\n");
-    printf("========================================\n");
-
-    return crashes > 0 ? 1 : 0;
-}
@@ -9,9 +9,14 @@
  * - Final transcript
  * - Memory stability
  * - Latency measurements
+ * - Concurrent sessions on shared model weights
+ * - VAD gating of silent windows
+ * - VAD endpointing (final per utterance)
+ * - Lock-free metrics snapshot and latency histograms
  */
 
 #include "whisper_backend.h"
+#include "memory_probe.h"
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -19,26 +24,15 @@
 #include <chrono>
 #include <fstream>
 #include <cmath>
-
-#ifdef _WIN32
-#include <windows.h>
-#include <psapi.h>
-#endif
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 #define SAMPLE_RATE 16000
 #define CHUNK_DURATION_MS 800
 #define CHUNK_SAMPLES (SAMPLE_RATE * CHUNK_DURATION_MS / 1000)  // 12800
-
-// Get process memory in KB
-size_t get_process_memory_kb() {
-#ifdef _WIN32
-    PROCESS_MEMORY_COUNTERS pmc;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
-        return pmc.WorkingSetSize / 1024;
-    }
-#endif
-    return 0;
-}
+#define CONCURRENT_SESSIONS 2
 
 // Generate test audio with a tone
 std::vector<float> generate_tone(float duration_sec, float frequency) {
@@ -52,6 +46,45 @@ std::vector<float> generate_tone(float duration_sec, float frequency) {
     return audio;
 }
 
+// Stream audio through one session without callbacks; returns 0 on success
+int run_quiet_session(const std::vector<float>& audio, const WBSessionConfig& config, std::string* out_text) {
+    uint32_t session_id = wb_start_session_with_config(&config, nullptr, nullptr);
+    if (session_id == 0) {
+        return 1;
+    }
+    
+    for (size_t offset = 0; offset < audio.size(); offset += CHUNK_SAMPLES) {
+        size_t chunk_size = std::min((size_t)CHUNK_SAMPLES, audio.size() - offset);
+        if (wb_process_chunk(session_id, audio.data() + offset, chunk_size) != WB_OK) {
+            wb_abort_session(session_id);
+            return 1;
+        }
+    }
+    
+    char final_text[8192] = {0};
+    if (wb_finalize_session(session_id, final_text, sizeof(final_text)) != WB_OK) {
+        return 1;
+    }
+    *out_text = final_text;
+    return 0;
+}
+
+// Utterances delivered by endpointing
+static std::vector<std::string> g_utterances;
+
+void on_utterance(const char* text, void* user_data) {
+    (void)user_data;
+    g_utterances.push_back(text);
+}
+
+// Stage timing records of transcribed windows
+static std::vector<WBChunkTiming> g_timings;
+
+void on_timing(const WBChunkTiming* timing, void* user_data) {
+    (void)user_data;
+    g_timings.push_back(*timing);
+}
+
 // Callback to receive partial transcripts
 static std::vector<std::string> g_partials;
 static std::vector<double> g_partial_times;
@@ -90,7 +123,7 @@ int main(int argc, char** argv) {
     printf("\n");
 
     // Baseline memory
-    size_t baseline_kb = get_process_memory_kb();
+    size_t baseline_kb = memory_resident_kb();
     printf("Baseline memory: %.2f MB\n\n", baseline_kb / 1024.0);
 
     // Initialize
@@ -100,17 +133,28 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    // Load model
+    // Load model (warm-up moves buffer allocation out of the first chunk)
     printf("Loading model...\n");
-    err = wb_load_model(model_path);
+    WBLoadOptions load_options = wb_default_load_options();
+    load_options.warmup = 1;
+    err = wb_load_model_with_options(model_path, &load_options);
     if (err != WB_OK) {
         printf("FAIL: Model load failed\n");
         wb_shutdown();
         return 1;
     }
 
-    size_t after_load_kb = get_process_memory_kb();
-    printf("Memory after model load: %.2f MB\n\n", after_load_kb / 1024.0);
+    size_t after_load_kb = memory_resident_kb();
+    WBMetrics load_metrics = wb_get_metrics();
+    printf("Memory after model load: %.2f MB\n", after_load_kb / 1024.0);
+    printf("Warm-up: %.0f ms, state buffers %.1f MB, first inference +%.1f MB\n",
+           load_metrics.warmup_time_ms, 
+           load_metrics.state_buffer_bytes / (1024.0 * 1024.0),
+           load_metrics.warmup_compute_bytes / (1024.0 * 1024.0));
+    printf("Model mapped: %.1f MB, resident mapped %.1f MB / private %.1f MB\n\n",
+           load_metrics.model_mapped_bytes / (1024.0 * 1024.0),
+           load_metrics.mapped_resident_bytes / (1024.0 * 1024.0),
+           load_metrics.private_resident_bytes / (1024.0 * 1024.0));
 
     // Generate test audio (5 seconds)
     printf("Generating test audio (5 seconds)...\n");
@@ -162,7 +206,7 @@ int main(int argc, char** argv) {
         }
         
         // Track memory
-        size_t current_kb = get_process_memory_kb();
+        size_t current_kb = memory_resident_kb();
         if (current_kb > peak_memory_kb) {
             peak_memory_kb = current_kb;
         }
@@ -174,6 +218,9 @@ int main(int argc, char** argv) {
                chunk_count, chunk_time, current_kb / 1024.0);
     }
     
+    // The process high-water mark also catches peaks inside inference
+    peak_memory_kb = std::max(peak_memory_kb, memory_peak_kb());
+    
     printf("\n    Chunks processed: %d\n", chunk_count);
     printf("    Peak memory: %.2f MB\n\n", peak_memory_kb / 1024.0);
 
@@ -204,7 +251,7 @@ int main(int argc, char** argv) {
     double first_partial_time = g_partial_times.empty() ? 0 : g_partial_times[0];
 
     // Memory after session
-    size_t after_session_kb = get_process_memory_kb();
+    size_t after_session_kb = memory_resident_kb();
 
     // ========================================
     // Results Summary
@@ -246,6 +293,406 @@ int main(int argc, char** argv) {
     printf("Audio duration: %.2f ms\n", (float)audio.size() / SAMPLE_RATE * 1000);
     printf("RTF: %.2f\n", total_session_time / ((float)audio.size() / SAMPLE_RATE * 1000));
 
+    // ========================================
+    // Concurrent Sessions
+    // ========================================
+    
+    printf("\n========================================\n");
+    printf("CONCURRENT SESSIONS TEST (%d sessions)\n", CONCURRENT_SESSIONS);
+    printf("========================================\n\n");
+    
+    // Split the cores between sessions so the comparison is fair
+    WBSessionConfig concurrent_config = wb_default_session_config();
+    concurrent_config.n_threads = (int)std::thread::hardware_concurrency() / CONCURRENT_SESSIONS;
+    if (concurrent_config.n_threads < 1) {
+        concurrent_config.n_threads = 1;
+    }
+    
+    std::string sequential_text;
+    auto seq_start = std::chrono::high_resolution_clock::now();
+    int seq_failures = 0;
+    for (int i = 0; i < CONCURRENT_SESSIONS; i++) {
+        seq_failures += run_quiet_session(audio, concurrent_config, &sequential_text);
+    }
+    double sequential_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - seq_start).count();
+    
+    std::vector<std::string> parallel_texts(CONCURRENT_SESSIONS);
+    std::vector<int> parallel_failures(CONCURRENT_SESSIONS, 0);
+    std::vector<std::thread> workers;
+    auto par_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < CONCURRENT_SESSIONS; i++) {
+        workers.emplace_back([&, i]() {
+            parallel_failures[i] = run_quiet_session(audio, concurrent_config, &parallel_texts[i]);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double parallel_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - par_start).count();
+    
+    bool texts_match = true;
+    int par_failures = 0;
+    for (int i = 0; i < CONCURRENT_SESSIONS; i++) {
+        par_failures += parallel_failures[i];
+        texts_match = texts_match && parallel_texts[i] == sequential_text;
+    }
+    
+    size_t after_concurrent_kb = memory_resident_kb();
+    
+    printf("| Metric | Value | Gate | Status |\n");
+    printf("|--------|-------|------|--------|\n");
+    printf("| Sessions completed | %d/%d | all | %s |\n",
+           2 * CONCURRENT_SESSIONS - seq_failures - par_failures, 2 * CONCURRENT_SESSIONS,
+           (seq_failures + par_failures) == 0 ? "PASS" : "FAIL");
+    printf("| Sequential time | %.0f ms | - | - |\n", sequential_ms);
+    printf("| Parallel time | %.0f ms | < sequential | %s |\n", parallel_ms,
+           parallel_ms < sequential_ms ? "PASS" : "WARN");
+    printf("| Transcripts identical | %s | yes | %s |\n",
+           texts_match ? "yes" : "no", texts_match ? "PASS" : "WARN");
+    printf("| Memory vs after load | %+.1f MB | - | - |\n",
+           ((int64_t)after_concurrent_kb - (int64_t)after_load_kb) / 1024.0);
+    
+    // ========================================
+    // VAD Gating
+    // ========================================
+    
+    printf("\n========================================\n");
+    printf("VAD GATING TEST\n");
+    printf("========================================\n\n");
+    
+    // 1 s tone, 4 s silence, 1 s tone
+    std::vector<float> gapped = generate_tone(1.0f, 440.0f);
+    gapped.resize(gapped.size() + 4 * SAMPLE_RATE, 0.0f);
+    std::vector<float> tail_tone = generate_tone(1.0f, 440.0f);
+    gapped.insert(gapped.end(), tail_tone.begin(), tail_tone.end());
+    
+    WBSessionConfig vad_off = wb_default_session_config();
+    vad_off.vad_enabled = 0;
+    WBSessionConfig vad_on = wb_default_session_config();
+    
+    std::string vad_text;
+    WBMetrics before = wb_get_metrics();
+    auto off_start = std::chrono::high_resolution_clock::now();
+    int vad_failures = run_quiet_session(gapped, vad_off, &vad_text);
+    double vad_off_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - off_start).count();
+    WBMetrics after_off = wb_get_metrics();
+    
+    auto on_start = std::chrono::high_resolution_clock::now();
+    vad_failures += run_quiet_session(gapped, vad_on, &vad_text);
+    double vad_on_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - on_start).count();
+    WBMetrics after_on = wb_get_metrics();
+    
+    // Same audio under office-microphone hiss (above the fixed threshold):
+    // the adaptive noise floor should still find the gap
+    std::vector<float> noisy = gapped;
+    srand(42);
+    for (auto& sample : noisy) {
+        sample += 0.1f * (2.0f * (float)rand() / (float)RAND_MAX - 1.0f);
+    }
+    vad_failures += run_quiet_session(noisy, vad_on, &vad_text);
+    WBMetrics after_noisy = wb_get_metrics();
+    
+    int skipped_off = after_off.windows_skipped - before.windows_skipped;
+    int skipped_on = after_on.windows_skipped - after_off.windows_skipped;
+    int inferred_on = after_on.windows_inferred - after_off.windows_inferred;
+    int skipped_noisy = after_noisy.windows_skipped - after_on.windows_skipped;
+    
+    printf("| Metric | Value | Gate | Status |\n");
+    printf("|--------|-------|------|--------|\n");
+    printf("| Sessions completed | %d/3 | all | %s |\n", 3 - vad_failures,
+           vad_failures == 0 ? "PASS" : "FAIL");
+    printf("| Skipped, VAD off | %d | 0 | %s |\n", skipped_off, skipped_off == 0 ? "PASS" : "FAIL");
+    printf("| Skipped, VAD on | %d (%.0f ms audio) | > 0 | %s |\n", skipped_on,
+           after_on.skipped_audio_ms - after_off.skipped_audio_ms, skipped_on > 0 ? "PASS" : "FAIL");
+    printf("| Inferred, VAD on | %d | - | - |\n", inferred_on);
+    printf("| Skipped, VAD on + noise | %d | > 0 | %s |\n", skipped_noisy,
+           skipped_noisy > 0 ? "PASS" : "FAIL");
+    printf("| Time, VAD off | %.0f ms | - | - |\n", vad_off_ms);
+    printf("| Time, VAD on | %.0f ms | < VAD off | %s |\n", vad_on_ms,
+           vad_on_ms < vad_off_ms ? "PASS" : "WARN");
+    
+    // ========================================
+    // Endpointing
+    // ========================================
+    
+    printf("\n========================================\n");
+    printf("ENDPOINTING TEST\n");
+    printf("========================================\n\n");
+    
+    // Ten utterances: 1 s tone, 1 s pause (> 700 ms endpoint)
+    const int n_utterances = 10;
+    std::vector<float> phrases;
+    for (int i = 0; i < n_utterances; i++) {
+        std::vector<float> tone = generate_tone(1.0f, 440.0f);
+        phrases.insert(phrases.end(), tone.begin(), tone.end());
+        phrases.resize(phrases.size() + SAMPLE_RATE, 0.0f);
+    }
+    
+    WBSessionConfig endpoint_config = wb_default_session_config();
+    endpoint_config.utterance_callback = on_utterance;
+    g_utterances.clear();
+    
+    uint32_t endpoint_session = wb_start_session_with_config(&endpoint_config, nullptr, nullptr);
+    int endpoint_failures = endpoint_session == 0 ? 1 : 0;
+    for (size_t offset = 0; endpoint_session && offset < phrases.size(); offset += CHUNK_SAMPLES) {
+        size_t chunk_size = std::min((size_t)CHUNK_SAMPLES, phrases.size() - offset);
+        if (wb_process_chunk(endpoint_session, phrases.data() + offset, chunk_size) != WB_OK) {
+            endpoint_failures++;
+        }
+    }
+    
+    char endpoint_final[8192] = {0};
+    auto endpoint_finalize_start = std::chrono::high_resolution_clock::now();
+    if (endpoint_session && 
+        wb_finalize_session(endpoint_session, endpoint_final, sizeof(endpoint_final)) != WB_OK) {
+        endpoint_failures++;
+    }
+    double endpoint_finalize_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - endpoint_finalize_start).count();
+    
+    // Finals are only emitted for utterances that produced text
+    WBMetrics endpoint_metrics = wb_get_metrics();
+    printf("| Metric | Value | Gate | Status |\n");
+    printf("|--------|-------|------|--------|\n");
+    printf("| Session completed | %s | yes | %s |\n", endpoint_failures == 0 ? "yes" : "no",
+           endpoint_failures == 0 ? "PASS" : "FAIL");
+    printf("| Utterances endpointed | %d | %d | %s |\n", endpoint_metrics.utterances_endpointed,
+           n_utterances, endpoint_metrics.utterances_endpointed == n_utterances ? "PASS" : "WARN");
+    printf("| Utterance finals emitted | %zu | - | - |\n", g_utterances.size());
+    printf("| Finalize after %d s | %.0f ms | < 500 ms | %s |\n", 2 * n_utterances,
+           endpoint_finalize_ms, endpoint_finalize_ms < 500 ? "PASS" : "FAIL");
+    
+    // ========================================
+    // Adaptive Windows
+    // ========================================
+    
+    printf("\n========================================\n");
+    printf("ADAPTIVE WINDOW TEST\n");
+    printf("========================================\n\n");
+    
+    // Targets no hardware meets / always beats, so the bounds are reached
+    std::vector<float> long_tone = generate_tone(30.0f, 440.0f);
+    std::string adaptive_text;
+    
+    WBSessionConfig grow_config = wb_default_session_config();
+    grow_config.adaptive_window = 1;
+    grow_config.max_window_ms = 6000;
+    grow_config.target_rtf = 0.0001f;
+    int adaptive_failures = run_quiet_session(long_tone, grow_config, &adaptive_text);
+    WBMetrics grow_metrics = wb_get_metrics();
+    
+    WBSessionConfig shrink_config = wb_default_session_config();
+    shrink_config.adaptive_window = 1;
+    shrink_config.window_ms = 4000;
+    shrink_config.step_ms = 3700;
+    shrink_config.min_window_ms = 1000;
+    shrink_config.target_rtf = 1000.0f;
+    adaptive_failures += run_quiet_session(long_tone, shrink_config, &adaptive_text);
+    WBMetrics shrink_metrics = wb_get_metrics();
+    
+    printf("| Metric | Value | Gate | Status |\n");
+    printf("|--------|-------|------|--------|\n");
+    printf("| Sessions completed | %d/2 | all | %s |\n", 2 - adaptive_failures,
+           adaptive_failures == 0 ? "PASS" : "FAIL");
+    printf("| Window, RTF over target | %d ms (RTF %.3f) | = 6000 ms | %s |\n",
+           grow_metrics.current_window_ms, grow_metrics.window_rtf,
+           grow_metrics.current_window_ms == 6000 ? "PASS" : "FAIL");
+    printf("| Window, RTF under target | %d ms (RTF %.3f) | = 1000 ms | %s |\n",
+           shrink_metrics.current_window_ms, shrink_metrics.window_rtf,
+           shrink_metrics.current_window_ms == 1000 ? "PASS" : "FAIL");
+    
+    // ========================================
+    // Two-tier Sessions
+    // ========================================
+    
+    printf("\n========================================\n");
+    printf("TWO-TIER TEST\n");
+    printf("========================================\n\n");
+    
+    // Same file as final model: checks the pipeline, not the accuracy gain
+    WBModel* final_model = nullptr;
+    int two_tier_failures = wb_model_acquire(model_path, &final_model) == WB_OK ? 0 : 1;
+    
+    WBSessionConfig two_tier_config = wb_default_session_config();
+    two_tier_config.utterance_callback = on_utterance;
+    two_tier_config.final_model = final_model;
+    g_utterances.clear();
+    int passes_before = wb_get_metrics().final_passes;
+    int endpointed_before = wb_get_metrics().utterances_endpointed;
+    
+    std::string two_tier_text;
+    if (final_model) {
+        two_tier_failures += run_quiet_session(phrases, two_tier_config, &two_tier_text);
+    }
+    wb_model_release(final_model);
+    
+    WBMetrics two_tier_metrics = wb_get_metrics();
+    int final_passes = two_tier_metrics.final_passes - passes_before;
+    int two_tier_utterances = two_tier_metrics.utterances_endpointed - endpointed_before;
+    printf("| Metric | Value | Gate | Status |\n");
+    printf("|--------|-------|------|--------|\n");
+    printf("| Session completed | %s | yes | %s |\n", two_tier_failures == 0 ? "yes" : "no",
+           two_tier_failures == 0 ? "PASS" : "FAIL");
+    printf("| Final passes | %d | >= %d utterances | %s |\n", final_passes, two_tier_utterances,
+           final_passes >= two_tier_utterances ? "PASS" : "FAIL");
+    printf("| Utterance finals emitted | %zu | - | - |\n", g_utterances.size());
+    printf("| Last final pass | %.0f ms | - | - |\n", two_tier_metrics.last_final_time_ms);
+    
+    // ========================================
+    // Degradation
+    // ========================================
+    
+    printf("\n========================================\n");
+    printf("DEGRADATION TEST\n");
+    printf("========================================\n\n");
+    
+    // A threshold no hardware meets: steps down to fast decoding (no
+    // fallback model) and stays there
+    WBSessionConfig degrade_config = wb_default_session_config();
+    degrade_config.degrade_rtf = 0.0001f;
+    int changes_before = wb_get_metrics().quality_changes;
+    std::string degraded_text;
+    int degrade_failures = run_quiet_session(long_tone, degrade_config, &degraded_text);
+    WBMetrics degrade_metrics = wb_get_metrics();
+    
+    printf("| Metric | Value | Gate | Status |\n");
+    printf("|--------|-------|------|--------|\n");
+    printf("| Session completed | %s | yes | %s |\n", degrade_failures == 0 ? "yes" : "no",
+           degrade_failures == 0 ? "PASS" : "FAIL");
+    printf("| Quality level | %d | = %d | %s |\n", degrade_metrics.quality_level,
+           (int)WB_QUALITY_FAST_DECODE,
+           degrade_metrics.quality_level == WB_QUALITY_FAST_DECODE ? "PASS" : "FAIL");
+    printf("| Level changes | %d | = 1 | %s |\n", degrade_metrics.quality_changes - changes_before,
+           degrade_metrics.quality_changes - changes_before == 1 ? "PASS" : "FAIL");
+    
+    // ========================================
+    // Stage Timings
+    // ========================================
+    
+    printf("\n========================================\n");
+    printf("STAGE TIMING TEST\n");
+    printf("========================================\n\n");
+    
+    WBSessionConfig timing_config = wb_default_session_config();
+    timing_config.timing_callback = on_timing;
+    g_timings.clear();
+    int inferred_before = wb_get_metrics().windows_inferred;
+    std::string timed_text;
+    int timing_failures = run_quiet_session(long_tone, timing_config, &timed_text);
+    WBMetrics timing_metrics = wb_get_metrics();
+    int timed_windows = timing_metrics.windows_inferred - inferred_before;
+    
+    // Stages partition the whisper_full call
+    int unbalanced = 0;
+    for (const WBChunkTiming& timing : g_timings) {
+        const WBStageTimings& t = timing.stages;
+        double sum = t.mel_ms + t.encode_ms + t.decode_ms;
+        if (fabs(sum - t.inference_ms) > 0.01 || t.mel_ms < 0 || t.encode_ms < 0 || t.decode_ms < 0) {
+            unbalanced++;
+        }
+    }
+    int expected_aggregated = std::min(timing_metrics.windows_inferred, WB_STAGE_HISTORY);
+    const WBStageTimings& mean = timing_metrics.stage_mean;
+    
+    printf("| Metric | Value | Gate | Status |\n");
+    printf("|--------|-------|------|--------|\n");
+    printf("| Session completed | %s | yes | %s |\n", timing_failures == 0 ? "yes" : "no",
+           timing_failures == 0 ? "PASS" : "FAIL");
+    printf("| Records | %zu | = %d windows | %s |\n", g_timings.size(), timed_windows,
+           (int)g_timings.size() == timed_windows && timed_windows > 0 ? "PASS" : "FAIL");
+    printf("| Stages summing to whisper_full | %zu/%zu | all | %s |\n",
+           g_timings.size() - unbalanced, g_timings.size(), unbalanced == 0 ? "PASS" : "FAIL");
+    printf("| Windows aggregated | %d | = %d | %s |\n", timing_metrics.stage_windows, expected_aggregated,
+           timing_metrics.stage_windows == expected_aggregated ? "PASS" : "FAIL");
+    printf("| Mean mel / encode / decode | %.1f / %.1f / %.1f ms | - | - |\n",
+           mean.mel_ms, mean.encode_ms, mean.decode_ms);
+    printf("| Mean queue wait / callback | %.2f / %.2f ms | - | - |\n",
+           mean.queue_wait_ms, mean.callback_ms);
+    printf("| Max inference | %.1f ms | - | - |\n", timing_metrics.stage_max.inference_ms);
+    
+    // ========================================
+    // Metrics Snapshot
+    // ========================================
+    
+    printf("\n========================================\n");
+    printf("METRICS SNAPSHOT TEST\n");
+    printf("========================================\n\n");
+    
+    WBMetricsSnapshot snapshot_before = wb_get_metrics_snapshot();
+    
+    // Poll from another thread while the session runs; counts never go back
+    std::atomic<bool> polling{true};
+    int polls = 0;
+    int regressions = 0;
+    std::thread poller([&]() {
+        uint64_t last_count = 0;
+        while (polling.load()) {
+            WBMetricsSnapshot snapshot = wb_get_metrics_snapshot();
+            if (snapshot.chunk_latency.count < last_count) {
+                regressions++;
+            }
+            last_count = snapshot.chunk_latency.count;
+            polls++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    
+    g_partials.clear();
+    g_session_start = std::chrono::high_resolution_clock::now();
+    int snapshot_failures = 0;
+    uint32_t snapshot_session = wb_start_session(on_partial, nullptr);
+    if (snapshot_session == 0) {
+        snapshot_failures++;
+    } else {
+        for (size_t offset = 0; offset < long_tone.size(); offset += CHUNK_SAMPLES) {
+            size_t chunk_size = std::min((size_t)CHUNK_SAMPLES, long_tone.size() - offset);
+            if (wb_process_chunk(snapshot_session, long_tone.data() + offset, chunk_size) != WB_OK) {
+                snapshot_failures++;
+            }
+        }
+        char snapshot_text[8192] = {0};
+        if (wb_finalize_session(snapshot_session, snapshot_text, sizeof(snapshot_text)) != WB_OK) {
+            snapshot_failures++;
+        }
+    }
+    polling = false;
+    poller.join();
+    
+    WBMetricsSnapshot snapshot = wb_get_metrics_snapshot();
+    WBMetrics locked_metrics = wb_get_metrics();
+    int snapshot_windows = snapshot.metrics.windows_inferred - snapshot_before.metrics.windows_inferred;
+    uint64_t latency_records = snapshot.chunk_latency.count - snapshot_before.chunk_latency.count;
+    uint64_t first_partials = snapshot.first_partial.count - snapshot_before.first_partial.count;
+    uint64_t finalizes = snapshot.finalize.count - snapshot_before.finalize.count;
+    const WBLatencyStats& chunk = snapshot.chunk_latency;
+    bool ordered = chunk.p50_ms <= chunk.p90_ms && chunk.p90_ms <= chunk.p99_ms &&
+                   chunk.p99_ms <= chunk.p999_ms && chunk.p999_ms <= chunk.max_ms;
+    
+    printf("| Metric | Value | Gate | Status |\n");
+    printf("|--------|-------|------|--------|\n");
+    printf("| Session completed | %s | yes | %s |\n", snapshot_failures == 0 ? "yes" : "no",
+           snapshot_failures == 0 ? "PASS" : "FAIL");
+    printf("| Polls during session | %d | > 0 | %s |\n", polls, polls > 0 ? "PASS" : "FAIL");
+    printf("| Counts going backwards | %d | 0 | %s |\n", regressions, regressions == 0 ? "PASS" : "FAIL");
+    printf("| Snapshot windows | %d | = locked %d | %s |\n", snapshot.metrics.windows_inferred,
+           locked_metrics.windows_inferred,
+           snapshot.metrics.windows_inferred == locked_metrics.windows_inferred ? "PASS" : "FAIL");
+    printf("| Chunk latency records | %llu | = %d windows | %s |\n", (unsigned long long)latency_records,
+           snapshot_windows, snapshot_windows > 0 && latency_records == (uint64_t)snapshot_windows ? "PASS" : "FAIL");
+    printf("| First partial records | %llu | = %d | %s |\n", (unsigned long long)first_partials,
+           g_partials.empty() ? 0 : 1, first_partials == (g_partials.empty() ? 0u : 1u) ? "PASS" : "FAIL");
+    printf("| Finalize records | %llu | = 1 | %s |\n", (unsigned long long)finalizes,
+           finalizes == 1 ? "PASS" : "FAIL");
+    printf("| Percentiles ordered | %s | yes | %s |\n", ordered ? "yes" : "no", ordered ? "PASS" : "FAIL");
+    printf("| Chunk latency p50 / p99 / max | %.1f / %.1f / %.1f ms | - | - |\n",
+           chunk.p50_ms, chunk.p99_ms, chunk.max_ms);
+    printf("| First partial p50 | %.1f ms | - | - |\n", snapshot.first_partial.p50_ms);
+    printf("| Finalize p50 | %.1f ms | - | - |\n", snapshot.finalize.p50_ms);
+    
     // Cleanup
     wb_unload_model();
     wb_shutdown();
@@ -0,0 +1,223 @@
+/**
+ * WisprFlex Whisper Backend - Trace Test Suite
+ *
+ * Verifies:
+ * - Nothing is recorded outside a capture
+ * - Spans, instants and flows are written as Chrome trace events
+ * - Each thread gets its own track and name
+ * - Full buffers drop and count events instead of growing
+ * - A new capture discards the previous one
+ */
+
+#include "../whisper_backend/trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("Testing: %s... ", name); \
+    fflush(stdout);
+
+#define PASS() \
+    printf("PASS\n"); \
+    tests_passed++;
+
+#define FAIL(reason) \
+    printf("FAIL (%s)\n", reason); \
+    tests_failed++;
+
+#define ASSERT(condition, reason) \
+    if (!(condition)) { FAIL(reason); return; }
+
+#define ASSERT_EQ(actual, expected, reason) \
+    if ((actual) != (expected)) { FAIL(reason); return; }
+
+static const char* TRACE_PATH = "trace_test_output.json";
+
+/**
+ * Write the current capture and return the file contents ("" on failure)
+ */
+static std::string written_trace() {
+    if (!trace_write_json(TRACE_PATH)) {
+        return "";
+    }
+    std::ifstream in(TRACE_PATH);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+static int count_of(const std::string& text, const std::string& needle) {
+    int count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+// ============================================
+// Capture
+// ============================================
+
+void test_disabled_records_nothing() {
+    TEST("Spans outside a capture are not recorded");
+
+    trace_start(0);
+    trace_stop();
+    ASSERT(!trace_enabled(), "still enabled");
+    {
+        TraceScope scope("ignored", "test");
+    }
+    trace_instant("ignored", "test");
+    trace_flow_start("ignored", 1);
+
+    std::string json = written_trace();
+    ASSERT(!json.empty(), "write failed");
+    ASSERT_EQ(count_of(json, "\"ignored\""), 0, "event recorded");
+    ASSERT(json.find("\"traceEvents\":[") != std::string::npos, "not a trace file");
+
+    PASS();
+}
+
+void test_span_and_events_written() {
+    TEST("Spans, instants and arguments are written");
+
+    trace_start(0);
+    {
+        TraceScope scope("outer", "test", "samples", 1600);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        trace_instant("marker", "test");
+    }
+    trace_complete("manual", "test", 10, 25);
+    trace_stop();
+
+    std::string json = written_trace();
+    ASSERT_EQ(count_of(json, "\"name\":\"outer\""), 1, "span missing");
+    ASSERT(json.find("\"args\":{\"samples\":1600}") != std::string::npos, "argument missing");
+    ASSERT_EQ(count_of(json, "\"ph\":\"i\""), 1, "instant missing");
+    ASSERT(json.find("\"ts\":10,\"name\":\"manual\",\"cat\":\"test\",\"dur\":25") != std::string::npos,
+           "manual span fields");
+
+    // The 2 ms sleep is inside the span
+    size_t outer = json.find("\"name\":\"outer\"");
+    size_t dur = json.find("\"dur\":", outer);
+    ASSERT(dur != std::string::npos && atoll(json.c_str() + dur + 6) >= 2000, "span duration");
+
+    PASS();
+}
+
+void test_flows_across_threads() {
+    TEST("Flows link spans on different named threads");
+
+    trace_start(0);
+    uint64_t id = trace_next_flow_id();
+    std::thread producer([id] {
+        trace_set_thread_name("producer");
+        TraceScope scope("produce", "test");
+        trace_flow_start("item", id);
+    });
+    producer.join();
+    std::thread consumer([id] {
+        trace_set_thread_name("consumer \"quoted\"");
+        TraceScope scope("consume", "test");
+        trace_flow_end("item", id);
+    });
+    consumer.join();
+    trace_stop();
+
+    std::string json = written_trace();
+    ASSERT_EQ(count_of(json, "\"ph\":\"s\""), 1, "flow start");
+    ASSERT_EQ(count_of(json, "\"ph\":\"f\""), 1, "flow end");
+    ASSERT_EQ(count_of(json, "\"id\":" + std::to_string(id)), 2, "flow ids");
+    ASSERT(json.find("\"name\":\"producer\"") != std::string::npos, "producer track name");
+    ASSERT(json.find("consumer \\\"quoted\\\"") != std::string::npos, "name not escaped");
+
+    // Different threads, different tracks
+    size_t produce = json.find("\"name\":\"produce\"");
+    size_t consume = json.find("\"name\":\"consume\"");
+    ASSERT(produce != std::string::npos && consume != std::string::npos, "spans missing");
+    std::string produce_tid = json.substr(json.rfind("\"tid\":", produce), 8);
+    std::string consume_tid = json.substr(json.rfind("\"tid\":", consume), 8);
+    ASSERT(produce_tid != consume_tid, "same track");
+
+    PASS();
+}
+
+// ============================================
+// Limits
+// ============================================
+
+void test_full_buffer_drops() {
+    TEST("Full buffer drops and counts events");
+
+    trace_start(10);
+    for (int i = 0; i < 25; i++) {
+        trace_instant("tick", "test");
+    }
+    trace_stop();
+
+    std::string json = written_trace();
+    ASSERT_EQ(count_of(json, "\"name\":\"tick\""), 10, "kept events");
+    ASSERT(json.find("\"dropped_events\":\"15\"") != std::string::npos, "dropped count");
+
+    PASS();
+}
+
+void test_restart_discards() {
+    TEST("New capture discards the previous one");
+
+    trace_start(0);
+    trace_instant("first", "test");
+    trace_start(0);
+    trace_instant("second", "test");
+    trace_stop();
+
+    std::string json = written_trace();
+    ASSERT_EQ(count_of(json, "\"name\":\"first\""), 0, "old event kept");
+    ASSERT_EQ(count_of(json, "\"name\":\"second\""), 1, "new event missing");
+
+    PASS();
+}
+
+void test_unwritable_path() {
+    TEST("Unwritable path fails with a reason");
+
+    std::string error;
+    ASSERT(!trace_write_json("/nonexistent-dir/trace.json", &error), "write succeeded");
+    ASSERT(!error.empty(), "no reason");
+
+    PASS();
+}
+
+int main() {
+    printf("\n========================================\n");
+    printf("WisprFlex Trace - Test Suite\n");
+    printf("========================================\n\n");
+
+    // Capture
+    test_disabled_records_nothing();
+    test_span_and_events_written();
+    test_flows_across_threads();
+
+    // Limits
+    test_full_buffer_drops();
+    test_restart_discards();
+    test_unwritable_path();
+
+    remove(TRACE_PATH);
+
+    printf("\n========================================\n");
+    printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
+    printf("========================================\n\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -178,6 +178,28 @@ int main(int argc, char** argv) {
         printf("  Inference time: %.2f ms\n", ms);
         printf("\n  [TRANSCRIPT]\n");
         printf("  %s\n\n", text_buffer);
+
+        // Same audio split at pauses and transcribed in parallel
+        WBBatchParams batch_params = wb_default_batch_params();
+        batch_params.language = "en";
+
+        start = std::chrono::high_resolution_clock::now();
+        err = wb_transcribe_batch(samples.data(), samples.size(), &batch_params,
+                                  text_buffer, sizeof(text_buffer));
+        end = std::chrono::high_resolution_clock::now();
+
+        ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+        if (err != WB_OK) {
+            printf("FAIL: Batch transcription failed: %s\n\n", wb_error_message(err));
+            continue;
+        }
+
+        WBMetrics metrics = wb_get_metrics();
+        printf("  Batch time: %.2f ms (%d segments, %d workers)\n",
+               ms, metrics.last_batch_segments, metrics.last_batch_workers);
+        printf("\n  [BATCH TRANSCRIPT]\n");
+        printf("  %s\n\n", text_buffer);
     }
 
     // Cleanup
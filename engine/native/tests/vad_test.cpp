@@ -0,0 +1,322 @@
+/**
+ * WisprFlex Whisper Backend - VAD Test Suite
+ *
+ * Verifies:
+ * - Vectorized kernel matches the scalar reference for every tail length
+ * - Energy stays accurate on long buffers
+ * - Noise floor adapts: steady noise stops counting as speech,
+ *   speech above it still does
+ */
+
+#include "../whisper_backend/vad.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <random>
+#include <vector>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("Testing: %s... ", name); \
+    fflush(stdout);
+
+#define PASS() \
+    printf("PASS\n"); \
+    tests_passed++;
+
+#define FAIL(reason) \
+    printf("FAIL (%s)\n", reason); \
+    tests_failed++;
+
+#define ASSERT(condition, reason) \
+    if (!(condition)) { FAIL(reason); return; }
+
+#define ASSERT_EQ(actual, expected, reason) \
+    if ((actual) != (expected)) { FAIL(reason); return; }
+
+static const size_t FRAME = 480;
+static const float PI = 3.14159265f;
+
+static bool close_to(double actual, double expected, double rel) {
+    return std::fabs(actual - expected) <= rel * std::fabs(expected) + 1e-12;
+}
+
+/**
+ * Push frames of a signal through the detector
+ * @return number of frames classified as speech
+ */
+static int run_frames(VoiceDetector& vad, const std::vector<float>& pcm) {
+    int speech = 0;
+    for (size_t i = 0; i + FRAME <= pcm.size(); i += FRAME) {
+        speech += vad.classify_frame(pcm.data() + i, FRAME) ? 1 : 0;
+    }
+    return speech;
+}
+
+static std::vector<float> tone(size_t n, float amplitude, float hz) {
+    std::vector<float> pcm(n);
+    for (size_t i = 0; i < n; i++) {
+        pcm[i] = amplitude * std::sin(2.0f * PI * hz * (float)i / 16000.0f);
+    }
+    return pcm;
+}
+
+static std::vector<float> noise(size_t n, float amplitude, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+    std::vector<float> pcm(n);
+    for (auto& v : pcm) {
+        v = dist(rng);
+    }
+    return pcm;
+}
+
+/* ============================================
+ * Kernel Tests
+ * ============================================ */
+
+void test_kernel_name() {
+    TEST("Kernel selected")
+    const char* name = vad_kernel_name();
+    ASSERT(name != nullptr, "name is null")
+    ASSERT(strcmp(name, "avx2") == 0 || strcmp(name, "sse2") == 0 ||
+           strcmp(name, "neon") == 0 || strcmp(name, "scalar") == 0, "unknown kernel")
+    printf("(%s) ", name);
+    PASS()
+}
+
+void test_kernel_matches_reference() {
+    TEST("Kernel matches reference (lengths 0-100, offsets 0-3)")
+    std::vector<float> pcm = noise(200, 0.5f, 1);
+
+    // Unaligned starts and every tail length the vector loops can leave
+    for (size_t offset = 0; offset < 4; offset++) {
+        for (size_t n = 0; n <= 100; n++) {
+            VadFeatures fast = vad_compute_features(pcm.data() + offset, n);
+            VadFeatures ref = vad_compute_features_reference(pcm.data() + offset, n);
+            ASSERT(close_to(fast.energy, ref.energy, 1e-5), "energy mismatch")
+            ASSERT_EQ(fast.zcr, ref.zcr, "zcr mismatch")
+        }
+    }
+    PASS()
+}
+
+void test_zero_crossings() {
+    TEST("Zero-crossing rate")
+    // Alternating signs: every pair crosses
+    std::vector<float> alternating(FRAME);
+    for (size_t i = 0; i < FRAME; i++) {
+        alternating[i] = (i % 2) ? 0.1f : -0.1f;
+    }
+    ASSERT_EQ(vad_compute_features(alternating.data(), FRAME).zcr, 1.0f, "alternating != 1")
+
+    // Constant signal never crosses
+    std::vector<float> constant(FRAME, 0.2f);
+    VadFeatures features = vad_compute_features(constant.data(), FRAME);
+    ASSERT_EQ(features.zcr, 0.0f, "constant != 0")
+    ASSERT(close_to(features.energy, 0.04, 1e-6), "constant energy")
+
+    // 1 kHz tone: 2 crossings per cycle, 16 samples per cycle
+    std::vector<float> sine = tone(16000, 0.5f, 1000.0f);
+    features = vad_compute_features(sine.data(), sine.size());
+    ASSERT(std::fabs(features.zcr - 0.125f) < 0.01f, "1 kHz zcr")
+    PASS()
+}
+
+void test_long_buffer_accuracy() {
+    TEST("Energy accurate on 10M samples")
+    // A single float accumulator stalls long before this many samples
+    std::vector<float> pcm(10000000, 0.1f);
+    VadFeatures features = vad_compute_features(pcm.data(), pcm.size());
+    ASSERT(close_to(features.energy, (double)0.1f * 0.1f, 1e-5), "energy drifted")
+
+    std::vector<float> rand_pcm = noise(10000000, 1.0f, 7);
+    VadFeatures fast = vad_compute_features(rand_pcm.data(), rand_pcm.size());
+    VadFeatures ref = vad_compute_features_reference(rand_pcm.data(), rand_pcm.size());
+    ASSERT(close_to(fast.energy, ref.energy, 1e-5), "noise energy mismatch")
+    ASSERT_EQ(fast.zcr, ref.zcr, "noise zcr mismatch")
+    PASS()
+}
+
+void test_invalid_input() {
+    TEST("Empty and null input")
+    VadFeatures features = vad_compute_features(nullptr, 100);
+    ASSERT_EQ(features.zcr, 0.0f, "null zcr")
+    features = vad_compute_features(nullptr, 0);
+    ASSERT_EQ(features.energy, 0.0, "empty energy")
+    PASS()
+}
+
+/* ============================================
+ * Detector Tests
+ * ============================================ */
+
+void test_silence_is_not_speech() {
+    TEST("Silence is not speech")
+    VoiceDetector vad;
+    std::vector<float> silence(16000, 0.0f);
+    ASSERT_EQ(run_frames(vad, silence), 0, "speech in silence")
+    ASSERT(vad.threshold() >= vad_default_config().min_energy, "threshold below floor")
+    PASS()
+}
+
+void test_tone_is_speech() {
+    TEST("Voiced tone is speech")
+    VoiceDetector vad;
+    std::vector<float> voice = tone(16000, 0.3f, 200.0f);
+    int frames = (int)(voice.size() / FRAME);
+    ASSERT_EQ(run_frames(vad, voice), frames, "voiced frames missed")
+    PASS()
+}
+
+void test_noise_floor_adapts() {
+    TEST("Noise floor adapts to office noise")
+    VoiceDetector vad;
+
+    // Broadband noise above the fixed threshold (mean square ~0.0033)
+    std::vector<float> hiss = noise(16000 * 5, 0.1f, 3);
+    run_frames(vad, hiss);
+    ASSERT(vad.noise_floor() > 0.002, "floor did not rise")
+
+    std::vector<float> more_hiss = noise(16000 * 2, 0.1f, 4);
+    ASSERT_EQ(run_frames(vad, more_hiss), 0, "noise classified as speech")
+
+    // Speech over the same noise
+    std::vector<float> voice = tone(16000, 0.3f, 200.0f);
+    std::vector<float> noisy_voice = noise(16000, 0.1f, 5);
+    for (size_t i = 0; i < voice.size(); i++) {
+        noisy_voice[i] += voice[i];
+    }
+    int frames = (int)(noisy_voice.size() / FRAME);
+    ASSERT_EQ(run_frames(vad, noisy_voice), frames, "speech over noise missed")
+
+    // Floor falls back once the room is quiet again
+    std::vector<float> silence(16000, 0.0f);
+    run_frames(vad, silence);
+    ASSERT(close_to(vad.threshold(), vad_default_config().min_energy, 1e-3), "floor stuck high")
+    PASS()
+}
+
+void test_reset() {
+    TEST("Reset restores initial floor")
+    VoiceDetector vad;
+    std::vector<float> hiss = noise(16000, 0.1f, 6);
+    run_frames(vad, hiss);
+    vad.reset();
+    ASSERT(close_to(vad.noise_floor(), vad_default_config().min_energy, 1e-6), "floor not reset")
+    PASS()
+}
+
+/* ============================================
+ * Segmentation Tests
+ * ============================================ */
+
+static const size_t SECOND = 16000;
+
+/**
+ * Segments are contiguous, cover the buffer and respect max_samples
+ */
+static bool segments_valid(const std::vector<VadSegment>& segments, size_t n, size_t max_samples) {
+    size_t expected_start = 0;
+    for (const auto& segment : segments) {
+        if (segment.start != expected_start || segment.end <= segment.start ||
+            segment.end - segment.start > max_samples) {
+            return false;
+        }
+        expected_start = segment.end;
+    }
+    return expected_start == n;
+}
+
+void test_split_short_audio() {
+    TEST("Short audio is one segment")
+    std::vector<float> voice = tone(5 * SECOND, 0.3f, 200.0f);
+    std::vector<VadSegment> segments = vad_split_segments(voice.data(), voice.size(), FRAME,
+                                                          20 * SECOND, 28 * SECOND);
+    ASSERT_EQ(segments.size(), (size_t)1, "split short audio")
+    ASSERT(segments_valid(segments, voice.size(), 28 * SECOND), "bad segment")
+    ASSERT(segments[0].has_speech, "speech not flagged")
+    PASS()
+}
+
+void test_split_at_silence() {
+    TEST("Long audio is cut inside pauses")
+    // Speech with a short pause at 12 s and a longer one at 18 s
+    std::vector<float> pcm = tone(12 * SECOND, 0.3f, 200.0f);
+    pcm.resize(pcm.size() + SECOND / 5, 0.0f);
+    std::vector<float> more = tone(6 * SECOND, 0.3f, 200.0f);
+    pcm.insert(pcm.end(), more.begin(), more.end());
+    size_t pause_start = pcm.size();
+    pcm.resize(pcm.size() + SECOND, 0.0f);
+    size_t pause_end = pcm.size();
+    more = tone(22 * SECOND, 0.3f, 200.0f);
+    pcm.insert(pcm.end(), more.begin(), more.end());
+
+    std::vector<VadSegment> segments = vad_split_segments(pcm.data(), pcm.size(), FRAME,
+                                                          20 * SECOND, 28 * SECOND);
+    ASSERT(segments_valid(segments, pcm.size(), 28 * SECOND), "bad segments")
+    ASSERT(segments.size() >= 2, "not split")
+    ASSERT(segments[0].end > pause_start && segments[0].end < pause_end, "cut outside the longest pause")
+    PASS()
+}
+
+void test_split_continuous_speech() {
+    TEST("Continuous speech is still split within the limit")
+    std::vector<float> pcm = tone(95 * SECOND, 0.3f, 200.0f);
+    std::vector<VadSegment> segments = vad_split_segments(pcm.data(), pcm.size(), FRAME,
+                                                          20 * SECOND, 28 * SECOND);
+    ASSERT(segments_valid(segments, pcm.size(), 28 * SECOND), "bad segments")
+    ASSERT(segments.size() >= 4, "too few segments")
+    PASS()
+}
+
+void test_split_flags_silence() {
+    TEST("Silent segments are flagged")
+    std::vector<float> pcm(60 * SECOND, 0.0f);
+    std::vector<float> voice = tone(5 * SECOND, 0.3f, 200.0f);
+    std::copy(voice.begin(), voice.end(), pcm.begin() + 50 * SECOND);
+    std::vector<VadSegment> segments = vad_split_segments(pcm.data(), pcm.size(), FRAME,
+                                                          20 * SECOND, 28 * SECOND);
+    ASSERT(segments_valid(segments, pcm.size(), 28 * SECOND), "bad segments")
+    ASSERT(!segments.front().has_speech, "silence flagged as speech")
+    ASSERT(segments.back().has_speech, "speech not flagged")
+    PASS()
+}
+
+/* ============================================
+ * Main
+ * ============================================ */
+
+int main() {
+    printf("\n========================================\n");
+    printf("WisprFlex VAD - Test Suite\n");
+    printf("========================================\n\n");
+
+    // Kernel
+    test_kernel_name();
+    test_kernel_matches_reference();
+    test_zero_crossings();
+    test_long_buffer_accuracy();
+    test_invalid_input();
+
+    // Detector
+    test_silence_is_not_speech();
+    test_tone_is_speech();
+    test_noise_floor_adapts();
+    test_reset();
+
+    // Segmentation
+    test_split_short_audio();
+    test_split_at_silence();
+    test_split_continuous_speech();
+    test_split_flags_silence();
+
+    printf("\n========================================\n");
+    printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
+    printf("========================================\n\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,308 @@
+/**
+ * WisprFlex Whisper Backend - WAV Reader Test Suite
+ *
+ * Verifies:
+ * - 16-bit PCM and 32-bit float files read as 16kHz mono
+ * - Stereo is averaged, other rates are resampled
+ * - Extra chunks and WAVE_FORMAT_EXTENSIBLE headers are handled
+ * - Probing reports duration without reading samples
+ * - Unsupported or broken files fail with a reason
+ */
+
+#include "../whisper_backend/wav_reader.h"
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) \
+    printf("Testing: %s... ", name); \
+    fflush(stdout);
+
+#define PASS() \
+    printf("PASS\n"); \
+    tests_passed++;
+
+#define FAIL(reason) \
+    printf("FAIL (%s)\n", reason); \
+    tests_failed++;
+
+#define ASSERT(condition, reason) \
+    if (!(condition)) { FAIL(reason); return; }
+
+#define ASSERT_EQ(actual, expected, reason) \
+    if ((actual) != (expected)) { FAIL(reason); return; }
+
+static const char* TEST_PATH = "wav_test_input.wav";
+
+/**
+ * Options for a generated file
+ */
+struct WavSpec {
+    uint16_t format = 1;            // 1 = PCM, 3 = float, 0xFFFE = extensible
+    uint16_t sub_format = 1;        // Tag in the extensible GUID
+    uint16_t channels = 1;
+    uint32_t sample_rate = 16000;
+    uint16_t bits = 16;
+    bool list_chunk = false;        // Metadata chunk before "data"
+    bool unknown_size = false;      // Data size left at 0xFFFFFFFF
+};
+
+static void put_u16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back((uint8_t)(v & 0xFF));
+    out.push_back((uint8_t)(v >> 8));
+}
+
+static void put_u32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back((uint8_t)((v >> (8 * i)) & 0xFF));
+    }
+}
+
+static void put_tag(std::vector<uint8_t>& out, const char* tag) {
+    out.insert(out.end(), tag, tag + 4);
+}
+
+/**
+ * Write interleaved samples as a WAV file
+ */
+static bool write_wav(const WavSpec& spec, const std::vector<float>& interleaved) {
+    std::vector<uint8_t> data;
+    for (float sample : interleaved) {
+        if (spec.bits == 32) {
+            uint32_t bits;
+            memcpy(&bits, &sample, sizeof(bits));
+            put_u32(data, bits);
+        } else if (spec.bits == 16) {
+            put_u16(data, (uint16_t)(int16_t)lroundf(sample * 32767.0f));
+        } else {
+            data.push_back((uint8_t)(128 + lroundf(sample * 127.0f)));
+        }
+    }
+
+    std::vector<uint8_t> fmt;
+    put_u16(fmt, spec.format);
+    put_u16(fmt, spec.channels);
+    put_u32(fmt, spec.sample_rate);
+    put_u32(fmt, spec.sample_rate * spec.channels * spec.bits / 8);
+    put_u16(fmt, (uint16_t)(spec.channels * spec.bits / 8));
+    put_u16(fmt, spec.bits);
+    if (spec.format == 0xFFFE) {
+        put_u16(fmt, 22);               // Extension size
+        put_u16(fmt, spec.bits);        // Valid bits
+        put_u32(fmt, 0);                // Channel mask
+        put_u16(fmt, spec.sub_format);
+        fmt.resize(fmt.size() + 14, 0); // Rest of the GUID
+    }
+
+    std::vector<uint8_t> file;
+    put_tag(file, "RIFF");
+    put_u32(file, 0);   // Readers ignore the RIFF size
+    put_tag(file, "WAVE");
+    put_tag(file, "fmt ");
+    put_u32(file, (uint32_t)fmt.size());
+    file.insert(file.end(), fmt.begin(), fmt.end());
+    if (spec.list_chunk) {
+        put_tag(file, "LIST");
+        put_u32(file, 5);   // Odd size, padded to 6
+        file.insert(file.end(), {'I', 'N', 'F', 'O', 'x', 0});
+    }
+    put_tag(file, "data");
+    put_u32(file, spec.unknown_size ? 0xFFFFFFFFu : (uint32_t)data.size());
+    file.insert(file.end(), data.begin(), data.end());
+
+    FILE* out = fopen(TEST_PATH, "wb");
+    if (!out) {
+        return false;
+    }
+    bool ok = fwrite(file.data(), 1, file.size(), out) == file.size();
+    fclose(out);
+    return ok;
+}
+
+static std::vector<float> ramp(size_t n, float scale) {
+    std::vector<float> pcm(n);
+    for (size_t i = 0; i < n; i++) {
+        pcm[i] = scale * (float)((int)(i % 200) - 100) / 100.0f;
+    }
+    return pcm;
+}
+
+// ============================================
+// Formats
+// ============================================
+
+void test_pcm16_mono() {
+    TEST("16-bit mono at 16kHz reads unchanged");
+
+    std::vector<float> pcm = ramp(16000, 0.5f);
+    ASSERT(write_wav(WavSpec(), pcm), "write failed");
+
+    std::vector<float> out;
+    std::string error;
+    ASSERT(wav_load_16k_mono(TEST_PATH, out, &error), error.c_str());
+    ASSERT_EQ(out.size(), pcm.size(), "sample count");
+    for (size_t i = 0; i < pcm.size(); i++) {
+        ASSERT(std::fabs(out[i] - pcm[i]) < 1e-3f, "sample value");
+    }
+
+    PASS();
+}
+
+void test_stereo_downmix() {
+    TEST("Stereo is averaged to mono");
+
+    WavSpec spec;
+    spec.channels = 2;
+    std::vector<float> interleaved;
+    for (int i = 0; i < 1600; i++) {
+        interleaved.push_back(0.5f);
+        interleaved.push_back(-0.25f);
+    }
+    ASSERT(write_wav(spec, interleaved), "write failed");
+
+    std::vector<float> out;
+    ASSERT(wav_load_16k_mono(TEST_PATH, out), "load failed");
+    ASSERT_EQ(out.size(), (size_t)1600, "frame count");
+    ASSERT(std::fabs(out[0] - 0.125f) < 1e-3f, "average of channels");
+
+    PASS();
+}
+
+void test_float_resampled() {
+    TEST("32-bit float at 48kHz is resampled to 16kHz");
+
+    WavSpec spec;
+    spec.format = 3;
+    spec.bits = 32;
+    spec.sample_rate = 48000;
+    std::vector<float> pcm(48000, 0.75f);
+    ASSERT(write_wav(spec, pcm), "write failed");
+
+    std::vector<float> out;
+    ASSERT(wav_load_16k_mono(TEST_PATH, out), "load failed");
+    ASSERT_EQ(out.size(), (size_t)16000, "one second at 16kHz");
+    ASSERT(std::fabs(out[8000] - 0.75f) < 1e-6f, "constant signal preserved");
+
+    PASS();
+}
+
+void test_extensible_and_list_chunk() {
+    TEST("Extensible header with a LIST chunk before data");
+
+    WavSpec spec;
+    spec.format = 0xFFFE;
+    spec.sub_format = 1;
+    spec.list_chunk = true;
+    std::vector<float> pcm = ramp(3200, 0.25f);
+    ASSERT(write_wav(spec, pcm), "write failed");
+
+    std::vector<float> out;
+    std::string error;
+    ASSERT(wav_load_16k_mono(TEST_PATH, out, &error), error.c_str());
+    ASSERT_EQ(out.size(), pcm.size(), "sample count");
+    ASSERT(std::fabs(out[150] - pcm[150]) < 1e-3f, "data found after padded chunk");
+
+    PASS();
+}
+
+// ============================================
+// Probing
+// ============================================
+
+void test_probe_duration() {
+    TEST("Probe reports duration from the header");
+
+    WavSpec spec;
+    spec.sample_rate = 8000;
+    spec.channels = 2;
+    ASSERT(write_wav(spec, std::vector<float>(8000 * 2 * 3, 0.1f)), "write failed");
+
+    WavInfo info = {};
+    ASSERT(wav_probe(TEST_PATH, info), "probe failed");
+    ASSERT_EQ(info.frames, (size_t)24000, "frames per channel");
+    ASSERT(std::fabs(wav_duration_ms(info) - 3000.0) < 1e-6, "duration");
+
+    PASS();
+}
+
+void test_unknown_data_size() {
+    TEST("Unset data size falls back to the file length");
+
+    WavSpec spec;
+    spec.unknown_size = true;
+    ASSERT(write_wav(spec, ramp(4000, 0.5f)), "write failed");
+
+    WavInfo info = {};
+    ASSERT(wav_probe(TEST_PATH, info), "probe failed");
+    ASSERT_EQ(info.frames, (size_t)4000, "frames from file length");
+
+    std::vector<float> out;
+    ASSERT(wav_load_16k_mono(TEST_PATH, out), "load failed");
+    ASSERT_EQ(out.size(), (size_t)4000, "sample count");
+
+    PASS();
+}
+
+// ============================================
+// Errors
+// ============================================
+
+void test_rejects_unsupported() {
+    TEST("8-bit, non-WAV and missing files fail with a reason");
+
+    WavSpec spec;
+    spec.bits = 8;
+    ASSERT(write_wav(spec, ramp(100, 0.5f)), "write failed");
+
+    std::vector<float> out;
+    std::string error;
+    ASSERT(!wav_load_16k_mono(TEST_PATH, out, &error), "8-bit accepted");
+    ASSERT(!error.empty(), "no reason for 8-bit");
+
+    FILE* text = fopen(TEST_PATH, "wb");
+    ASSERT(text != nullptr, "write failed");
+    fputs("not a wav file at all", text);
+    fclose(text);
+    error.clear();
+    ASSERT(!wav_load_16k_mono(TEST_PATH, out, &error), "text accepted");
+    ASSERT(!error.empty(), "no reason for text");
+
+    WavInfo info = {};
+    error.clear();
+    ASSERT(!wav_probe("wav_test_missing.wav", info, &error), "missing file accepted");
+    ASSERT(!error.empty(), "no reason for missing file");
+
+    PASS();
+}
+
+int main() {
+    printf("\n========================================\n");
+    printf("WisprFlex WAV Reader - Test Suite\n");
+    printf("========================================\n\n");
+
+    // Formats
+    test_pcm16_mono();
+    test_stereo_downmix();
+    test_float_resampled();
+    test_extensible_and_list_chunk();
+
+    // Probing
+    test_probe_duration();
+    test_unknown_data_size();
+
+    // Errors
+    test_rejects_unsupported();
+
+    remove(TEST_PATH);
+
+    printf("\n========================================\n");
+    printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
+    printf("========================================\n\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -47,6 +47,71 @@ void print_metrics(const WBMetrics& metrics) {
     printf("---------------------------\n");
 }
 
+/**
+ * Size of a file in bytes (0 if unreadable)
+ */
+size_t file_size(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return 0;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    return size > 0 ? (size_t)size : 0;
+}
+
+/**
+ * A load refused by the model budget must not evict the idle model it
+ * could never have made room with
+ */
+bool check_refused_load_keeps_idle_model(const char* model_path) {
+    // Room for the model (charged 1.5x its file), not for a file twice its size
+    size_t model_bytes = file_size(model_path);
+    wb_set_model_budget(model_bytes * 2);
+    
+    WBModel* model = nullptr;
+    if (wb_model_acquire(model_path, &model) != WB_OK) {
+        printf("FAILED: model not loaded under the budget\n");
+        return false;
+    }
+    wb_model_release(model);  // Idle, kept resident by the budget
+    
+    const char* oversized_path = "whisper_smoke_oversized.bin";
+    FILE* f = fopen(oversized_path, "wb");
+    if (!f || fseek(f, (long)(model_bytes * 2), SEEK_SET) != 0 || fputc(0, f) == EOF) {
+        printf("FAILED: cannot write %s\n", oversized_path);
+        if (f) {
+            fclose(f);
+        }
+        return false;
+    }
+    fclose(f);
+    
+    WBMetrics before = wb_get_metrics();
+    WBModel* oversized = nullptr;
+    WBErrorCode err = wb_model_acquire(oversized_path, &oversized);
+    remove(oversized_path);
+    if (err != WB_ERROR_OUT_OF_MEMORY) {
+        printf("FAILED: oversized load not refused (%s)\n", wb_error_message(err));
+        wb_model_release(oversized);
+        return false;
+    }
+    
+    // Still resident: acquiring it again is a cache hit, not a load
+    bool ok = wb_get_metrics().model_evictions == before.model_evictions;
+    model = nullptr;
+    if (ok && wb_model_acquire(model_path, &model) == WB_OK) {
+        ok = wb_get_metrics().model_cache_hits == before.model_cache_hits + 1;
+    }
+    wb_model_release(model);
+    wb_set_model_budget(0);
+    if (!ok) {
+        printf("FAILED: refused load evicted the idle model\n");
+    }
+    return ok;
+}
+
 int main(int argc, char** argv) {
     printf("========================================\n");
     printf("WisprFlex whisper.cpp Smoke Test\n");
@@ -64,7 +129,7 @@ int main(int argc, char** argv) {
     bool use_test_audio = (argc < 3);
 
     // Step 1: Initialize backend
-    printf("[1/4] Initializing whisper backend...\n");
+    printf("[1/5] Initializing whisper backend...\n");
     WBErrorCode err = wb_init();
     if (err != WB_OK) {
         printf("FAILED: %s\n", wb_error_message(err));
@@ -73,7 +138,7 @@ int main(int argc, char** argv) {
     printf("      OK\n");
 
     // Step 2: Load model
-    printf("[2/4] Loading model: %s\n", model_path);
+    printf("[2/5] Loading model: %s\n", model_path);
     err = wb_load_model(model_path);
     if (err != WB_OK) {
         printf("FAILED: %s\n", wb_error_message(err));
@@ -85,7 +150,7 @@ int main(int argc, char** argv) {
     printf("      OK (%.2f ms)\n", metrics.model_load_time_ms);
 
     // Step 3: Prepare audio
-    printf("[3/4] Preparing audio...\n");
+    printf("[3/5] Preparing audio...\n");
     std::vector<float> audio;
     
     if (use_test_audio) {
@@ -99,7 +164,7 @@ int main(int argc, char** argv) {
     printf("      OK (%zu samples)\n", audio.size());
 
     // Step 4: Run transcription
-    printf("[4/4] Running transcription...\n");
+    printf("[4/5] Running transcription...\n");
     
     char text_buffer[4096] = {0};
     WBTranscribeParams params = wb_default_params();
@@ -132,6 +197,15 @@ int main(int argc, char** argv) {
     metrics = wb_get_metrics();
     print_metrics(metrics);
 
+    // Step 5: Model budget
+    printf("\n[5/5] Refusing a load over the model budget...\n");
+    wb_unload_model();
+    if (!check_refused_load_keeps_idle_model(model_path)) {
+        wb_shutdown();
+        return 1;
+    }
+    printf("      OK\n");
+
     // Cleanup
     wb_unload_model();
     wb_shutdown();
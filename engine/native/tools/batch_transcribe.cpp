@@ -0,0 +1,140 @@
+/**
+ * WisprFlex Batch Transcription CLI
+ *
+ * Transcribes many WAV files with one model load:
+ *
+ *   batch_transcribe <model_path> <output.jsonl> [options] [file.wav ...]
+ *
+ * Options:
+ *   --list <path>        Read more file paths from a text file, one per line
+ *   --checkpoint <path>  Checkpoint file (default <output.jsonl>.checkpoint)
+ *   --language <code>    Language (default en, "auto" to detect)
+ *   --workers <n>        Files transcribed in parallel
+ *   --threads <n>        Threads per file
+ *   --io-threads <n>     WAV decode threads
+ *
+ * Results are appended to the output as JSON lines. Rerunning the same
+ * command skips files already listed in the checkpoint.
+ */
+
+#include "whisper_backend.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static void print_usage(const char* program) {
+    printf("Usage: %s <model_path> <output.jsonl> [options] [file.wav ...]\n", program);
+    printf("  --list <path>        File paths, one per line\n");
+    printf("  --checkpoint <path>  Checkpoint file (default <output.jsonl>.checkpoint)\n");
+    printf("  --language <code>    Language (default en, \"auto\" to detect)\n");
+    printf("  --workers <n>        Files transcribed in parallel (default: cores / threads)\n");
+    printf("  --threads <n>        Threads per file (default 4)\n");
+    printf("  --io-threads <n>     WAV decode threads (default 2)\n");
+}
+
+static bool read_list(const char* path, std::vector<std::string>& files) {
+    std::ifstream list(path);
+    if (!list) {
+        printf("Error: Cannot open list %s\n", path);
+        return false;
+    }
+    std::string line;
+    while (std::getline(list, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            files.push_back(line);
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    const char* model_path = argv[1];
+    WBBatchJobConfig config = wb_default_batch_job_config();
+    config.output_path = argv[2];
+    config.language = "en";
+
+    std::vector<std::string> files;
+    for (int i = 3; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (strcmp(arg, "--list") == 0 && has_value) {
+            if (!read_list(argv[++i], files)) {
+                return 1;
+            }
+        } else if (strcmp(arg, "--checkpoint") == 0 && has_value) {
+            config.checkpoint_path = argv[++i];
+        } else if (strcmp(arg, "--language") == 0 && has_value) {
+            const char* language = argv[++i];
+            config.language = strcmp(language, "auto") == 0 ? nullptr : language;
+        } else if (strcmp(arg, "--workers") == 0 && has_value) {
+            config.n_workers = atoi(argv[++i]);
+        } else if (strcmp(arg, "--threads") == 0 && has_value) {
+            config.n_threads = atoi(argv[++i]);
+        } else if (strcmp(arg, "--io-threads") == 0 && has_value) {
+            config.n_io_threads = atoi(argv[++i]);
+        } else if (strncmp(arg, "--", 2) == 0) {
+            printf("Error: Unknown or incomplete option %s\n", arg);
+            print_usage(argv[0]);
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        printf("Error: No input files\n");
+        return 1;
+    }
+
+    std::vector<const char*> paths;
+    for (const std::string& file : files) {
+        paths.push_back(file.c_str());
+    }
+    config.files = paths.data();
+    config.n_files = paths.size();
+
+    WBErrorCode err = wb_init();
+    if (err != WB_OK) {
+        printf("Error: Init failed: %s\n", wb_error_message(err));
+        return 1;
+    }
+
+    err = wb_load_model(model_path);
+    if (err != WB_OK) {
+        printf("Error: Model load failed: %s\n", wb_error_message(err));
+        wb_shutdown();
+        return 1;
+    }
+
+    WBBatchJobSummary summary = {};
+    err = wb_run_batch_job(&config, &summary);
+
+    wb_unload_model();
+    wb_shutdown();
+
+    if (err != WB_OK) {
+        printf("Error: Batch job failed: %s\n", wb_error_message(err));
+        return 1;
+    }
+
+    double rtf = summary.audio_ms > 0 ? summary.wall_ms / summary.audio_ms : 0.0;
+    printf("\n");
+    printf("Files: %d done, %d failed, %d skipped\n",
+           summary.files_done, summary.files_failed, summary.files_skipped);
+    printf("Audio: %.1f s in %.1f s (overall RTF %.3f)\n",
+           summary.audio_ms / 1000.0, summary.wall_ms / 1000.0, rtf);
+
+    return summary.files_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,563 @@
+/**
+ * WisprFlex Benchmark Suite
+ *
+ * Measures model loading, single-shot and streaming transcription and
+ * session stability with one model, and compares them with a stored
+ * baseline:
+ *
+ *   benchmark_suite <model_path> [options]
+ *   benchmark_suite --compare <baseline.json> <results.json> [--threshold <percent>]
+ *
+ * Options:
+ *   --audio <file.wav>     Audio to transcribe (default: 10 s synthetic tone)
+ *   --reference <path>     Reference transcript; adds word error rate metrics
+ *   --chunk-ms <n>         Streaming chunk length (default 800)
+ *   --warmup <n>           Unmeasured iterations per benchmark (default 1)
+ *   --iterations <n>       Measured iterations per benchmark (default 5)
+ *   --filter <text>        Run only benchmarks whose name contains text
+ *   --output <path>        Write results as JSON
+ *   --baseline <path>      Compare with earlier results; regressions fail the run
+ *   --threshold <percent>  Slowdown of a median that counts (default 10)
+ *   --list                 List the benchmarks and exit
+ *
+ * Replaces the fixed gates of the Phase 2 benchmark programs: a result
+ * is judged against the same machine's baseline instead, so a whisper.cpp
+ * update that slows any stage shows up as a regression.
+ */
+
+#include "whisper_backend.h"
+#include "benchmark_harness.h"
+#include "memory_probe.h"
+#include "wav_reader.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define SAMPLE_RATE 16000
+#define STABILITY_CHUNK_SAMPLES (SAMPLE_RATE * 4)  // 4-second chunks, as in Phase 2.5
+#define SESSION_CYCLES 10
+#define LONG_SESSION_CHUNKS 20
+
+// Noise floor of memory metrics (allocator and page cache jitter)
+static const double MEMORY_MIN_DELTA_MB = 2.0;
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * Inputs shared by all benchmarks
+ */
+struct SuiteInput {
+    const char* model_path;
+    std::vector<float> audio;
+    std::string reference;      // Empty = no WER metrics
+    size_t chunk_samples;
+};
+
+static double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static double resident_mb() {
+    return memory_resident_kb() / 1024.0;
+}
+
+static void print_usage(const char* program) {
+    printf("Usage: %s <model_path> [options]\n", program);
+    printf("       %s --compare <baseline.json> <results.json> [--threshold <percent>]\n", program);
+    printf("  --audio <file.wav>     Audio to transcribe (default: 10 s synthetic tone)\n");
+    printf("  --reference <path>     Reference transcript for word error rate\n");
+    printf("  --chunk-ms <n>         Streaming chunk length (default 800)\n");
+    printf("  --warmup <n>           Unmeasured iterations per benchmark (default 1)\n");
+    printf("  --iterations <n>       Measured iterations per benchmark (default 5)\n");
+    printf("  --filter <text>        Run only benchmarks whose name contains text\n");
+    printf("  --output <path>        Write results as JSON\n");
+    printf("  --baseline <path>      Compare with earlier results\n");
+    printf("  --threshold <percent>  Slowdown that counts as a regression (default 10)\n");
+    printf("  --list                 List the benchmarks\n");
+}
+
+// Tone as in the Phase 2.5 stability test
+static std::vector<float> generate_tone(float duration_sec) {
+    size_t n_samples = (size_t)(duration_sec * SAMPLE_RATE);
+    std::vector<float> audio(n_samples);
+    for (size_t i = 0; i < n_samples; i++) {
+        audio[i] = 0.1f * sinf(2.0f * 3.14159f * 440.0f * i / SAMPLE_RATE);
+    }
+    return audio;
+}
+
+/* ============================================
+ * Word Error Rate
+ * ============================================ */
+
+/**
+ * Lowercase words with punctuation stripped
+ */
+static std::vector<std::string> normalized_words(const std::string& text) {
+    std::vector<std::string> words;
+    std::istringstream in(text);
+    std::string token;
+    while (in >> token) {
+        std::string w;
+        for (char c : token) {
+            if (std::isalnum((unsigned char)c)) w += (char)std::tolower((unsigned char)c);
+        }
+        if (!w.empty()) words.push_back(w);
+    }
+    return words;
+}
+
+/**
+ * Word error rate of hypothesis against reference (word-level Levenshtein)
+ */
+static double word_error_rate(const std::string& reference, const std::string& hypothesis) {
+    std::vector<std::string> ref = normalized_words(reference);
+    std::vector<std::string> hyp = normalized_words(hypothesis);
+    if (ref.empty()) return hyp.empty() ? 0.0 : 1.0;
+
+    std::vector<size_t> prev(hyp.size() + 1), cur(hyp.size() + 1);
+    for (size_t j = 0; j <= hyp.size(); j++) prev[j] = j;
+    for (size_t i = 1; i <= ref.size(); i++) {
+        cur[0] = i;
+        for (size_t j = 1; j <= hyp.size(); j++) {
+            size_t sub = prev[j - 1] + (ref[i - 1] == hyp[j - 1] ? 0 : 1);
+            cur[j] = std::min({sub, prev[j] + 1, cur[j - 1] + 1});
+        }
+        std::swap(prev, cur);
+    }
+    return (double)prev[hyp.size()] / ref.size();
+}
+
+/* ============================================
+ * Benchmarks
+ * ============================================ */
+
+/**
+ * First load in this process (whisper allocations, file not yet mapped)
+ */
+static void bench_model_load_cold(const SuiteInput& input, BenchmarkRecorder& r) {
+    auto start = Clock::now();
+    WBErrorCode err = wb_load_model(input.model_path);
+    double load_ms = ms_since(start);
+    if (err != WB_OK) {
+        r.fail(std::string("load failed: ") + wb_error_message(err));
+        return;
+    }
+
+    WBMetrics metrics = wb_get_metrics();
+    r.record("load_ms", "ms", load_ms);
+    r.record("warmup_ms", "ms", metrics.warmup_time_ms);
+    r.record("weights_mb", "MB", metrics.model_memory_bytes / (1024.0 * 1024.0), MEMORY_MIN_DELTA_MB);
+    r.record("state_mb", "MB", (metrics.state_buffer_bytes + metrics.warmup_compute_bytes) / (1024.0 * 1024.0),
+             MEMORY_MIN_DELTA_MB);
+    r.record("rss_mb", "MB", resident_mb(), MEMORY_MIN_DELTA_MB);
+}
+
+/**
+ * Unload and reload (page cache warm)
+ */
+static void bench_model_load(const SuiteInput& input, BenchmarkRecorder& r) {
+    wb_unload_model();
+    auto start = Clock::now();
+    WBErrorCode err = wb_load_model(input.model_path);
+    double load_ms = ms_since(start);
+    if (err != WB_OK) {
+        r.fail(std::string("load failed: ") + wb_error_message(err));
+        return;
+    }
+    r.record("load_ms", "ms", load_ms);
+    r.record("rss_mb", "MB", resident_mb(), MEMORY_MIN_DELTA_MB);
+}
+
+/**
+ * wb_transcribe over the first 30 s
+ */
+static void bench_transcribe(const SuiteInput& input, BenchmarkRecorder& r) {
+    size_t n_samples = std::min(input.audio.size(), (size_t)SAMPLE_RATE * 30);
+    WBTranscribeParams params = wb_default_params();
+    char text[16384] = {0};
+
+    auto start = Clock::now();
+    WBErrorCode err = wb_transcribe(input.audio.data(), n_samples, &params, text, sizeof(text));
+    double transcribe_ms = ms_since(start);
+    if (err != WB_OK) {
+        r.fail(std::string("transcribe failed: ") + wb_error_message(err));
+        return;
+    }
+
+    double audio_ms = n_samples * 1000.0 / SAMPLE_RATE;
+    r.record("transcribe_ms", "ms", transcribe_ms);
+    r.record("rtf", "x", transcribe_ms / audio_ms);
+}
+
+/**
+ * Callback state of one streaming run
+ */
+struct StreamRun {
+    Clock::time_point start;
+    double first_partial_ms;    // < 0 until the first partial
+    std::vector<WBChunkTiming> timings;
+};
+
+static void on_stream_partial(const char* text, void* user_data) {
+    (void)text;
+    StreamRun* run = (StreamRun*)user_data;
+    if (run->first_partial_ms < 0) {
+        run->first_partial_ms = ms_since(run->start);
+    }
+}
+
+static void on_stream_timing(const WBChunkTiming* timing, void* user_data) {
+    ((StreamRun*)user_data)->timings.push_back(*timing);
+}
+
+/**
+ * Stream the audio in chunk_samples pieces as a live source would
+ * (Phase 2.3 / 2.4 streaming tests)
+ */
+static void bench_streaming(const SuiteInput& input, int reduce_audio_ctx, BenchmarkRecorder& r) {
+    WBSessionConfig config = wb_default_session_config();
+    config.reduce_audio_ctx = reduce_audio_ctx;
+    config.timing_callback = on_stream_timing;
+
+    StreamRun run;
+    run.first_partial_ms = -1;
+    run.start = Clock::now();
+
+    uint32_t session_id = wb_start_session_with_config(&config, on_stream_partial, &run);
+    if (session_id == 0) {
+        r.fail("cannot start session");
+        return;
+    }
+
+    double peak_mb = resident_mb();
+    for (size_t offset = 0; offset < input.audio.size(); offset += input.chunk_samples) {
+        size_t chunk_size = std::min(input.chunk_samples, input.audio.size() - offset);
+        auto chunk_start = Clock::now();
+        WBErrorCode err = wb_process_chunk(session_id, input.audio.data() + offset, chunk_size);
+        if (err != WB_OK) {
+            wb_abort_session(session_id);
+            r.fail(std::string("chunk failed: ") + wb_error_message(err));
+            return;
+        }
+        r.record("chunk_ms", "ms", ms_since(chunk_start));
+        peak_mb = std::max(peak_mb, resident_mb());
+    }
+
+    char final_text[16384] = {0};
+    auto finalize_start = Clock::now();
+    WBErrorCode err = wb_finalize_session(session_id, final_text, sizeof(final_text));
+    double finalize_ms = ms_since(finalize_start);
+    double session_ms = ms_since(run.start);
+    if (err != WB_OK) {
+        r.fail(std::string("finalize failed: ") + wb_error_message(err));
+        return;
+    }
+
+    // Stages of every transcribed window: where a whisper.cpp change lands
+    for (const WBChunkTiming& timing : run.timings) {
+        r.record("mel_ms", "ms", timing.stages.mel_ms);
+        r.record("encode_ms", "ms", timing.stages.encode_ms);
+        r.record("decode_ms", "ms", timing.stages.decode_ms);
+    }
+    if (run.first_partial_ms >= 0) {
+        r.record("first_partial_ms", "ms", run.first_partial_ms);
+    }
+    r.record("finalize_ms", "ms", finalize_ms);
+    r.record("rtf", "x", session_ms / (input.audio.size() * 1000.0 / SAMPLE_RATE));
+    r.record("peak_rss_mb", "MB", peak_mb, MEMORY_MIN_DELTA_MB);
+    if (!input.reference.empty()) {
+        r.record("wer_pct", "%", word_error_rate(input.reference, final_text) * 100.0, 0.5);
+    }
+}
+
+/**
+ * Start, one 4 s chunk, finalize - SESSION_CYCLES times (Phase 2.5 test 1)
+ */
+static void bench_session_cycles(const SuiteInput& input, BenchmarkRecorder& r) {
+    size_t chunk_size = std::min(input.audio.size(), (size_t)STABILITY_CHUNK_SAMPLES);
+    double start_mb = resident_mb();
+
+    for (int i = 0; i < SESSION_CYCLES; i++) {
+        auto start = Clock::now();
+        uint32_t session_id = wb_start_session(nullptr, nullptr);
+        if (session_id == 0) {
+            r.fail("cannot start session");
+            return;
+        }
+        if (wb_process_chunk(session_id, input.audio.data(), chunk_size) != WB_OK) {
+            wb_abort_session(session_id);
+            r.fail("chunk failed");
+            return;
+        }
+        char text[4096] = {0};
+        if (wb_finalize_session(session_id, text, sizeof(text)) != WB_OK) {
+            r.fail("finalize failed");
+            return;
+        }
+        r.record("cycle_ms", "ms", ms_since(start));
+    }
+    r.record("rss_growth_mb", "MB", resident_mb() - start_mb, MEMORY_MIN_DELTA_MB);
+}
+
+/**
+ * One session of LONG_SESSION_CHUNKS 4 s chunks (Phase 2.5 test 3)
+ */
+static void bench_long_session(const SuiteInput& input, BenchmarkRecorder& r) {
+    size_t chunk_size = std::min(input.audio.size(), (size_t)STABILITY_CHUNK_SAMPLES);
+    uint32_t session_id = wb_start_session(nullptr, nullptr);
+    if (session_id == 0) {
+        r.fail("cannot start session");
+        return;
+    }
+
+    double start_mb = resident_mb();
+    for (int i = 0; i < LONG_SESSION_CHUNKS; i++) {
+        auto start = Clock::now();
+        if (wb_process_chunk(session_id, input.audio.data(), chunk_size) != WB_OK) {
+            wb_abort_session(session_id);
+            r.fail("chunk failed");
+            return;
+        }
+        r.record("chunk_ms", "ms", ms_since(start));
+    }
+
+    char text[16384] = {0};
+    auto finalize_start = Clock::now();
+    if (wb_finalize_session(session_id, text, sizeof(text)) != WB_OK) {
+        r.fail("finalize failed");
+        return;
+    }
+    r.record("finalize_ms", "ms", ms_since(finalize_start));
+    r.record("rss_growth_mb", "MB", resident_mb() - start_mb, MEMORY_MIN_DELTA_MB);
+}
+
+/**
+ * Shutdown, init, load and one session (Phase 2.5 test 2)
+ */
+static void bench_engine_restart(const SuiteInput& input, BenchmarkRecorder& r) {
+    auto start = Clock::now();
+    wb_unload_model();
+    wb_shutdown();
+    if (wb_init() != WB_OK) {
+        r.fail("restart init failed");
+        return;
+    }
+    WBErrorCode err = wb_load_model(input.model_path);
+    if (err != WB_OK) {
+        r.fail(std::string("restart load failed: ") + wb_error_message(err));
+        return;
+    }
+    double restart_ms = ms_since(start);
+
+    size_t chunk_size = std::min(input.audio.size(), (size_t)STABILITY_CHUNK_SAMPLES);
+    uint32_t session_id = wb_start_session(nullptr, nullptr);
+    char text[4096] = {0};
+    if (session_id == 0 || wb_process_chunk(session_id, input.audio.data(), chunk_size) != WB_OK ||
+        wb_finalize_session(session_id, text, sizeof(text)) != WB_OK) {
+        r.fail("session after restart failed");
+        return;
+    }
+
+    r.record("restart_ms", "ms", restart_ms);
+    r.record("rss_mb", "MB", resident_mb(), MEMORY_MIN_DELTA_MB);
+}
+
+/* ============================================
+ * Main
+ * ============================================ */
+
+static int run_compare(const char* baseline_path, const char* results_path, double threshold) {
+    std::vector<BenchmarkResult> baseline;
+    std::vector<BenchmarkResult> results;
+    std::string error;
+    if (!benchmark_read_json(baseline_path, baseline, &error) ||
+        !benchmark_read_json(results_path, results, &error)) {
+        printf("Error: %s\n", error.c_str());
+        return 1;
+    }
+
+    int regressions = benchmark_print_comparison(benchmark_compare(baseline, results, threshold));
+    printf("Regressions: %d\n", regressions);
+    return regressions > 0 ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    SuiteInput input;
+    input.model_path = argv[1];
+    input.chunk_samples = SAMPLE_RATE * 800 / 1000;
+    BenchmarkOptions options;
+    const char* audio_path = nullptr;
+    const char* reference_path = nullptr;
+    const char* output_path = nullptr;
+    const char* baseline_path = nullptr;
+    const char* compare_results_path = nullptr;
+    double threshold = BENCHMARK_DEFAULT_THRESHOLD;
+    bool list_only = false;
+
+    int first_option = 2;
+    if (strcmp(argv[1], "--compare") == 0) {
+        if (argc < 4) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        baseline_path = argv[2];
+        compare_results_path = argv[3];
+        first_option = 4;
+    }
+
+    for (int i = first_option; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (strcmp(arg, "--audio") == 0 && has_value) {
+            audio_path = argv[++i];
+        } else if (strcmp(arg, "--reference") == 0 && has_value) {
+            reference_path = argv[++i];
+        } else if (strcmp(arg, "--chunk-ms") == 0 && has_value) {
+            input.chunk_samples = (size_t)std::max(1, atoi(argv[++i])) * SAMPLE_RATE / 1000;
+        } else if (strcmp(arg, "--warmup") == 0 && has_value) {
+            options.warmup_iterations = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(arg, "--iterations") == 0 && has_value) {
+            options.iterations = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(arg, "--filter") == 0 && has_value) {
+            options.filter = argv[++i];
+        } else if (strcmp(arg, "--output") == 0 && has_value) {
+            output_path = argv[++i];
+        } else if (strcmp(arg, "--baseline") == 0 && has_value) {
+            baseline_path = argv[++i];
+        } else if (strcmp(arg, "--threshold") == 0 && has_value) {
+            threshold = atof(argv[++i]) / 100.0;
+        } else if (strcmp(arg, "--list") == 0) {
+            list_only = true;
+        } else {
+            printf("Error: Unknown or incomplete option %s\n", arg);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (compare_results_path) {
+        return run_compare(baseline_path, compare_results_path, threshold);
+    }
+
+    // Registration order is run order: the cold load must come first and
+    // the restart last, since it replaces the engine the others share
+    BenchmarkSuite suite(options);
+    suite.add("model_load_cold", [&](BenchmarkRecorder& r) { bench_model_load_cold(input, r); }, 0, 1);
+    suite.add("model_load", [&](BenchmarkRecorder& r) { bench_model_load(input, r); });
+    suite.add("transcribe", [&](BenchmarkRecorder& r) { bench_transcribe(input, r); });
+    suite.add("streaming", [&](BenchmarkRecorder& r) { bench_streaming(input, 1, r); });
+    suite.add("streaming_full_ctx", [&](BenchmarkRecorder& r) { bench_streaming(input, 0, r); });
+    suite.add("session_cycles", [&](BenchmarkRecorder& r) { bench_session_cycles(input, r); });
+    suite.add("long_session", [&](BenchmarkRecorder& r) { bench_long_session(input, r); }, 0, 1);
+    suite.add("engine_restart", [&](BenchmarkRecorder& r) { bench_engine_restart(input, r); }, 0, -1);
+
+    if (list_only) {
+        for (const std::string& name : suite.names()) {
+            printf("%s\n", name.c_str());
+        }
+        return 0;
+    }
+
+    std::vector<BenchmarkResult> baseline;
+    std::string error;
+    if (baseline_path && !benchmark_read_json(baseline_path, baseline, &error)) {
+        printf("Error: %s\n", error.c_str());
+        return 1;
+    }
+
+    if (audio_path) {
+        if (!wav_load_16k_mono(audio_path, input.audio, &error)) {
+            printf("Error: %s\n", error.c_str());
+            return 1;
+        }
+    } else {
+        input.audio = generate_tone(10.0f);
+    }
+    if (input.audio.empty()) {
+        printf("Error: No audio samples\n");
+        return 1;
+    }
+    if (reference_path) {
+        std::ifstream reference(reference_path);
+        if (!reference) {
+            printf("Error: Cannot read reference %s\n", reference_path);
+            return 1;
+        }
+        std::stringstream contents;
+        contents << reference.rdbuf();
+        input.reference = contents.str();
+    }
+
+    printf("\n========================================\n");
+    printf("WisprFlex Benchmark Suite\n");
+    printf("========================================\n\n");
+    printf("Model: %s\n", input.model_path);
+    printf("Audio: %s (%.1f s)\n", audio_path ? audio_path : "synthetic tone",
+           input.audio.size() / (double)SAMPLE_RATE);
+    printf("Iterations: %d warm-up, %d measured\n\n", options.warmup_iterations, options.iterations);
+
+    WBErrorCode err = wb_init();
+    if (err != WB_OK) {
+        printf("Error: Init failed: %s\n", wb_error_message(err));
+        return 1;
+    }
+
+    // The other benchmarks need a model even when the cold load is filtered out
+    if (std::string("model_load_cold").find(options.filter) == std::string::npos) {
+        err = wb_load_model(input.model_path);
+        if (err != WB_OK) {
+            printf("Error: Model load failed: %s\n", wb_error_message(err));
+            wb_shutdown();
+            return 1;
+        }
+    }
+
+    std::vector<BenchmarkResult> results = suite.run();
+    bool all_ok = true;
+    for (const BenchmarkResult& result : results) {
+        all_ok = all_ok && result.ok;
+    }
+
+    wb_unload_model();
+    wb_shutdown();
+
+    benchmark_print_results(results);
+
+    if (output_path) {
+        BenchmarkContext context = {
+            {"model", input.model_path},
+            {"audio", audio_path ? audio_path : "synthetic tone"},
+            {"chunk_ms", std::to_string(input.chunk_samples * 1000 / SAMPLE_RATE)},
+            {"warmup_iterations", std::to_string(options.warmup_iterations)},
+            {"iterations", std::to_string(options.iterations)},
+        };
+        if (!benchmark_write_json(output_path, context, results, &error)) {
+            printf("Error: %s\n", error.c_str());
+            return 1;
+        }
+        printf("Results written to %s\n", output_path);
+    }
+
+    int regressions = 0;
+    if (baseline_path) {
+        regressions = benchmark_print_comparison(benchmark_compare(baseline, results, threshold));
+        printf("Regressions: %d\n", regressions);
+    }
+
+    return all_ok && regressions == 0 ? 0 : 1;
+}
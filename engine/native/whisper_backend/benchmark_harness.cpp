@@ -0,0 +1,677 @@
+/**
+ * WisprFlex Whisper Backend - Benchmark Harness
+ *
+ * Results are read back with a small JSON reader that accepts any valid
+ * JSON document and then looks up the fields benchmark_write_json
+ * writes, so baselines may be edited by hand or by other tools.
+ */
+
+#include "benchmark_harness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+/* ============================================
+ * Statistics
+ * ============================================ */
+
+/**
+ * Value at fraction p of the sorted samples, interpolating between ranks
+ */
+static double percentile(const std::vector<double>& sorted, double p) {
+    double rank = p * (double)(sorted.size() - 1);
+    size_t below = (size_t)rank;
+    if (below + 1 >= sorted.size()) {
+        return sorted.back();
+    }
+    double fraction = rank - (double)below;
+    return sorted[below] + (sorted[below + 1] - sorted[below]) * fraction;
+}
+
+BenchmarkStats benchmark_stats(const std::vector<double>& samples) {
+    BenchmarkStats stats = {};
+    if (samples.empty()) {
+        return stats;
+    }
+
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+    for (double value : sorted) {
+        sum += value;
+    }
+    stats.count = sorted.size();
+    stats.mean = sum / (double)sorted.size();
+
+    double squares = 0.0;
+    for (double value : sorted) {
+        squares += (value - stats.mean) * (value - stats.mean);
+    }
+    stats.stddev = sorted.size() > 1 ? std::sqrt(squares / (double)(sorted.size() - 1)) : 0.0;
+
+    stats.min = sorted.front();
+    stats.median = percentile(sorted, 0.50);
+    stats.p90 = percentile(sorted, 0.90);
+    stats.p95 = percentile(sorted, 0.95);
+    stats.p99 = percentile(sorted, 0.99);
+    stats.max = sorted.back();
+    return stats;
+}
+
+/* ============================================
+ * Running
+ * ============================================ */
+
+BenchmarkRecorder::BenchmarkRecorder(BenchmarkResult& result, bool warming_up)
+    : result_(result), warming_up_(warming_up) {}
+
+void BenchmarkRecorder::record(const char* metric, const char* unit, double value, double min_delta) {
+    if (warming_up_) {
+        return;
+    }
+    for (BenchmarkMetric& existing : result_.metrics) {
+        if (existing.name == metric) {
+            existing.samples.push_back(value);
+            return;
+        }
+    }
+    BenchmarkMetric created = {};
+    created.name = metric;
+    created.unit = unit;
+    created.min_delta = min_delta;
+    created.samples.push_back(value);
+    result_.metrics.push_back(created);
+}
+
+void BenchmarkRecorder::fail(const std::string& reason) {
+    if (result_.ok) {
+        result_.ok = false;
+        result_.error = reason;
+    }
+}
+
+BenchmarkSuite::BenchmarkSuite(const BenchmarkOptions& options) : options_(options) {}
+
+void BenchmarkSuite::add(const std::string& name, BenchmarkBody body,
+                         int warmup_iterations, int iterations) {
+    cases_.push_back({name, body, warmup_iterations, iterations});
+}
+
+std::vector<std::string> BenchmarkSuite::names() const {
+    std::vector<std::string> names;
+    for (const Case& c : cases_) {
+        names.push_back(c.name);
+    }
+    return names;
+}
+
+std::vector<BenchmarkResult> BenchmarkSuite::run() {
+    std::vector<BenchmarkResult> results;
+    for (const Case& c : cases_) {
+        if (!options_.filter.empty() && c.name.find(options_.filter) == std::string::npos) {
+            continue;
+        }
+
+        BenchmarkResult result = {};
+        result.name = c.name;
+        result.warmup_iterations = c.warmup_iterations >= 0 ? c.warmup_iterations : options_.warmup_iterations;
+        result.ok = true;
+        int iterations = c.iterations >= 0 ? c.iterations : options_.iterations;
+
+        printf("Running %s (%d warm-up, %d iterations)...\n",
+               c.name.c_str(), result.warmup_iterations, iterations);
+        fflush(stdout);
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < result.warmup_iterations && result.ok; i++) {
+            BenchmarkRecorder recorder(result, true);
+            c.body(recorder);
+        }
+        for (int i = 0; i < iterations && result.ok; i++) {
+            BenchmarkRecorder recorder(result, false);
+            c.body(recorder);
+            if (result.ok) {
+                result.iterations++;
+            }
+        }
+        for (BenchmarkMetric& metric : result.metrics) {
+            metric.stats = benchmark_stats(metric.samples);
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (result.ok) {
+            printf("  done in %.1f s\n", seconds);
+        } else {
+            printf("  FAIL: %s\n", result.error.c_str());
+        }
+        results.push_back(result);
+    }
+    return results;
+}
+
+/* ============================================
+ * JSON Output
+ * ============================================ */
+
+static void write_string(FILE* out, const std::string& text) {
+    fputc('"', out);
+    for (char ch : text) {
+        unsigned char c = (unsigned char)ch;
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+        } else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void write_number(FILE* out, double value) {
+    if (std::isfinite(value)) {
+        fprintf(out, "%.9g", value);
+    } else {
+        fprintf(out, "null");
+    }
+}
+
+static void write_metric(FILE* out, const BenchmarkMetric& metric) {
+    const BenchmarkStats& s = metric.stats;
+    fprintf(out, "        {\"name\": ");
+    write_string(out, metric.name);
+    fprintf(out, ", \"unit\": ");
+    write_string(out, metric.unit);
+    fprintf(out, ", \"min_delta\": ");
+    write_number(out, metric.min_delta);
+    fprintf(out, ", \"count\": %zu", s.count);
+
+    const std::pair<const char*, double> fields[] = {
+        {"min", s.min}, {"median", s.median}, {"p90", s.p90}, {"p95", s.p95},
+        {"p99", s.p99}, {"max", s.max}, {"mean", s.mean}, {"stddev", s.stddev},
+    };
+    for (const auto& field : fields) {
+        fprintf(out, ", \"%s\": ", field.first);
+        write_number(out, field.second);
+    }
+
+    fprintf(out, ",\n         \"samples\": [");
+    for (size_t i = 0; i < metric.samples.size(); i++) {
+        fprintf(out, i ? ", " : "");
+        write_number(out, metric.samples[i]);
+    }
+    fprintf(out, "]}");
+}
+
+bool benchmark_write_json(const char* path, const BenchmarkContext& context,
+                          const std::vector<BenchmarkResult>& results, std::string* error) {
+    FILE* out = path ? fopen(path, "w") : nullptr;
+    if (!out) {
+        if (error) {
+            *error = std::string("cannot open ") + (path ? path : "(null)");
+        }
+        return false;
+    }
+
+    fprintf(out, "{\n  \"schema\": 1,\n  \"context\": {");
+    for (size_t i = 0; i < context.size(); i++) {
+        fprintf(out, i ? ", " : "");
+        write_string(out, context[i].first);
+        fprintf(out, ": ");
+        write_string(out, context[i].second);
+    }
+    fprintf(out, "},\n  \"benchmarks\": [");
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult& result = results[i];
+        fprintf(out, "%s\n    {\"name\": ", i ? "," : "");
+        write_string(out, result.name);
+        fprintf(out, ", \"ok\": %s, \"error\": ", result.ok ? "true" : "false");
+        write_string(out, result.error);
+        fprintf(out, ", \"warmup_iterations\": %d, \"iterations\": %d,\n      \"metrics\": [",
+                result.warmup_iterations, result.iterations);
+        for (size_t m = 0; m < result.metrics.size(); m++) {
+            fprintf(out, "%s\n", m ? "," : "");
+            write_metric(out, result.metrics[m]);
+        }
+        fprintf(out, "%s]}", result.metrics.empty() ? "" : "\n      ");
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    bool ok = !ferror(out);
+    ok = fclose(out) == 0 && ok;
+    if (!ok && error) {
+        *error = std::string("cannot write ") + path;
+    }
+    return ok;
+}
+
+/* ============================================
+ * JSON Input
+ * ============================================ */
+
+struct JsonValue {
+    enum Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+    Type type = NUL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* get(const char* key) const {
+        for (const auto& member : members) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+struct JsonParser {
+    const char* start;
+    const char* p;
+    const char* end;
+    std::string error;
+};
+
+static bool parse_value(JsonParser& parser, JsonValue& value, int depth);
+
+static void skip_space(JsonParser& parser) {
+    while (parser.p < parser.end && strchr(" \t\r\n", *parser.p)) {
+        parser.p++;
+    }
+}
+
+static bool fail_at(JsonParser& parser, const char* what) {
+    if (parser.error.empty()) {
+        parser.error = std::string(what) + " at offset " + std::to_string(parser.p - parser.start);
+    }
+    return false;
+}
+
+static bool consume(JsonParser& parser, const char* literal) {
+    size_t length = strlen(literal);
+    if ((size_t)(parser.end - parser.p) < length || strncmp(parser.p, literal, length) != 0) {
+        return false;
+    }
+    parser.p += length;
+    return true;
+}
+
+static void append_utf8(std::string& out, unsigned code) {
+    if (code < 0x80) {
+        out += (char)code;
+    } else if (code < 0x800) {
+        out += (char)(0xC0 | (code >> 6));
+        out += (char)(0x80 | (code & 0x3F));
+    } else {
+        out += (char)(0xE0 | (code >> 12));
+        out += (char)(0x80 | ((code >> 6) & 0x3F));
+        out += (char)(0x80 | (code & 0x3F));
+    }
+}
+
+static bool parse_string(JsonParser& parser, std::string& out) {
+    parser.p++;  // Opening quote
+    while (parser.p < parser.end && *parser.p != '"') {
+        char c = *parser.p++;
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+        if (parser.p >= parser.end) {
+            break;
+        }
+        char escape = *parser.p++;
+        switch (escape) {
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'r': out += '\r'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u': {
+                if (parser.end - parser.p < 4) {
+                    return fail_at(parser, "short \\u escape");
+                }
+                std::string hex(parser.p, 4);
+                parser.p += 4;
+                append_utf8(out, (unsigned)strtoul(hex.c_str(), nullptr, 16));
+                break;
+            }
+            default: out += escape; break;
+        }
+    }
+    if (parser.p >= parser.end) {
+        return fail_at(parser, "unterminated string");
+    }
+    parser.p++;  // Closing quote
+    return true;
+}
+
+static bool parse_value(JsonParser& parser, JsonValue& value, int depth) {
+    if (depth > 64) {
+        return fail_at(parser, "nesting too deep");
+    }
+    skip_space(parser);
+    if (parser.p >= parser.end) {
+        return fail_at(parser, "unexpected end");
+    }
+
+    char c = *parser.p;
+    if (c == '{') {
+        value.type = JsonValue::OBJECT;
+        parser.p++;
+        skip_space(parser);
+        if (consume(parser, "}")) {
+            return true;
+        }
+        while (true) {
+            skip_space(parser);
+            if (parser.p >= parser.end || *parser.p != '"') {
+                return fail_at(parser, "expected key");
+            }
+            std::pair<std::string, JsonValue> member;
+            if (!parse_string(parser, member.first)) {
+                return false;
+            }
+            skip_space(parser);
+            if (!consume(parser, ":")) {
+                return fail_at(parser, "expected ':'");
+            }
+            if (!parse_value(parser, member.second, depth + 1)) {
+                return false;
+            }
+            value.members.push_back(std::move(member));
+            skip_space(parser);
+            if (consume(parser, "}")) {
+                return true;
+            }
+            if (!consume(parser, ",")) {
+                return fail_at(parser, "expected ',' or '}'");
+            }
+        }
+    }
+    if (c == '[') {
+        value.type = JsonValue::ARRAY;
+        parser.p++;
+        skip_space(parser);
+        if (consume(parser, "]")) {
+            return true;
+        }
+        while (true) {
+            JsonValue item;
+            if (!parse_value(parser, item, depth + 1)) {
+                return false;
+            }
+            value.items.push_back(std::move(item));
+            skip_space(parser);
+            if (consume(parser, "]")) {
+                return true;
+            }
+            if (!consume(parser, ",")) {
+                return fail_at(parser, "expected ',' or ']'");
+            }
+        }
+    }
+    if (c == '"') {
+        value.type = JsonValue::STRING;
+        return parse_string(parser, value.string);
+    }
+    if (consume(parser, "true")) {
+        value.type = JsonValue::BOOLEAN;
+        value.boolean = true;
+        return true;
+    }
+    if (consume(parser, "false")) {
+        value.type = JsonValue::BOOLEAN;
+        return true;
+    }
+    if (consume(parser, "null")) {
+        value.type = JsonValue::NUL;
+        return true;
+    }
+
+    char* number_end = nullptr;
+    std::string rest(parser.p, std::min<size_t>(parser.end - parser.p, 64));
+    value.number = strtod(rest.c_str(), &number_end);
+    if (number_end == rest.c_str()) {
+        return fail_at(parser, "unexpected character");
+    }
+    value.type = JsonValue::NUMBER;
+    parser.p += number_end - rest.c_str();
+    return true;
+}
+
+static double number_field(const JsonValue& object, const char* key) {
+    const JsonValue* field = object.get(key);
+    return field && field->type == JsonValue::NUMBER ? field->number : 0.0;
+}
+
+static std::string string_field(const JsonValue& object, const char* key) {
+    const JsonValue* field = object.get(key);
+    return field && field->type == JsonValue::STRING ? field->string : std::string();
+}
+
+static BenchmarkMetric read_metric(const JsonValue& object) {
+    BenchmarkMetric metric = {};
+    metric.name = string_field(object, "name");
+    metric.unit = string_field(object, "unit");
+    metric.min_delta = number_field(object, "min_delta");
+
+    const JsonValue* samples = object.get("samples");
+    if (samples && samples->type == JsonValue::ARRAY) {
+        for (const JsonValue& sample : samples->items) {
+            if (sample.type == JsonValue::NUMBER) {
+                metric.samples.push_back(sample.number);
+            }
+        }
+    }
+
+    // Re-summarize the samples; a baseline without them keeps its numbers
+    if (!metric.samples.empty()) {
+        metric.stats = benchmark_stats(metric.samples);
+    } else {
+        metric.stats.count = (size_t)number_field(object, "count");
+        metric.stats.min = number_field(object, "min");
+        metric.stats.median = number_field(object, "median");
+        metric.stats.p90 = number_field(object, "p90");
+        metric.stats.p95 = number_field(object, "p95");
+        metric.stats.p99 = number_field(object, "p99");
+        metric.stats.max = number_field(object, "max");
+        metric.stats.mean = number_field(object, "mean");
+        metric.stats.stddev = number_field(object, "stddev");
+    }
+    return metric;
+}
+
+bool benchmark_read_json(const char* path, std::vector<BenchmarkResult>& results, std::string* error) {
+    std::ifstream in(path ? path : "");
+    if (!in) {
+        if (error) {
+            *error = std::string("cannot open ") + (path ? path : "(null)");
+        }
+        return false;
+    }
+    std::stringstream contents;
+    contents << in.rdbuf();
+    std::string text = contents.str();
+
+    JsonParser parser = {text.data(), text.data(), text.data() + text.size(), ""};
+    JsonValue root;
+    bool parsed = parse_value(parser, root, 0);
+    const JsonValue* benchmarks = parsed ? root.get("benchmarks") : nullptr;
+    if (!benchmarks || benchmarks->type != JsonValue::ARRAY) {
+        if (error) {
+            *error = std::string(path) + ": " + (parsed ? "no \"benchmarks\" array" : parser.error);
+        }
+        return false;
+    }
+
+    results.clear();
+    for (const JsonValue& entry : benchmarks->items) {
+        BenchmarkResult result = {};
+        result.name = string_field(entry, "name");
+        const JsonValue* ok = entry.get("ok");
+        result.ok = !ok || ok->type != JsonValue::BOOLEAN || ok->boolean;
+        result.error = string_field(entry, "error");
+        result.warmup_iterations = (int)number_field(entry, "warmup_iterations");
+        result.iterations = (int)number_field(entry, "iterations");
+
+        const JsonValue* metrics = entry.get("metrics");
+        if (metrics && metrics->type == JsonValue::ARRAY) {
+            for (const JsonValue& metric : metrics->items) {
+                result.metrics.push_back(read_metric(metric));
+            }
+        }
+        results.push_back(result);
+    }
+    return true;
+}
+
+/* ============================================
+ * Comparison
+ * ============================================ */
+
+static const BenchmarkMetric* find_metric(const std::vector<BenchmarkResult>& results,
+                                          const std::string& benchmark, const std::string& metric) {
+    for (const BenchmarkResult& result : results) {
+        if (result.name != benchmark || !result.ok) {
+            continue;
+        }
+        for (const BenchmarkMetric& candidate : result.metrics) {
+            if (candidate.name == metric && candidate.stats.count > 0) {
+                return &candidate;
+            }
+        }
+    }
+    return nullptr;
+}
+
+static BenchmarkVerdict judge(const BenchmarkMetric& base, const BenchmarkMetric& current, double threshold) {
+    double delta = current.stats.median - base.stats.median;
+    double noise = std::max(base.min_delta, current.min_delta);
+    double relative = threshold * std::fabs(base.stats.median);
+
+    if (delta > relative && delta > noise && current.stats.median > base.stats.p90) {
+        return BENCHMARK_REGRESSED;
+    }
+    if (-delta > relative && -delta > noise && current.stats.median < base.stats.min) {
+        return BENCHMARK_IMPROVED;
+    }
+    return BENCHMARK_UNCHANGED;
+}
+
+static bool has_benchmark(const std::vector<BenchmarkResult>& results, const std::string& name) {
+    for (const BenchmarkResult& result : results) {
+        if (result.name == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<BenchmarkComparison> benchmark_compare(const std::vector<BenchmarkResult>& baseline,
+                                                   const std::vector<BenchmarkResult>& current,
+                                                   double threshold) {
+    std::vector<BenchmarkComparison> comparisons;
+
+    for (const BenchmarkResult& result : baseline) {
+        if (!has_benchmark(current, result.name)) {
+            continue;  // Not run this time (filtered out)
+        }
+        for (const BenchmarkMetric& base : result.metrics) {
+            if (base.stats.count == 0) {
+                continue;
+            }
+            BenchmarkComparison comparison = {};
+            comparison.benchmark = result.name;
+            comparison.metric = base.name;
+            comparison.unit = base.unit;
+            comparison.baseline_median = base.stats.median;
+
+            const BenchmarkMetric* now = find_metric(current, result.name, base.name);
+            if (!now) {
+                comparison.verdict = BENCHMARK_MISSING;
+            } else {
+                comparison.current_median = now->stats.median;
+                if (base.stats.median != 0.0) {
+                    comparison.change = now->stats.median / base.stats.median - 1.0;
+                }
+                comparison.verdict = judge(base, *now, threshold);
+            }
+            comparisons.push_back(comparison);
+        }
+    }
+
+    for (const BenchmarkResult& result : current) {
+        for (const BenchmarkMetric& metric : result.metrics) {
+            if (metric.stats.count == 0 || !result.ok || find_metric(baseline, result.name, metric.name)) {
+                continue;
+            }
+            BenchmarkComparison comparison = {};
+            comparison.benchmark = result.name;
+            comparison.metric = metric.name;
+            comparison.unit = metric.unit;
+            comparison.current_median = metric.stats.median;
+            comparison.verdict = BENCHMARK_NEW;
+            comparisons.push_back(comparison);
+        }
+    }
+    return comparisons;
+}
+
+/* ============================================
+ * Reports
+ * ============================================ */
+
+void benchmark_print_results(const std::vector<BenchmarkResult>& results) {
+    printf("\n| Benchmark | Metric | Unit | n | Median | p90 | p99 | Min | Max |\n");
+    printf("|-----------|--------|------|---|--------|-----|-----|-----|-----|\n");
+    for (const BenchmarkResult& result : results) {
+        if (!result.ok) {
+            printf("| %s | FAILED: %s | | | | | | | |\n", result.name.c_str(), result.error.c_str());
+            continue;
+        }
+        for (const BenchmarkMetric& metric : result.metrics) {
+            const BenchmarkStats& s = metric.stats;
+            printf("| %s | %s | %s | %zu | %.2f | %.2f | %.2f | %.2f | %.2f |\n",
+                   result.name.c_str(), metric.name.c_str(), metric.unit.c_str(), s.count,
+                   s.median, s.p90, s.p99, s.min, s.max);
+        }
+    }
+    printf("\n");
+}
+
+int benchmark_print_comparison(const std::vector<BenchmarkComparison>& comparisons) {
+    static const char* const VERDICTS[] = {"ok", "REGRESSED", "improved", "new", "missing"};
+
+    int regressions = 0;
+    printf("\n| Benchmark | Metric | Baseline | Current | Change | Verdict |\n");
+    printf("|-----------|--------|----------|---------|--------|---------|\n");
+    for (const BenchmarkComparison& c : comparisons) {
+        char change[32] = "-";
+        if (c.verdict != BENCHMARK_NEW && c.verdict != BENCHMARK_MISSING && c.baseline_median != 0.0) {
+            snprintf(change, sizeof(change), "%+.1f%%", c.change * 100.0);
+        }
+        printf("| %s | %s | %.2f %s | %.2f %s | %s | %s |\n",
+               c.benchmark.c_str(), c.metric.c_str(),
+               c.baseline_median, c.unit.c_str(), c.current_median, c.unit.c_str(),
+               change, VERDICTS[c.verdict]);
+        if (c.verdict == BENCHMARK_REGRESSED) {
+            regressions++;
+        }
+    }
+    printf("\n");
+    return regressions;
+}
@@ -0,0 +1,190 @@
+/**
+ * WisprFlex Whisper Backend - Benchmark Harness
+ *
+ * Internal header - not part of public API.
+ *
+ * Runs benchmark cases for a number of warm-up iterations (discarded)
+ * and measured iterations, summarizes every metric as median and
+ * percentiles, writes the results as JSON and compares them with a
+ * stored baseline. Every metric is a cost (time, memory, error rate), so
+ * lower is better. No whisper.cpp dependency; the cases that drive the
+ * backend are in tools/benchmark_suite.cpp.
+ */
+
+#ifndef WISPRFLEX_BENCHMARK_HARNESS_H
+#define WISPRFLEX_BENCHMARK_HARNESS_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Default relative change of a median that counts as a regression
+static const double BENCHMARK_DEFAULT_THRESHOLD = 0.10;
+
+/**
+ * Summary of one metric's samples (percentiles interpolate between ranks)
+ */
+struct BenchmarkStats {
+    size_t count;
+    double min;
+    double median;
+    double p90;
+    double p95;
+    double p99;
+    double max;
+    double mean;
+    double stddev;
+};
+
+/**
+ * Summarize samples (all zero when there are none)
+ */
+BenchmarkStats benchmark_stats(const std::vector<double>& samples);
+
+/**
+ * Every measured sample of one metric of one benchmark
+ */
+struct BenchmarkMetric {
+    std::string name;
+    std::string unit;
+    double min_delta;           // Smaller changes of the median never count (noise floor)
+    std::vector<double> samples;
+    BenchmarkStats stats;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    int warmup_iterations;
+    int iterations;             // Measured iterations completed
+    bool ok;
+    std::string error;          // First failure (ok false)
+    std::vector<BenchmarkMetric> metrics;
+};
+
+/**
+ * Handed to a case once per iteration to record its measurements
+ */
+class BenchmarkRecorder {
+public:
+    BenchmarkRecorder(BenchmarkResult& result, bool warming_up);
+
+    /**
+     * Add one sample; an iteration may record a metric any number of times
+     * (e.g. once per chunk). Samples of warm-up iterations are dropped.
+     * @param min_delta Noise floor of the metric, in its unit
+     */
+    void record(const char* metric, const char* unit, double value, double min_delta = 0.0);
+
+    /**
+     * Mark the benchmark failed; no further iterations run
+     */
+    void fail(const std::string& reason);
+
+    bool warming_up() const { return warming_up_; }
+
+private:
+    BenchmarkResult& result_;
+    bool warming_up_;
+};
+
+typedef std::function<void(BenchmarkRecorder&)> BenchmarkBody;
+
+struct BenchmarkOptions {
+    int warmup_iterations = 1;
+    int iterations = 5;
+    std::string filter;         // Run only benchmarks whose name contains this ("" = all)
+};
+
+class BenchmarkSuite {
+public:
+    explicit BenchmarkSuite(const BenchmarkOptions& options);
+
+    /**
+     * Register a case. Cases run in registration order.
+     * @param warmup_iterations, iterations Override the suite options
+     *        (-1 = use them), for cases that only make sense once
+     */
+    void add(const std::string& name, BenchmarkBody body,
+             int warmup_iterations = -1, int iterations = -1);
+
+    std::vector<std::string> names() const;
+
+    /**
+     * Run the matching cases, printing progress
+     */
+    std::vector<BenchmarkResult> run();
+
+private:
+    struct Case {
+        std::string name;
+        BenchmarkBody body;
+        int warmup_iterations;
+        int iterations;
+    };
+
+    BenchmarkOptions options_;
+    std::vector<Case> cases_;
+};
+
+// Key/value pairs stored with the results (model, audio, options, ...)
+typedef std::vector<std::pair<std::string, std::string>> BenchmarkContext;
+
+/**
+ * Write results as JSON (samples included, so a baseline can be re-summarized)
+ * @param error Receives the reason on failure (may be NULL)
+ */
+bool benchmark_write_json(const char* path, const BenchmarkContext& context,
+                          const std::vector<BenchmarkResult>& results, std::string* error = nullptr);
+
+/**
+ * Read results written by benchmark_write_json
+ * @param error Receives the reason on failure (may be NULL)
+ */
+bool benchmark_read_json(const char* path, std::vector<BenchmarkResult>& results,
+                         std::string* error = nullptr);
+
+enum BenchmarkVerdict {
+    BENCHMARK_UNCHANGED = 0,
+    BENCHMARK_REGRESSED,
+    BENCHMARK_IMPROVED,
+    BENCHMARK_NEW,              // Not in the baseline
+    BENCHMARK_MISSING           // In the baseline, not measured now (or the benchmark failed)
+};
+
+/**
+ * One metric, baseline against current
+ */
+struct BenchmarkComparison {
+    std::string benchmark;
+    std::string metric;
+    std::string unit;
+    double baseline_median;
+    double current_median;
+    double change;              // Relative change of the median (0.1 = 10% slower/larger)
+    BenchmarkVerdict verdict;
+};
+
+/**
+ * Compare medians metric by metric. A change counts when the medians
+ * differ by more than threshold (relative) and min_delta (absolute) and
+ * the current median lies outside the baseline's min..p90 spread.
+ * Baseline benchmarks that were not run at all are left out.
+ */
+std::vector<BenchmarkComparison> benchmark_compare(const std::vector<BenchmarkResult>& baseline,
+                                                   const std::vector<BenchmarkResult>& current,
+                                                   double threshold = BENCHMARK_DEFAULT_THRESHOLD);
+
+/**
+ * Print a table of every metric's statistics
+ */
+void benchmark_print_results(const std::vector<BenchmarkResult>& results);
+
+/**
+ * Print a comparison table
+ * @return Number of regressions
+ */
+int benchmark_print_comparison(const std::vector<BenchmarkComparison>& comparisons);
+
+#endif // WISPRFLEX_BENCHMARK_HARNESS_H
@@ -0,0 +1,96 @@
+/**
+ * WisprFlex Whisper Backend - Lock-free Latency Metrics
+ *
+ * Bucket layout (HdrHistogram's): bucket 0 holds values 0..31 exactly.
+ * Bucket b >= 1 covers [2^(b+4), 2^(b+5)) in 16 sub-buckets of width 2^b,
+ * indexed by value >> b (16..31), so index = b * 16 + (value >> b).
+ */
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+static int highest_bit(uint64_t value) {
+    int bit = -1;
+    while (value != 0) {
+        value >>= 1;
+        bit++;
+    }
+    return bit;
+}
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+int LatencyHistogram::bucket_index(uint64_t value_us) {
+    const uint64_t max_value = ((uint64_t)1 << LATENCY_MAX_BITS) - 1;
+    value_us = std::min(value_us, max_value);
+
+    int bucket = std::max(0, highest_bit(value_us) - LATENCY_SUB_BUCKET_BITS + 1);
+    int sub_bucket = (int)(value_us >> bucket);
+    return bucket * (LATENCY_SUB_BUCKETS / 2) + sub_bucket;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(int index) {
+    const int half = LATENCY_SUB_BUCKETS / 2;
+    if (index < LATENCY_SUB_BUCKETS) {
+        return (uint64_t)index;
+    }
+    int bucket = index / half - 1;
+    int sub_bucket = index % half + half;
+    return (((uint64_t)sub_bucket + 1) << bucket) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value_us) {
+    counts_[bucket_index(value_us)].fetch_add(1, std::memory_order_relaxed);
+    total_us_.fetch_add(value_us, std::memory_order_relaxed);
+
+    uint64_t max = max_us_.load(std::memory_order_relaxed);
+    while (value_us > max &&
+           !max_us_.compare_exchange_weak(max, value_us, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& count : counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    total_us_.store(0, std::memory_order_relaxed);
+    max_us_.store(0, std::memory_order_relaxed);
+}
+
+LatencySummary LatencyHistogram::summarize() const {
+    LatencySummary summary = {};
+
+    // Percentiles come from one pass over a copy, so they stay ordered
+    // even while values are being added
+    uint64_t counts[LATENCY_BUCKETS];
+    uint64_t count = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        counts[i] = counts_[i].load(std::memory_order_relaxed);
+        count += counts[i];
+    }
+    if (count == 0) {
+        return summary;
+    }
+
+    summary.count = count;
+    summary.mean_us = (double)total_us_.load(std::memory_order_relaxed) / (double)count;
+    summary.max_us = (double)max_us_.load(std::memory_order_relaxed);
+
+    const double quantiles[] = {0.50, 0.90, 0.99, 0.999};
+    double* outputs[] = {&summary.p50_us, &summary.p90_us, &summary.p99_us, &summary.p999_us};
+
+    uint64_t seen = 0;
+    int next = 0;
+    for (int i = 0; i < LATENCY_BUCKETS && next < 4; i++) {
+        seen += counts[i];
+        while (next < 4 && seen >= (uint64_t)std::ceil(quantiles[next] * (double)count)) {
+            *outputs[next] = std::min((double)bucket_upper_bound(i), summary.max_us);
+            next++;
+        }
+    }
+    return summary;
+}
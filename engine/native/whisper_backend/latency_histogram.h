@@ -0,0 +1,140 @@
+/**
+ * WisprFlex Whisper Backend - Lock-free Latency Metrics
+ *
+ * Internal header - not part of public API.
+ *
+ * LatencyHistogram counts microsecond latencies in HDR-style log-linear
+ * buckets: every power of two is split into LATENCY_SUB_BUCKETS / 2
+ * linear steps, so any recorded value is reported within about 6% from
+ * 1 us up to days, in a fixed 5 KB table. Recording is a few relaxed
+ * atomic adds; readers walk the counts without stopping writers.
+ *
+ * SeqLocked<T> publishes a trivially copyable struct to readers that
+ * never block the (externally serialized) writer: a reader retries if the
+ * sequence number was odd or changed while it copied. The copy goes
+ * through relaxed atomic words, so a torn read is discarded rather than
+ * being a data race. No whisper.cpp dependency.
+ */
+
+#ifndef WISPRFLEX_LATENCY_HISTOGRAM_H
+#define WISPRFLEX_LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Values below LATENCY_SUB_BUCKETS us are counted exactly
+static const int LATENCY_SUB_BUCKET_BITS = 5;
+static const int LATENCY_SUB_BUCKETS = 1 << LATENCY_SUB_BUCKET_BITS;
+
+// Largest tracked value: 2^40 us (about 12 days); larger values saturate
+static const int LATENCY_MAX_BITS = 40;
+static const int LATENCY_BUCKETS =
+    (LATENCY_MAX_BITS - LATENCY_SUB_BUCKET_BITS + 2) * (LATENCY_SUB_BUCKETS / 2);
+
+/**
+ * Percentiles of a histogram at one point in time
+ */
+struct LatencySummary {
+    uint64_t count;
+    double mean_us;
+    double p50_us;
+    double p90_us;
+    double p99_us;
+    double p999_us;
+    double max_us;
+};
+
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    /**
+     * Count one value (any thread, lock-free)
+     */
+    void record(uint64_t value_us);
+
+    /**
+     * Forget all values. Values recorded concurrently may survive.
+     */
+    void reset();
+
+    /**
+     * Percentiles of the values recorded so far (any thread). Each is the
+     * upper edge of its bucket, capped at the largest recorded value.
+     */
+    LatencySummary summarize() const;
+
+    /**
+     * Bucket of a value, and the largest value sharing that bucket
+     * (exposed for tests)
+     */
+    static int bucket_index(uint64_t value_us);
+    static uint64_t bucket_upper_bound(int index);
+
+private:
+    std::atomic<uint64_t> counts_[LATENCY_BUCKETS];
+    std::atomic<uint64_t> total_us_;
+    std::atomic<uint64_t> max_us_;
+};
+
+/**
+ * Single-writer, wait-free-reader snapshot of a plain struct
+ */
+template <typename T>
+class SeqLocked {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLocked needs a trivially copyable type");
+
+public:
+    SeqLocked() : sequence_(0) {
+        for (auto& word : words_) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Publish a new value. Writers must be serialized by the caller.
+     */
+    void store(const T& value) {
+        uint64_t buffer[WORDS] = {};
+        memcpy(buffer, &value, sizeof(T));
+
+        uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * Copy of the last published value (any thread, never blocks the writer)
+     */
+    T load() const {
+        uint64_t buffer[WORDS];
+        uint64_t before, after;
+        do {
+            before = sequence_.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; i++) {
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence_.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+
+        T value;
+        memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+private:
+    static const size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> sequence_;
+    std::atomic<uint64_t> words_[WORDS];
+};
+
+#endif // WISPRFLEX_LATENCY_HISTOGRAM_H
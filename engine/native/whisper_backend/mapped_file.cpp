@@ -0,0 +1,124 @@
+/**
+ * WisprFlex Whisper Backend - Read-only File Mapping
+ */
+
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const char* path) {
+    close();
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    // The mapping object keeps the file open
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    mapping_ = mapping;
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = (size_t)file_size.QuadPart;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_) {
+        CloseHandle(mapping_);
+    }
+    mapping_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#else
+
+bool MappedFile::open(const char* path) {
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // The mapping keeps the file referenced after the descriptor closes
+    void* addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    // Weights are read front to back once: read ahead aggressively
+    madvise(addr, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    data_ = static_cast<const uint8_t*>(addr);
+    size_ = (size_t)st.st_size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif
+
+size_t MappedFileReader::read(void* output, size_t read_size) {
+    if (eof()) {
+        return 0;
+    }
+
+    size_t n = std::min(read_size, file->size() - offset);
+    memcpy(output, file->data() + offset, n);
+    offset += n;
+    return n;
+}
@@ -0,0 +1,60 @@
+/**
+ * WisprFlex Whisper Backend - Read-only File Mapping
+ *
+ * Internal header - not part of public API.
+ *
+ * Maps a model file read-only so its pages come from the OS page cache,
+ * which is shared by every process reading the same file and survives
+ * between loads. No whisper.cpp dependency.
+ */
+
+#ifndef WISPRFLEX_MAPPED_FILE_H
+#define WISPRFLEX_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Map path read-only (replaces any current mapping)
+     * @return false if the file cannot be opened or mapped
+     */
+    bool open(const char* path);
+
+    /**
+     * Unmap; pages stay in the page cache for the next load
+     */
+    void close();
+
+    bool is_open() const { return data_ != nullptr; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* mapping_ = nullptr;
+#endif
+};
+
+/**
+ * Sequential reader over a mapping, in the shape of whisper's
+ * whisper_model_loader callbacks
+ */
+struct MappedFileReader {
+    const MappedFile* file = nullptr;
+    size_t offset = 0;
+
+    size_t read(void* output, size_t read_size);
+    bool eof() const { return !file || offset >= file->size(); }
+};
+
+#endif /* WISPRFLEX_MAPPED_FILE_H */
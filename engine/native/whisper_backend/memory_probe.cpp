@@ -0,0 +1,164 @@
+/**
+ * WisprFlex Whisper Backend - Process Memory Probe
+ *
+ * Linux reads /proc/self/status, whose Rss* lines split resident memory
+ * by page type (kernel 4.5+). Older kernels fall back to /proc/self/statm,
+ * where the "shared" column counts file-backed and shmem pages together.
+ *
+ * The kernel only folds the current RSS into VmHWM on some unmaps, so a
+ * peak freed through others can be missed; the reported peak is also
+ * kept at least as high as any resident value this probe has read.
+ */
+
+#include "memory_probe.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+
+/**
+ * Value of a "Name:   1234 kB" line, in bytes
+ */
+static bool parse_kb_line(const char* line, const char* name, size_t& out_bytes) {
+    size_t length = strlen(name);
+    if (strncmp(line, name, length) != 0 || line[length] != ':') {
+        return false;
+    }
+    unsigned long long kb = 0;
+    if (sscanf(line + length + 1, "%llu", &kb) != 1) {
+        return false;
+    }
+    out_bytes = (size_t)kb * 1024;
+    return true;
+}
+
+static bool read_status(MemoryUsage& usage) {
+    FILE* f = fopen("/proc/self/status", "r");
+    if (!f) {
+        return false;
+    }
+    bool has_rss = false;
+    bool has_split = false;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        has_rss |= parse_kb_line(line, "VmRSS", usage.resident_bytes);
+        has_split |= parse_kb_line(line, "RssAnon", usage.anonymous_bytes);
+        parse_kb_line(line, "RssFile", usage.file_bytes);
+        parse_kb_line(line, "RssShmem", usage.shmem_bytes);
+        parse_kb_line(line, "VmHWM", usage.peak_resident_bytes);
+    }
+    fclose(f);
+
+    if (has_rss && !has_split) {
+        long pages_total = 0;
+        long pages_resident = 0;
+        long pages_shared = 0;
+        FILE* statm = fopen("/proc/self/statm", "r");
+        if (statm) {
+            if (fscanf(statm, "%ld %ld %ld", &pages_total, &pages_resident, &pages_shared) == 3) {
+                size_t page = (size_t)sysconf(_SC_PAGESIZE);
+                usage.file_bytes = std::min((size_t)pages_shared * page, usage.resident_bytes);
+                usage.anonymous_bytes = usage.resident_bytes - usage.file_bytes;
+            }
+            fclose(statm);
+        }
+    }
+    return has_rss;
+}
+
+static void read_proportional(MemoryUsage& usage) {
+    FILE* f = fopen("/proc/self/smaps_rollup", "r");
+    if (!f) {
+        return;     // Kernel before 4.14
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        if (parse_kb_line(line, "Pss", usage.proportional_bytes)) {
+            break;
+        }
+    }
+    fclose(f);
+}
+
+#endif
+
+static std::atomic<size_t> g_observed_peak{0};
+
+/**
+ * Raise the peak to the largest resident value read so far
+ */
+static void track_peak(MemoryUsage& usage) {
+    size_t seen = g_observed_peak.load(std::memory_order_relaxed);
+    while (usage.resident_bytes > seen &&
+           !g_observed_peak.compare_exchange_weak(seen, usage.resident_bytes, std::memory_order_relaxed)) {
+    }
+    usage.peak_resident_bytes = std::max({usage.peak_resident_bytes, usage.resident_bytes, seen});
+}
+
+bool memory_probe_read(MemoryUsage& usage, bool include_proportional) {
+    memset(&usage, 0, sizeof(usage));
+
+#if defined(_WIN32)
+    (void)include_proportional;
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc))) {
+        return false;
+    }
+    usage.resident_bytes = pmc.WorkingSetSize;
+    usage.anonymous_bytes = std::min<size_t>(pmc.PrivateUsage, pmc.WorkingSetSize);
+    usage.file_bytes = usage.resident_bytes - usage.anonymous_bytes;
+    usage.peak_resident_bytes = pmc.PeakWorkingSetSize;
+    track_peak(usage);
+    return true;
+#elif defined(__APPLE__)
+    (void)include_proportional;
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  (task_info_t)&info, &count) != KERN_SUCCESS) {
+        return false;
+    }
+    usage.resident_bytes = info.resident_size;
+    usage.anonymous_bytes = info.resident_size;  // No split without walking regions
+    usage.peak_resident_bytes = info.resident_size_max;
+    track_peak(usage);
+    return true;
+#elif defined(__linux__)
+    if (!read_status(usage)) {
+        return false;
+    }
+    if (include_proportional) {
+        read_proportional(usage);
+    }
+    track_peak(usage);
+    return true;
+#else
+    (void)include_proportional;
+    return false;
+#endif
+}
+
+size_t memory_resident_kb() {
+    MemoryUsage usage;
+    return memory_probe_read(usage) ? usage.resident_bytes / 1024 : 0;
+}
+
+size_t memory_peak_kb() {
+    MemoryUsage usage;
+    return memory_probe_read(usage) ? usage.peak_resident_bytes / 1024 : 0;
+}
@@ -0,0 +1,50 @@
+/**
+ * WisprFlex Whisper Backend - Process Memory Probe
+ *
+ * Internal header - not part of public API.
+ *
+ * Reads this process's memory the way the OS accounts it. On Linux
+ * resident memory comes from /proc/self/status (RssAnon, RssFile,
+ * RssShmem, VmHWM) and the proportional set size from
+ * /proc/self/smaps_rollup, which is what cgroup limits and the OOM
+ * killer see. Windows and macOS fill what their APIs report. Shared by
+ * the backend metrics and the test and benchmark programs. No
+ * whisper.cpp dependency.
+ */
+
+#ifndef WISPRFLEX_MEMORY_PROBE_H
+#define WISPRFLEX_MEMORY_PROBE_H
+
+#include <cstddef>
+
+/**
+ * One reading of process memory (bytes; zero where not reported)
+ */
+struct MemoryUsage {
+    size_t resident_bytes;      // RSS
+    size_t anonymous_bytes;     // Resident private pages: heap, stacks, whisper's weight copy
+    size_t file_bytes;          // Resident file-backed pages (mapped models), shared via page cache
+    size_t shmem_bytes;         // Resident shared memory (Linux)
+    size_t proportional_bytes;  // PSS: resident, shared pages divided among their users
+    size_t peak_resident_bytes; // RSS high-water mark since process start (at least every reading)
+};
+
+/**
+ * Read current memory
+ * @param include_proportional Also read PSS; on Linux this walks every
+ *        mapping (smaps_rollup), so leave it off on hot paths
+ * @return false if the platform reported nothing
+ */
+bool memory_probe_read(MemoryUsage& usage, bool include_proportional = false);
+
+/**
+ * Resident memory in KB (0 if unknown), for test and benchmark output
+ */
+size_t memory_resident_kb();
+
+/**
+ * Peak resident memory in KB (0 if unknown)
+ */
+size_t memory_peak_kb();
+
+#endif // WISPRFLEX_MEMORY_PROBE_H
@@ -0,0 +1,243 @@
+/**
+ * WisprFlex Whisper Backend - Pipeline Tracing
+ *
+ * Every capture has a generation number. A thread's first event of a
+ * generation registers a fresh buffer (the only locked step); after that
+ * it appends with a release store of the count, so trace_write_json can
+ * read everything below an acquired count while the thread keeps
+ * writing. Buffers are shared_ptrs held by both the registry and the
+ * thread, so threads may exit mid-capture and late events of an old
+ * capture land in a buffer nobody reads any more.
+ */
+
+#include "trace.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> g_trace_capturing{false};
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    const char* arg_name;
+    int64_t ts_us;
+    int64_t dur_us;
+    int64_t arg_value;
+    uint64_t flow_id;
+    char phase;         // Chrome trace-event phase: X, i, s, f
+};
+
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    uint64_t generation = 0;
+    std::atomic<const char*> thread_name{nullptr};
+    std::unique_ptr<TraceEvent[]> events;
+    size_t capacity = 0;
+    std::atomic<size_t> count{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+static std::mutex g_registry_mutex;
+static std::vector<std::shared_ptr<ThreadBuffer>> g_buffers;  // Current capture
+static size_t g_capacity = TRACE_DEFAULT_EVENTS_PER_THREAD;
+static uint32_t g_next_tid = 1;
+
+static std::atomic<uint64_t> g_generation{0};
+static std::atomic<int64_t> g_epoch_ns{0};
+static std::atomic<uint64_t> g_next_flow_id{1};
+
+static thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+static thread_local const char* t_thread_name = nullptr;
+static thread_local uint32_t t_tid = 0;
+
+static int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * This thread's buffer for the running capture (registers on first use)
+ */
+static ThreadBuffer* thread_buffer() {
+    uint64_t generation = g_generation.load(std::memory_order_acquire);
+    if (t_buffer && t_buffer->generation == generation) {
+        return t_buffer.get();
+    }
+
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    generation = g_generation.load(std::memory_order_relaxed);
+    if (t_tid == 0) {
+        t_tid = g_next_tid++;
+    }
+    auto buffer = std::make_shared<ThreadBuffer>();
+    buffer->tid = t_tid;
+    buffer->generation = generation;
+    buffer->thread_name.store(t_thread_name, std::memory_order_relaxed);
+    buffer->capacity = g_capacity;
+    buffer->events.reset(new TraceEvent[g_capacity]);
+    g_buffers.push_back(buffer);
+    t_buffer = std::move(buffer);
+    return t_buffer.get();
+}
+
+static void append(const TraceEvent& event) {
+    ThreadBuffer* buffer = thread_buffer();
+    size_t index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= buffer->capacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[index] = event;
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+static void write_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const char* p = text ? text : ""; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+        } else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void write_event(FILE* out, uint32_t tid, const TraceEvent& event) {
+    fprintf(out, "{\"ph\":\"%c\",\"pid\":1,\"tid\":%" PRIu32 ",\"ts\":%" PRId64 ",\"name\":",
+            event.phase, tid, event.ts_us);
+    write_string(out, event.name);
+    fprintf(out, ",\"cat\":");
+    write_string(out, event.category);
+    switch (event.phase) {
+        case 'X':
+            fprintf(out, ",\"dur\":%" PRId64, event.dur_us);
+            break;
+        case 'i':
+            fprintf(out, ",\"s\":\"t\"");
+            break;
+        case 'f':
+            fprintf(out, ",\"bp\":\"e\",\"id\":%" PRIu64, event.flow_id);
+            break;
+        default:
+            fprintf(out, ",\"id\":%" PRIu64, event.flow_id);
+            break;
+    }
+    if (event.arg_name) {
+        fprintf(out, ",\"args\":{");
+        write_string(out, event.arg_name);
+        fprintf(out, ":%" PRId64 "}", event.arg_value);
+    }
+    fputc('}', out);
+}
+
+void trace_start(size_t events_per_thread) {
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    g_capacity = events_per_thread > 0 ? events_per_thread : TRACE_DEFAULT_EVENTS_PER_THREAD;
+    g_buffers.clear();
+    g_epoch_ns.store(steady_ns(), std::memory_order_relaxed);
+    g_generation.fetch_add(1, std::memory_order_release);
+    g_trace_capturing.store(true, std::memory_order_release);
+}
+
+void trace_stop() {
+    g_trace_capturing.store(false, std::memory_order_release);
+}
+
+bool trace_write_json(const char* path, std::string* error) {
+    FILE* out = path ? fopen(path, "w") : nullptr;
+    if (!out) {
+        if (error) {
+            *error = std::string("cannot open ") + (path ? path : "(null)");
+        }
+        return false;
+    }
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(g_registry_mutex);
+        buffers = g_buffers;
+    }
+
+    uint64_t dropped = 0;
+    bool first = true;
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (const auto& buffer : buffers) {
+        const char* thread_name = buffer->thread_name.load(std::memory_order_relaxed);
+        if (thread_name) {
+            fprintf(out, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%" PRIu32 ",\"name\":\"thread_name\",\"args\":{\"name\":",
+                    first ? "" : ",\n", buffer->tid);
+            write_string(out, thread_name);
+            fprintf(out, "}}");
+            first = false;
+        }
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            fprintf(out, "%s", first ? "" : ",\n");
+            write_event(out, buffer->tid, buffer->events[i]);
+            first = false;
+        }
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    fprintf(out, "\n],\"otherData\":{\"dropped_events\":\"%" PRIu64 "\"}}\n", dropped);
+
+    bool ok = !ferror(out);
+    ok = fclose(out) == 0 && ok;
+    if (!ok && error) {
+        *error = std::string("cannot write ") + path;
+    }
+    return ok;
+}
+
+int64_t trace_now_us() {
+    return (steady_ns() - g_epoch_ns.load(std::memory_order_relaxed)) / 1000;
+}
+
+void trace_set_thread_name(const char* name) {
+    t_thread_name = name;
+    if (t_buffer) {
+        t_buffer->thread_name.store(name, std::memory_order_relaxed);
+    }
+}
+
+void trace_complete(const char* name, const char* category, int64_t start_us, int64_t duration_us,
+                    const char* arg_name, int64_t arg_value) {
+    if (!trace_enabled()) {
+        return;
+    }
+    append({name, category, arg_name, start_us, duration_us, arg_value, 0, 'X'});
+}
+
+void trace_instant(const char* name, const char* category) {
+    if (!trace_enabled()) {
+        return;
+    }
+    append({name, category, nullptr, trace_now_us(), 0, 0, 0, 'i'});
+}
+
+void trace_flow_start(const char* name, uint64_t id) {
+    if (!trace_enabled()) {
+        return;
+    }
+    append({name, "flow", nullptr, trace_now_us(), 0, 0, id, 's'});
+}
+
+void trace_flow_end(const char* name, uint64_t id) {
+    if (!trace_enabled()) {
+        return;
+    }
+    append({name, "flow", nullptr, trace_now_us(), 0, 0, id, 'f'});
+}
+
+uint64_t trace_next_flow_id() {
+    return g_next_flow_id.fetch_add(1, std::memory_order_relaxed);
+}
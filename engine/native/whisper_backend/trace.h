@@ -0,0 +1,118 @@
+/**
+ * WisprFlex Whisper Backend - Pipeline Tracing
+ *
+ * Internal header - not part of public API.
+ *
+ * Opt-in event capture written as Chrome trace-event JSON, which
+ * chrome://tracing and ui.perfetto.dev open directly. Each thread
+ * records into its own fixed-size buffer (single writer, no locks after
+ * the thread's first event of a capture); a full buffer drops further
+ * events and counts them. While no capture is running every call is one
+ * relaxed atomic load.
+ *
+ * Names, categories and argument names must be string literals (or
+ * otherwise outlive the capture): only the pointers are stored. Shared
+ * by the engine and whisper_backend, so a capture spans both. No
+ * whisper.cpp dependency.
+ */
+
+#ifndef WISPRFLEX_TRACE_H
+#define WISPRFLEX_TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Events each thread keeps per capture when none is requested (~3 MB/thread)
+static const size_t TRACE_DEFAULT_EVENTS_PER_THREAD = 65536;
+
+extern std::atomic<bool> g_trace_capturing;
+
+/**
+ * True while a capture is running (any thread, one relaxed load)
+ */
+inline bool trace_enabled() {
+    return g_trace_capturing.load(std::memory_order_relaxed);
+}
+
+/**
+ * Start a new capture, discarding the previous one
+ * @param events_per_thread Buffer size (0 = TRACE_DEFAULT_EVENTS_PER_THREAD)
+ */
+void trace_start(size_t events_per_thread);
+
+/**
+ * Stop recording; the capture stays available to trace_write_json
+ */
+void trace_stop();
+
+/**
+ * Write the current capture as Chrome trace-event JSON. May run while
+ * recording continues; events still being written are left out.
+ * @param error Receives the reason on failure (may be NULL)
+ */
+bool trace_write_json(const char* path, std::string* error = nullptr);
+
+/**
+ * Microseconds on the trace clock (steady, since the capture started)
+ */
+int64_t trace_now_us();
+
+/**
+ * Label this thread's track (kept across captures)
+ */
+void trace_set_thread_name(const char* name);
+
+/**
+ * A finished span [start_us, start_us + duration_us) on this thread,
+ * with an optional numeric argument (arg_name NULL = none)
+ */
+void trace_complete(const char* name, const char* category, int64_t start_us, int64_t duration_us,
+                    const char* arg_name = nullptr, int64_t arg_value = 0);
+
+/**
+ * A point event on this thread
+ */
+void trace_instant(const char* name, const char* category);
+
+/**
+ * Arrow from the span enclosing trace_flow_start to the span enclosing
+ * the trace_flow_end with the same id, typically on another thread
+ */
+void trace_flow_start(const char* name, uint64_t id);
+void trace_flow_end(const char* name, uint64_t id);
+
+/**
+ * Ids for trace_flow_start (unique within the process)
+ */
+uint64_t trace_next_flow_id();
+
+/**
+ * Span covering the enclosing scope (nothing recorded when tracing is off)
+ */
+class TraceScope {
+public:
+    TraceScope(const char* name, const char* category,
+               const char* arg_name = nullptr, int64_t arg_value = 0)
+        : name_(name), category_(category), arg_name_(arg_name), arg_value_(arg_value),
+          start_us_(trace_enabled() ? trace_now_us() : -1) {}
+
+    ~TraceScope() {
+        if (start_us_ >= 0) {
+            trace_complete(name_, category_, start_us_, trace_now_us() - start_us_, arg_name_, arg_value_);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    const char* category_;
+    const char* arg_name_;
+    int64_t arg_value_;
+    int64_t start_us_;
+};
+
+#endif // WISPRFLEX_TRACE_H
@@ -0,0 +1,359 @@
+/**
+ * WisprFlex Whisper Backend - Voice Activity Detection
+ *
+ * Kernels compute sum of squares and sign changes in one pass.
+ * Each vector step loads x[i..] and x[i+1..]; sign bits of their XOR
+ * mark zero crossings. Float lane sums are flushed to a double every
+ * VAD_BLOCK_SAMPLES so precision does not degrade with buffer length.
+ */
+
+#include "vad.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WF_VAD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// AVX2 is compiled per function and selected at runtime (GCC/Clang), or
+// used directly when the whole build targets it (MSVC /arch:AVX2)
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define WF_VAD_AVX2 1
+#define WF_VAD_AVX2_RUNTIME 1
+#define WF_VAD_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(__AVX2__)
+#define WF_VAD_AVX2 1
+#define WF_VAD_TARGET_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#define WF_VAD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Samples per float accumulation block: at most 128 adds per lane keeps
+// the relative error of a block sum below ~1e-5
+static const size_t VAD_BLOCK_SAMPLES = 512;
+
+typedef void (*VadKernel)(const float* x, size_t n, double* sum_sq, uint64_t* crossings);
+
+static inline uint32_t sign_bit(float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits >> 31;
+}
+
+static inline int popcount32(uint32_t m) {
+    m = m - ((m >> 1) & 0x55555555u);
+    m = (m & 0x33333333u) + ((m >> 2) & 0x33333333u);
+    return (int)((((m + (m >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+}
+
+/**
+ * Scalar remainder from index i, accumulated in double
+ * (also the reference and the kernel for CPUs without SIMD)
+ */
+static void features_tail(const float* x, size_t i, size_t n, double* sum_sq, uint64_t* crossings) {
+    double total = 0.0;
+    uint64_t zc = 0;
+    for (; i < n; i++) {
+        total += (double)x[i] * (double)x[i];
+        if (i + 1 < n) {
+            zc += sign_bit(x[i]) ^ sign_bit(x[i + 1]);
+        }
+    }
+    *sum_sq += total;
+    *crossings += zc;
+}
+
+#if !defined(WF_VAD_SSE2) && !defined(WF_VAD_NEON)
+static void features_scalar(const float* x, size_t n, double* sum_sq, uint64_t* crossings) {
+    features_tail(x, 0, n, sum_sq, crossings);
+}
+#endif
+
+#ifdef WF_VAD_SSE2
+static void features_sse2(const float* x, size_t n, double* sum_sq, uint64_t* crossings) {
+    size_t i = 0;
+    uint64_t zc = 0;
+    double total = 0.0;
+
+    // Needs x[i + 4] for the shifted load
+    while (i + 4 < n) {
+        size_t end = std::min(n - 1, i + VAD_BLOCK_SAMPLES);
+        __m128 acc = _mm_setzero_ps();
+        for (; i + 4 <= end; i += 4) {
+            __m128 a = _mm_loadu_ps(x + i);
+            __m128 b = _mm_loadu_ps(x + i + 1);
+            acc = _mm_add_ps(acc, _mm_mul_ps(a, a));
+            zc += popcount32((uint32_t)_mm_movemask_ps(_mm_xor_ps(a, b)));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, acc);
+        total += (double)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+
+    *sum_sq += total;
+    *crossings += zc;
+    features_tail(x, i, n, sum_sq, crossings);
+}
+#endif
+
+#ifdef WF_VAD_AVX2
+WF_VAD_TARGET_AVX2
+static void features_avx2(const float* x, size_t n, double* sum_sq, uint64_t* crossings) {
+    size_t i = 0;
+    uint64_t zc = 0;
+    double total = 0.0;
+
+    // Needs x[i + 8] for the shifted load
+    while (i + 8 < n) {
+        size_t end = std::min(n - 1, i + VAD_BLOCK_SAMPLES);
+        __m256 acc = _mm256_setzero_ps();
+        for (; i + 8 <= end; i += 8) {
+            __m256 a = _mm256_loadu_ps(x + i);
+            __m256 b = _mm256_loadu_ps(x + i + 1);
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(a, a));
+            zc += popcount32((uint32_t)_mm256_movemask_ps(_mm256_xor_ps(a, b)));
+        }
+        float lanes[8];
+        _mm256_storeu_ps(lanes, acc);
+        total += (double)lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+                 (double)lanes[4] + lanes[5] + lanes[6] + lanes[7];
+    }
+
+    *sum_sq += total;
+    *crossings += zc;
+    features_tail(x, i, n, sum_sq, crossings);
+}
+#endif
+
+#ifdef WF_VAD_NEON
+static void features_neon(const float* x, size_t n, double* sum_sq, uint64_t* crossings) {
+    size_t i = 0;
+    uint64_t zc = 0;
+    double total = 0.0;
+
+    // Needs x[i + 4] for the shifted load
+    while (i + 4 < n) {
+        size_t end = std::min(n - 1, i + VAD_BLOCK_SAMPLES);
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        uint32x4_t signs = vdupq_n_u32(0);
+        for (; i + 4 <= end; i += 4) {
+            float32x4_t a = vld1q_f32(x + i);
+            float32x4_t b = vld1q_f32(x + i + 1);
+            acc = vmlaq_f32(acc, a, a);
+            uint32x4_t diff = veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b));
+            signs = vaddq_u32(signs, vshrq_n_u32(diff, 31));
+        }
+        float lanes[4];
+        uint32_t counts[4];
+        vst1q_f32(lanes, acc);
+        vst1q_u32(counts, signs);
+        total += (double)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        zc += (uint64_t)counts[0] + counts[1] + counts[2] + counts[3];
+    }
+
+    *sum_sq += total;
+    *crossings += zc;
+    features_tail(x, i, n, sum_sq, crossings);
+}
+#endif
+
+struct KernelChoice {
+    VadKernel kernel;
+    const char* name;
+};
+
+static KernelChoice select_kernel() {
+#ifdef WF_VAD_AVX2
+#ifdef WF_VAD_AVX2_RUNTIME
+    if (__builtin_cpu_supports("avx2"))
+#endif
+    {
+        return {features_avx2, "avx2"};
+    }
+#endif
+#if defined(WF_VAD_SSE2)
+    return {features_sse2, "sse2"};
+#elif defined(WF_VAD_NEON)
+    return {features_neon, "neon"};
+#else
+    return {features_scalar, "scalar"};
+#endif
+}
+
+static const KernelChoice& kernel() {
+    static const KernelChoice choice = select_kernel();
+    return choice;
+}
+
+static VadFeatures make_features(size_t n, double sum_sq, uint64_t crossings) {
+    VadFeatures features;
+    features.energy = n > 0 ? sum_sq / (double)n : 0.0;
+    features.zcr = n > 1 ? (float)((double)crossings / (double)(n - 1)) : 0.0f;
+    return features;
+}
+
+VadFeatures vad_compute_features(const float* pcm, size_t n_samples) {
+    double sum_sq = 0.0;
+    uint64_t crossings = 0;
+    if (pcm && n_samples > 0) {
+        kernel().kernel(pcm, n_samples, &sum_sq, &crossings);
+    }
+    return make_features(n_samples, sum_sq, crossings);
+}
+
+VadFeatures vad_compute_features_reference(const float* pcm, size_t n_samples) {
+    double sum_sq = 0.0;
+    uint64_t crossings = 0;
+    if (pcm && n_samples > 0) {
+        features_tail(pcm, 0, n_samples, &sum_sq, &crossings);
+    }
+    return make_features(n_samples, sum_sq, crossings);
+}
+
+const char* vad_kernel_name(void) {
+    return kernel().name;
+}
+
+/* ============================================
+ * Detector
+ * ============================================ */
+
+VadConfig vad_default_config(void) {
+    VadConfig config;
+    config.min_energy = 0.001f;     // RMS ~0.03, the fixed wb_is_silent threshold
+    config.threshold_ratio = 3.0f;  // ~5 dB above the noise floor
+    config.loud_ratio = 10.0f;      // Loud fricatives still count as speech
+    config.max_speech_zcr = 0.35f;  // White noise is ~0.5, voiced speech < 0.2
+    config.floor_attack = 0.1f;     // ~10 frames (300 ms) to follow new noise
+    config.floor_release = 0.0002f; // ~2.5 min to adapt during continuous speech
+    return config;
+}
+
+VoiceDetector::VoiceDetector(const VadConfig& config) : config_(config) {
+    reset();
+}
+
+void VoiceDetector::reset() {
+    noise_floor_ = config_.min_energy;
+    last_ = VadFeatures{0.0, 0.0f};
+}
+
+double VoiceDetector::threshold() const {
+    return std::max((double)config_.min_energy, noise_floor_ * config_.threshold_ratio);
+}
+
+bool VoiceDetector::is_speech(const VadFeatures& features) const {
+    double limit = threshold();
+    if (features.energy <= limit) {
+        return false;
+    }
+    return features.zcr <= config_.max_speech_zcr ||
+           features.energy > limit * config_.loud_ratio;
+}
+
+bool VoiceDetector::classify_frame(const float* frame, size_t n_samples) {
+    last_ = vad_compute_features(frame, n_samples);
+    bool speech = is_speech(last_);
+
+    double rate = speech ? config_.floor_release : config_.floor_attack;
+    noise_floor_ += rate * (last_.energy - noise_floor_);
+
+    return speech;
+}
+
+/* ============================================
+ * Segmentation
+ * ============================================ */
+
+std::vector<VadSegment> vad_split_segments(
+    const float* pcm,
+    size_t n_samples,
+    size_t frame_samples,
+    size_t target_samples,
+    size_t max_samples
+) {
+    std::vector<VadSegment> segments;
+    if (!pcm || n_samples == 0 || frame_samples == 0) {
+        return segments;
+    }
+    max_samples = std::max(max_samples, frame_samples);
+    target_samples = std::min(std::max(target_samples, frame_samples), max_samples);
+
+    // Classify every complete frame; a trailing partial frame counts as
+    // speech so a segment never ends inside it
+    size_t n_frames = n_samples / frame_samples;
+    std::vector<uint8_t> speech(n_frames);
+    std::vector<double> energy(n_frames);
+    VoiceDetector vad;
+    for (size_t f = 0; f < n_frames; f++) {
+        speech[f] = vad.classify_frame(pcm + f * frame_samples, frame_samples) ? 1 : 0;
+        energy[f] = vad.last_features().energy;
+    }
+
+    auto has_speech = [&](size_t start, size_t end) {
+        if (end > n_frames * frame_samples) {
+            return true;
+        }
+        size_t last = (end + frame_samples - 1) / frame_samples;
+        for (size_t f = start / frame_samples; f < last; f++) {
+            if (speech[f]) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    size_t start = 0;
+    while (n_samples - start > max_samples) {
+        // Candidate frames lie entirely inside [start + target / 2, start + max)
+        size_t first = (start + target_samples / 2 + frame_samples - 1) / frame_samples;
+        size_t last = std::min((start + max_samples) / frame_samples, n_frames);
+        size_t target_frame = (start + target_samples) / frame_samples;
+
+        size_t best_cut = 0;
+        size_t best_run = 0;
+        size_t best_distance = 0;
+        for (size_t f = first; f < last;) {
+            if (speech[f]) {
+                f++;
+                continue;
+            }
+            size_t run_end = f;
+            while (run_end < last && !speech[run_end]) {
+                run_end++;
+            }
+            size_t middle = (f + run_end) / 2;
+            size_t distance = middle > target_frame ? middle - target_frame : target_frame - middle;
+            size_t run = run_end - f;
+            if (run > best_run || (run == best_run && distance < best_distance)) {
+                best_cut = middle;
+                best_run = run;
+                best_distance = distance;
+            }
+            f = run_end;
+        }
+
+        if (best_run == 0) {
+            // Continuous speech: cut at the quietest frame
+            best_cut = first;
+            for (size_t f = first; f < last; f++) {
+                if (energy[f] < energy[best_cut]) {
+                    best_cut = f;
+                }
+            }
+        }
+
+        size_t cut = std::max(best_cut * frame_samples, start + frame_samples);
+        segments.push_back(VadSegment{start, cut, has_speech(start, cut)});
+        start = cut;
+    }
+    segments.push_back(VadSegment{start, n_samples, has_speech(start, n_samples)});
+    return segments;
+}
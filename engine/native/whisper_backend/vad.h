@@ -0,0 +1,127 @@
+/**
+ * WisprFlex Whisper Backend - Voice Activity Detection
+ *
+ * Internal header - not part of public API.
+ *
+ * Frame features (energy, zero-crossing rate) come from a vectorized
+ * kernel: AVX2 (detected at runtime), SSE2, NEON or a scalar fallback.
+ * Lanes accumulate in float over short blocks and blocks are summed in
+ * double, so results stay accurate on arbitrarily long buffers.
+ *
+ * VoiceDetector classifies frames one at a time as audio arrives,
+ * against a threshold that follows the background noise floor.
+ * No whisper.cpp dependency.
+ */
+
+#ifndef WISPRFLEX_VAD_H
+#define WISPRFLEX_VAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Features of one block of PCM
+ */
+struct VadFeatures {
+    double energy;      // Mean square amplitude
+    float zcr;          // Fraction of adjacent sample pairs that change sign
+};
+
+/**
+ * Compute features with the fastest kernel available on this CPU
+ */
+VadFeatures vad_compute_features(const float* pcm, size_t n_samples);
+
+/**
+ * Scalar double-precision reference (for tests and benchmarks)
+ */
+VadFeatures vad_compute_features_reference(const float* pcm, size_t n_samples);
+
+/**
+ * Kernel picked by vad_compute_features: "avx2", "sse2", "neon" or "scalar"
+ */
+const char* vad_kernel_name(void);
+
+/**
+ * Detector tuning
+ *
+ * A frame is speech when its energy exceeds
+ * max(min_energy, noise_floor * threshold_ratio) and either its ZCR is at
+ * most max_speech_zcr or the energy is loud_ratio times that threshold
+ * (broadband hiss crosses zero far more often than voiced speech).
+ */
+struct VadConfig {
+    float min_energy;       // Absolute threshold floor (mean square)
+    float threshold_ratio;  // Speech must be this far above the noise floor
+    float loud_ratio;       // Above threshold * loud_ratio ZCR is ignored
+    float max_speech_zcr;   // Quieter frames crossing zero more often are noise
+    float floor_attack;     // Noise floor update per non-speech frame (0..1)
+    float floor_release;    // Noise floor drift per speech frame (0..1)
+};
+
+/**
+ * Defaults: min_energy matches the fixed wb_is_silent threshold, so clean
+ * input classifies as before; noisy input raises the threshold.
+ */
+VadConfig vad_default_config(void);
+
+/**
+ * Incremental speech/non-speech classifier with an adaptive noise floor
+ */
+class VoiceDetector {
+public:
+    explicit VoiceDetector(const VadConfig& config = vad_default_config());
+
+    /**
+     * Classify the next frame and update the noise floor
+     * @return true for speech
+     */
+    bool classify_frame(const float* frame, size_t n_samples);
+
+    /**
+     * Classify without updating state (e.g. a trailing partial frame)
+     */
+    bool is_speech(const VadFeatures& features) const;
+
+    double threshold() const;
+    double noise_floor() const { return noise_floor_; }
+    const VadFeatures& last_features() const { return last_; }
+
+    void reset();
+
+private:
+    VadConfig config_;
+    double noise_floor_;
+    VadFeatures last_;
+};
+
+/**
+ * Span [start, end) of a buffer, in samples
+ */
+struct VadSegment {
+    size_t start;
+    size_t end;
+    bool has_speech;    // Any frame classified as speech
+};
+
+/**
+ * Split a long recording into segments of at most max_samples for
+ * independent transcription. Each cut is placed in the longest run of
+ * non-speech frames between target_samples / 2 and max_samples into the
+ * segment (ties: nearest target_samples), so words are not split; in
+ * continuous speech the quietest frame is used. Frames are classified by
+ * one detector over the whole buffer.
+ *
+ * @param frame_samples Frame length for classification (e.g. 480 = 30 ms)
+ * @return Segments in time order covering the whole buffer
+ */
+std::vector<VadSegment> vad_split_segments(
+    const float* pcm,
+    size_t n_samples,
+    size_t frame_samples,
+    size_t target_samples,
+    size_t max_samples
+);
+
+#endif /* WISPRFLEX_VAD_H */
@@ -0,0 +1,208 @@
+/**
+ * WisprFlex Whisper Backend - WAV File Reading
+ *
+ * Walks the RIFF chunk list for "fmt " and "data" (other chunks, such as
+ * LIST metadata, are skipped). Samples are converted to mono in blocks so
+ * a long recording never needs a second copy of its raw bytes.
+ */
+
+#include "wav_reader.h"
+
+#include <cstdio>
+#include <cstring>
+
+static const uint16_t WAV_FORMAT_PCM = 1;
+static const uint16_t WAV_FORMAT_FLOAT = 3;
+static const uint16_t WAV_FORMAT_EXTENSIBLE = 0xFFFE;
+static const uint32_t WHISPER_SAMPLE_RATE = 16000;
+
+// Frames converted per read
+static const size_t WAV_BLOCK_FRAMES = 16384;
+
+static uint16_t read_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool fail(std::string* error, const char* reason) {
+    if (error) {
+        *error = reason;
+    }
+    return false;
+}
+
+/**
+ * Parse the header of an open file
+ */
+static bool probe_file(FILE* file, WavInfo& info, std::string* error) {
+    uint8_t riff[12];
+    if (fread(riff, 1, sizeof(riff), file) != sizeof(riff) ||
+        memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0) {
+        return fail(error, "not a RIFF/WAVE file");
+    }
+
+    bool have_format = false;
+    uint16_t format = 0;
+    long offset = (long)sizeof(riff);
+
+    uint8_t chunk[8];
+    while (fread(chunk, 1, sizeof(chunk), file) == sizeof(chunk)) {
+        uint32_t chunk_size = read_u32(chunk + 4);
+        offset += (long)sizeof(chunk);
+
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[40] = {0};
+            size_t fmt_bytes = chunk_size < sizeof(fmt) ? chunk_size : sizeof(fmt);
+            if (fmt_bytes < 16 || fread(fmt, 1, fmt_bytes, file) != fmt_bytes) {
+                return fail(error, "truncated fmt chunk");
+            }
+            format = read_u16(fmt);
+            info.channels = read_u16(fmt + 2);
+            info.sample_rate = read_u32(fmt + 4);
+            info.bits_per_sample = read_u16(fmt + 14);
+            if (format == WAV_FORMAT_EXTENSIBLE && fmt_bytes >= 26) {
+                format = read_u16(fmt + 24);    // Sub-format GUID starts with the tag
+            }
+            have_format = true;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!have_format) {
+                return fail(error, "data chunk before fmt chunk");
+            }
+            break;
+        }
+
+        // Chunks are padded to an even size
+        offset += (long)chunk_size + (long)(chunk_size & 1);
+        if (fseek(file, offset, SEEK_SET) != 0) {
+            return fail(error, "truncated file");
+        }
+        memset(chunk, 0, sizeof(chunk));
+    }
+
+    if (memcmp(chunk, "data", 4) != 0) {
+        return fail(error, "no data chunk");
+    }
+
+    info.is_float = format == WAV_FORMAT_FLOAT;
+    bool supported = (format == WAV_FORMAT_PCM && info.bits_per_sample == 16) ||
+                     (info.is_float && info.bits_per_sample == 32);
+    if (!supported) {
+        return fail(error, "unsupported sample format (16-bit PCM or 32-bit float only)");
+    }
+    if (info.channels == 0 || info.sample_rate == 0) {
+        return fail(error, "invalid fmt chunk");
+    }
+
+    // Streamed writers leave the size unset; trust the file length instead
+    size_t frame_bytes = (size_t)info.channels * (info.bits_per_sample / 8);
+    size_t data_bytes = read_u32(chunk + 4);
+    info.data_offset = (size_t)offset;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        long end = ftell(file);
+        if (end >= offset && (size_t)(end - offset) < data_bytes) {
+            data_bytes = (size_t)(end - offset);
+        }
+    }
+    info.frames = data_bytes / frame_bytes;
+    return true;
+}
+
+bool wav_probe(const char* path, WavInfo& info, std::string* error) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return fail(error, "cannot open file");
+    }
+    bool ok = probe_file(file, info, error);
+    fclose(file);
+    return ok;
+}
+
+double wav_duration_ms(const WavInfo& info) {
+    return info.sample_rate > 0 ? (double)info.frames * 1000.0 / info.sample_rate : 0.0;
+}
+
+bool wav_load_16k_mono(const char* path, std::vector<float>& out, std::string* error) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return fail(error, "cannot open file");
+    }
+
+    WavInfo info = {};
+    if (!probe_file(file, info, error)) {
+        fclose(file);
+        return false;
+    }
+    if (fseek(file, (long)info.data_offset, SEEK_SET) != 0) {
+        fclose(file);
+        return fail(error, "cannot seek to data");
+    }
+
+    const size_t channels = info.channels;
+    const size_t sample_bytes = info.bits_per_sample / 8;
+    std::vector<uint8_t> block(WAV_BLOCK_FRAMES * channels * sample_bytes);
+
+    std::vector<float> mono;
+    mono.reserve(info.frames);
+
+    size_t remaining = info.frames;
+    while (remaining > 0) {
+        size_t frames = remaining < WAV_BLOCK_FRAMES ? remaining : WAV_BLOCK_FRAMES;
+        size_t got = fread(block.data(), channels * sample_bytes, frames, file);
+
+        for (size_t f = 0; f < got; f++) {
+            const uint8_t* frame = block.data() + f * channels * sample_bytes;
+            float sum = 0.0f;
+            for (size_t c = 0; c < channels; c++) {
+                const uint8_t* sample = frame + c * sample_bytes;
+                if (info.is_float) {
+                    uint32_t bits = read_u32(sample);
+                    float value;
+                    memcpy(&value, &bits, sizeof(value));
+                    sum += value;
+                } else {
+                    sum += (int16_t)read_u16(sample) / 32768.0f;
+                }
+            }
+            mono.push_back(sum / (float)channels);
+        }
+
+        if (got < frames) {
+            break;  // Truncated file: keep what was read
+        }
+        remaining -= got;
+    }
+    fclose(file);
+
+    if (info.sample_rate == WHISPER_SAMPLE_RATE) {
+        out.swap(mono);
+    } else {
+        out = wav_resample(mono.data(), mono.size(), info.sample_rate, WHISPER_SAMPLE_RATE);
+    }
+    return true;
+}
+
+std::vector<float> wav_resample(const float* pcm, size_t n_samples, uint32_t in_rate, uint32_t out_rate) {
+    if (in_rate == out_rate || n_samples == 0) {
+        return std::vector<float>(pcm, pcm + n_samples);
+    }
+
+    double ratio = (double)out_rate / in_rate;
+    size_t output_size = (size_t)(n_samples * ratio);
+    std::vector<float> output(output_size);
+
+    for (size_t i = 0; i < output_size; i++) {
+        double src_idx = i / ratio;
+        size_t idx = (size_t)src_idx;
+        double frac = src_idx - idx;
+
+        if (idx + 1 < n_samples) {
+            output[i] = (float)(pcm[idx] * (1.0 - frac) + pcm[idx + 1] * frac);
+        } else {
+            output[i] = pcm[n_samples - 1];
+        }
+    }
+    return output;
+}
@@ -0,0 +1,56 @@
+/**
+ * WisprFlex Whisper Backend - WAV File Reading
+ *
+ * Internal header - not part of public API.
+ *
+ * Reads RIFF/WAVE files (16-bit PCM or 32-bit float, any channel count)
+ * and converts them to the 16kHz mono Float32 whisper expects. Headers can
+ * be probed without reading samples, so callers can order files by
+ * length before decoding any of them. No whisper.cpp dependency.
+ */
+
+#ifndef WISPRFLEX_WAV_READER_H
+#define WISPRFLEX_WAV_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Format of a WAV file, from its header
+ */
+struct WavInfo {
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint16_t bits_per_sample;
+    bool is_float;          // IEEE float samples (otherwise integer PCM)
+    size_t frames;          // Samples per channel
+    size_t data_offset;     // File offset of the sample data
+};
+
+/**
+ * Read the header of a WAV file
+ * @param error Receives the reason on failure (may be NULL)
+ * @return false if the file cannot be read or the format is unsupported
+ */
+bool wav_probe(const char* path, WavInfo& info, std::string* error = nullptr);
+
+/**
+ * Duration in milliseconds
+ */
+double wav_duration_ms(const WavInfo& info);
+
+/**
+ * Read a WAV file as 16kHz mono Float32
+ * Channels are averaged and other rates resampled.
+ * @param error Receives the reason on failure (may be NULL)
+ */
+bool wav_load_16k_mono(const char* path, std::vector<float>& out, std::string* error = nullptr);
+
+/**
+ * Linear-interpolation resampler
+ */
+std::vector<float> wav_resample(const float* pcm, size_t n_samples, uint32_t in_rate, uint32_t out_rate);
+
+#endif // WISPRFLEX_WAV_READER_H
@@ -8,10 +8,23 @@
  * - Manages context lifecycle
  * - Provides C interface for engine integration
  * 
+ * Threading:
+ * - Model weights are loaded once into a whisper_context without state
+ * - Each streaming session owns a whisper_state and its own mutex, so
+ *   sessions run whisper_full in parallel on shared weights
+ * - g_mutex only guards the model pointer, session table and metrics;
+ *   it is never held across inference
+ * 
  * CPU-only, no GPU flags.
  */
 
 #include "whisper_backend.h"
+#include "vad.h"
+#include "mapped_file.h"
+#include "wav_reader.h"
+#include "latency_histogram.h"
+#include "memory_probe.h"
+#include "trace.h"
 
 // whisper.cpp header (from third_party/whisper.cpp)
 #include "whisper.h"
@@ -19,18 +32,125 @@
 #include <cstring>
 #include <cstdio>
 #include <chrono>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <algorithm>
+#include <new>
 #include <string>
+#include <vector>
 
 /* ============================================
  * Internal State
  * ============================================ */
 
+/**
+ * Model weights shared by all sessions.
+ * Freed when the last holder (backend or session) releases it, so
+ * unloading never pulls weights out from under a running session.
+ */
+struct LoadedModel {
+    struct whisper_context* ctx = nullptr;
+    std::string path;
+    
+    // State for wb_transcribe (created on first use)
+    std::mutex transcribe_mutex;
+    struct whisper_state* transcribe_state = nullptr;
+    
+    // State already run once by warm-up, handed to the next user
+    std::mutex spare_mutex;
+    struct whisper_state* spare_state = nullptr;
+    bool warmed_up = false;
+    
+    // Idle worker states of wb_transcribe_batch, kept for the next batch
+    std::mutex batch_mutex;
+    std::vector<struct whisper_state*> batch_states;
+    
+    ~LoadedModel() {
+        for (struct whisper_state* state : batch_states) {
+            whisper_free_state(state);
+        }
+        if (spare_state) {
+            whisper_free_state(spare_state);
+        }
+        if (transcribe_state) {
+            whisper_free_state(transcribe_state);
+        }
+        if (ctx) {
+            whisper_free(ctx);
+        }
+    }
+};
+
+/**
+ * Handle returned by wb_model_acquire (one reference to the weights)
+ */
+struct WBModel {
+    std::shared_ptr<LoadedModel> model;
+};
+
 static std::mutex g_mutex;
 static bool g_initialized = false;
-static struct whisper_context* g_ctx = nullptr;
-static std::string g_model_path;
-static WBMetrics g_metrics = {0};
+static std::shared_ptr<LoadedModel> g_model;
+
+/**
+ * Model registry entry. Owners of the same file share one LoadedModel.
+ * With a budget the registry also holds a reference (resident), so an
+ * unused model stays loaded until evicted.
+ */
+struct RegistryEntry {
+    std::string model_id;
+    std::weak_ptr<LoadedModel> model;
+    std::shared_ptr<LoadedModel> resident;  // Set only with a budget
+    size_t predicted_bytes = 0;
+    uint64_t last_used = 0;
+};
+
+// Registry by model path; see load_shared_model
+static std::map<std::string, RegistryEntry> g_registry;
+static size_t g_model_budget = 0;          // 0 = no budget, no retention
+static size_t g_pending_model_bytes = 0;   // Reserved by loads in progress
+static uint64_t g_use_clock = 0;
+static WBMetrics g_metrics = {};
+
+// Stage timings of the last WB_STAGE_HISTORY transcribed windows (ring)
+static WBStageTimings g_stage_history[WB_STAGE_HISTORY];
+static int g_stage_count = 0;
+static int g_stage_next = 0;
+
+// Lock-free side of the metrics (wb_get_metrics_snapshot): a copy of
+// g_metrics republished after each update, and latency histograms
+static SeqLocked<WBMetrics> g_published_metrics;
+static LatencyHistogram g_chunk_latency;
+static LatencyHistogram g_queue_wait;
+static LatencyHistogram g_first_partial;
+static LatencyHistogram g_finalize_latency;
+
+/**
+ * Republish g_metrics for snapshot readers (g_mutex held, which also
+ * serializes the writers of the seqlock)
+ */
+static void publish_metrics() {
+    g_published_metrics.store(g_metrics);
+}
+
+/**
+ * Holds g_mutex for an update of g_metrics and republishes it at the end
+ */
+class MetricsUpdate {
+public:
+    MetricsUpdate() : lock_(g_mutex) {}
+    ~MetricsUpdate() { publish_metrics(); }
+    
+    MetricsUpdate(const MetricsUpdate&) = delete;
+    MetricsUpdate& operator=(const MetricsUpdate&) = delete;
+    
+private:
+    std::lock_guard<std::mutex> lock_;
+};
+
+struct StreamingSession;
+static std::map<uint32_t, std::shared_ptr<StreamingSession>> g_sessions;
 
 /* ============================================
  * Error Messages
@@ -44,11 +164,12 @@ static const char* ERROR_MESSAGES[] = {
     "Out of memory",                // WB_ERROR_OUT_OF_MEMORY
     "Inference failed",             // WB_ERROR_INFERENCE_FAILED
     "Invalid audio data",           // WB_ERROR_INVALID_AUDIO
-    "Backend not initialized"       // WB_ERROR_NOT_INITIALIZED
+    "Backend not initialized",      // WB_ERROR_NOT_INITIALIZED
+    "Cancelled"                     // WB_ERROR_CANCELLED
 };
 
 const char* wb_error_message(WBErrorCode code) {
-    if (code >= 0 && code <= WB_ERROR_NOT_INITIALIZED) {
+    if (code >= 0 && code <= WB_ERROR_CANCELLED) {
         return ERROR_MESSAGES[code];
     }
     return "Unknown error";
@@ -66,7 +187,14 @@ WBErrorCode wb_init(void) {
     }
     
     // Reset metrics
-    g_metrics = {0};
+    g_metrics = {};
+    g_stage_count = 0;
+    g_stage_next = 0;
+    publish_metrics();
+    g_chunk_latency.reset();
+    g_queue_wait.reset();
+    g_first_partial.reset();
+    g_finalize_latency.reset();
     g_initialized = true;
     
     printf("[whisper_backend] Initialized\n");
@@ -81,76 +209,479 @@ int wb_is_initialized(void) {
 WBErrorCode wb_shutdown(void) {
     std::lock_guard<std::mutex> lock(g_mutex);
     
-    if (g_ctx) {
-        whisper_free(g_ctx);
-        g_ctx = nullptr;
-    }
-    
-    g_model_path.clear();
+    // Sessions still inside a call keep their model alive until they return
+    g_sessions.clear();
+    g_model.reset();
+    g_registry.clear();
     g_initialized = false;
     
     printf("[whisper_backend] Shutdown\n");
     return WB_OK;
 }
 
+/* ============================================
+ * Model Registry
+ * ============================================ */
+
+// Weights plus whisper.cpp compute buffers, relative to file size
+// (base: 147 MB file, ~220 MB resident; MODEL_MANAGEMENT_SPEC.md 6)
+static const size_t MODEL_MEMORY_NUM = 3;
+static const size_t MODEL_MEMORY_DEN = 2;
+
+/**
+ * Predicted resident size of a model (0 if the file cannot be opened)
+ */
+static size_t predict_model_bytes(const char* model_path) {
+    FILE* f = fopen(model_path, "rb");
+    if (!f) {
+        return 0;
+    }
+    long file_size = -1;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        file_size = ftell(f);
+    }
+    fclose(f);
+    return file_size > 0 ? (size_t)file_size / MODEL_MEMORY_DEN * MODEL_MEMORY_NUM : 0;
+}
+
+/**
+ * Model id for logs when the caller gives none: file name without extension
+ */
+static std::string default_model_id(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+}
+
+/**
+ * True if someone other than the registry holds the model.
+ * Called with g_mutex held.
+ */
+static bool entry_in_use(const RegistryEntry& entry) {
+    long holders = entry.model.use_count();
+    return holders > (entry.resident ? 1 : 0);
+}
+
+/**
+ * Drop entries whose model has been freed and sum the rest.
+ * Called with g_mutex held.
+ */
+static size_t registry_resident_bytes() {
+    size_t total = 0;
+    for (auto it = g_registry.begin(); it != g_registry.end(); ) {
+        if (it->second.model.expired()) {
+            it = g_registry.erase(it);
+        } else {
+            total += it->second.predicted_bytes;
+            ++it;
+        }
+    }
+    return total;
+}
+
+/**
+ * Evict least recently used idle models until needed_bytes more fit in
+ * the budget, or no idle model is left. Evicted models are moved to
+ * out_evicted so they are freed after g_mutex is released. Called with
+ * g_mutex held.
+ * @return false if models in use leave no room
+ */
+static bool evict_idle_models(size_t needed_bytes, std::vector<std::shared_ptr<LoadedModel>>& out_evicted) {
+    size_t total = registry_resident_bytes() + g_pending_model_bytes;
+    
+    while (total + needed_bytes > g_model_budget) {
+        auto victim = g_registry.end();
+        for (auto it = g_registry.begin(); it != g_registry.end(); ++it) {
+            if (entry_in_use(it->second)) {
+                continue;
+            }
+            if (victim == g_registry.end() || it->second.last_used < victim->second.last_used) {
+                victim = it;
+            }
+        }
+        if (victim == g_registry.end()) {
+            return false;
+        }
+        
+        printf("[whisper_backend] Evicting model '%s' (%.1f MB)\n",
+               victim->second.model_id.c_str(), 
+               victim->second.predicted_bytes / (1024.0 * 1024.0));
+        total -= victim->second.predicted_bytes;
+        out_evicted.push_back(std::move(victim->second.resident));
+        g_registry.erase(victim);
+        g_metrics.model_evictions++;
+        publish_metrics();
+    }
+    return true;
+}
+
+/**
+ * Make room for needed_bytes, all or nothing: when models in use (and
+ * loads in progress) leave too little room even with every idle model
+ * gone, nothing is evicted. Called with g_mutex held.
+ * @return false if the load does not fit
+ */
+static bool make_room(size_t needed_bytes, std::vector<std::shared_ptr<LoadedModel>>& out_evicted) {
+    size_t kept = registry_resident_bytes() + g_pending_model_bytes;
+    for (const auto& kv : g_registry) {
+        if (!entry_in_use(kv.second)) {
+            kept -= kv.second.predicted_bytes;
+        }
+    }
+    if (kept + needed_bytes > g_model_budget) {
+        return false;
+    }
+    return evict_idle_models(needed_bytes, out_evicted);
+}
+
+WBErrorCode wb_set_model_budget(size_t budget_bytes) {
+    std::vector<std::shared_ptr<LoadedModel>> evicted;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_model_budget = budget_bytes;
+        
+        for (auto& kv : g_registry) {
+            if (budget_bytes == 0) {
+                // Back to no retention: idle models go now
+                evicted.push_back(std::move(kv.second.resident));
+            } else if (!kv.second.resident) {
+                kv.second.resident = kv.second.model.lock();
+            }
+        }
+        if (budget_bytes > 0) {
+            evict_idle_models(0, evicted);  // Models in use may keep it over budget
+        }
+    }
+    return WB_OK;
+}
+
 /* ============================================
  * Model Management
  * ============================================ */
 
-WBErrorCode wb_load_model(const char* model_path) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+/**
+ * Resident private memory (heap, including whisper's copy of the
+ * weights and its compute buffers); 0 where not reported
+ */
+static size_t private_resident_bytes() {
+    MemoryUsage usage;
+    return memory_probe_read(usage) ? usage.anonymous_bytes : 0;
+}
+
+/**
+ * Inference state for a new user of model: the warmed-up state if
+ * nobody has taken it yet, otherwise a fresh one (NULL on failure)
+ */
+static struct whisper_state* take_state(LoadedModel& model) {
+    {
+        std::lock_guard<std::mutex> lock(model.spare_mutex);
+        if (model.spare_state) {
+            struct whisper_state* state = model.spare_state;
+            model.spare_state = nullptr;
+            return state;
+        }
+    }
+    return whisper_init_state(model.ctx);
+}
+
+static WBErrorCode warm_up_model(LoadedModel& model);
+
+/**
+ * whisper_model_loader context: a reader over the mapping plus the
+ * caller's progress callback, which may cancel the load
+ */
+struct MappedLoad {
+    MappedFileReader reader;
+    WBLoadProgressCallback progress = nullptr;
+    void* progress_user_data = nullptr;
+    bool cancelled = false;
+};
+
+static size_t mapped_loader_read(void* ctx, void* output, size_t read_size) {
+    MappedLoad* load = static_cast<MappedLoad*>(ctx);
+    if (load->cancelled) {
+        return 0;
+    }
     
-    if (!g_initialized) {
-        return WB_ERROR_NOT_INITIALIZED;
+    size_t n = load->reader.read(output, read_size);
+    if (load->progress && 
+        !load->progress(load->reader.offset, load->reader.file->size(), load->progress_user_data)) {
+        load->cancelled = true;
+    }
+    return n;
+}
+
+static bool mapped_loader_eof(void* ctx) {
+    // whisper stops reading tensors at EOF and then fails the incomplete load
+    MappedLoad* load = static_cast<MappedLoad*>(ctx);
+    return load->cancelled || load->reader.eof();
+}
+
+static void mapped_loader_close(void* ctx) {
+    (void)ctx;  // Mapping is owned and closed by the caller
+}
+
+/**
+ * Create a context from a read-only mapping of model_path, falling back
+ * to whisper's own file reader if the file cannot be mapped.
+ * whisper.cpp copies the tensors into its own buffers, so the mapping is
+ * dropped once loading finishes; its pages stay in the page cache, which
+ * is shared with other processes and makes the next load of the same
+ * file a memory copy rather than disk I/O.
+ * Progress is reported per read from the mapping (not on fallback).
+ * @param out_mapped_bytes Receives the mapping size (0 on fallback)
+ * @param out_cancelled Set if the progress callback cancelled the load
+ */
+static struct whisper_context* init_context_mapped(
+    const char* model_path,
+    struct whisper_context_params cparams,
+    const WBLoadOptions* options,
+    size_t* out_mapped_bytes,
+    bool* out_cancelled
+) {
+    *out_mapped_bytes = 0;
+    *out_cancelled = false;
+    
+    MappedFile file;
+    if (!file.open(model_path)) {
+        printf("[whisper_backend] Cannot map model, reading it instead\n");
+        return whisper_init_from_file_with_params_no_state(model_path, cparams);
     }
     
-    if (!model_path || strlen(model_path) == 0) {
-        return WB_ERROR_MODEL_NOT_FOUND;
+    MappedLoad load;
+    load.reader.file = &file;
+    if (options) {
+        load.progress = options->progress_callback;
+        load.progress_user_data = options->progress_user_data;
     }
     
-    // Unload previous model if any
-    if (g_ctx) {
-        whisper_free(g_ctx);
-        g_ctx = nullptr;
+    whisper_model_loader loader;
+    loader.context = &load;
+    loader.read = mapped_loader_read;
+    loader.eof = mapped_loader_eof;
+    loader.close = mapped_loader_close;
+    
+    struct whisper_context* ctx = whisper_init_with_params_no_state(&loader, cparams);
+    *out_mapped_bytes = file.size();
+    *out_cancelled = load.cancelled;
+    
+    if (ctx && load.cancelled) {
+        // Cancelled after the last tensor; honour it anyway
+        whisper_free(ctx);
+        ctx = nullptr;
+    }
+    return ctx;
+}
+
+/**
+ * Load weights for model_path, or share them if the registry already
+ * holds that file. Called without g_mutex; file I/O never blocks other
+ * sessions. With a budget, idle models are evicted (least recently used
+ * first) to make room, and the load is refused with
+ * WB_ERROR_OUT_OF_MEMORY if models in use leave too little.
+ */
+static std::shared_ptr<LoadedModel> load_shared_model(
+    const char* model_path,
+    const WBLoadOptions* options,
+    WBErrorCode* err
+) {
+    TraceScope trace("load_model", "backend");
+    const std::string id = options && options->model_id ? std::string(options->model_id) 
+                                                         : default_model_id(model_path);
+    const size_t predicted_bytes = predict_model_bytes(model_path);
+    std::vector<std::shared_ptr<LoadedModel>> evicted;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        
+        if (!g_initialized) {
+            *err = WB_ERROR_NOT_INITIALIZED;
+            return nullptr;
+        }
+        
+        auto cached = g_registry.find(model_path);
+        if (cached != g_registry.end()) {
+            if (std::shared_ptr<LoadedModel> model = cached->second.model.lock()) {
+                printf("[whisper_backend] Sharing loaded model '%s': %s\n", 
+                       cached->second.model_id.c_str(), model_path);
+                cached->second.last_used = ++g_use_clock;
+                g_metrics.model_cache_hits++;
+                publish_metrics();
+                *err = WB_OK;
+                return model;
+            }
+            g_registry.erase(cached);
+        }
+        
+        if (g_model_budget > 0 && !make_room(predicted_bytes, evicted)) {
+            printf("[whisper_backend] Model '%s' (%.1f MB) does not fit the %.1f MB budget\n",
+                   id.c_str(), predicted_bytes / (1024.0 * 1024.0), 
+                   g_model_budget / (1024.0 * 1024.0));
+            *err = WB_ERROR_OUT_OF_MEMORY;
+            return nullptr;
+        }
+        g_pending_model_bytes += predicted_bytes;
     }
+    evicted.clear();  // Free evicted weights before loading new ones
     
-    printf("[whisper_backend] Loading model: %s\n", model_path);
+    printf("[whisper_backend] Loading model '%s': %s\n", id.c_str(), model_path);
     
     // Measure load time
     auto start = std::chrono::high_resolution_clock::now();
     
-    // Load model using whisper.cpp
-    g_ctx = whisper_init_from_file(model_path);
+    // Load weights only; inference state is created per session
+    struct whisper_context_params cparams = whisper_context_default_params();
+    cparams.use_gpu = false;
+    
+    auto model = std::make_shared<LoadedModel>();
+    size_t mapped_bytes = 0;
+    bool cancelled = false;
+    size_t private_before = private_resident_bytes();
+    model->ctx = init_context_mapped(model_path, cparams, options, &mapped_bytes, &cancelled);
+    model->path = model_path;
+    MemoryUsage usage_after;
+    memory_probe_read(usage_after);
     
     auto end = std::chrono::high_resolution_clock::now();
-    g_metrics.model_load_time_ms = 
-        std::chrono::duration<double, std::milli>(end - start).count();
+    double load_time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    MetricsUpdate update;   // Also guards the registry below
+    g_pending_model_bytes -= predicted_bytes;
+    g_metrics.peak_memory_bytes = std::max(g_metrics.peak_memory_bytes, usage_after.peak_resident_bytes);
+    
+    if (cancelled) {
+        printf("[whisper_backend] Model load cancelled\n");
+        *err = WB_ERROR_CANCELLED;
+        return nullptr;
+    }
     
-    if (!g_ctx) {
+    if (!model->ctx) {
         printf("[whisper_backend] Failed to load model\n");
-        return WB_ERROR_MODEL_LOAD_FAILED;
+        *err = WB_ERROR_MODEL_LOAD_FAILED;
+        return nullptr;
+    }
+    
+    // Another owner may have loaded the same file meanwhile: share theirs
+    auto existing = g_registry.find(model->path);
+    if (existing != g_registry.end()) {
+        if (std::shared_ptr<LoadedModel> shared = existing->second.model.lock()) {
+            *err = WB_OK;
+            return shared;
+        }
+    }
+    
+    RegistryEntry& entry = g_registry[model->path];
+    entry.model_id = id;
+    entry.model = model;
+    entry.resident = g_model_budget > 0 ? model : nullptr;
+    entry.predicted_bytes = predicted_bytes;
+    entry.last_used = ++g_use_clock;
+    
+    // The mapping is gone once loading ends, so private growth across the
+    // load is whisper's copy of the weights (other threads add noise)
+    size_t private_after = usage_after.anonymous_bytes;
+    g_metrics.model_load_time_ms = load_time_ms;
+    g_metrics.model_mapped_bytes = mapped_bytes;
+    g_metrics.model_memory_bytes = private_after > private_before ? private_after - private_before : 0;
+    
+    printf("[whisper_backend] Model loaded in %.2f ms, weights %.1f MB resident\n",
+           load_time_ms, g_metrics.model_memory_bytes / (1024.0 * 1024.0));
+    
+    *err = WB_OK;
+    return model;
+}
+
+WBLoadOptions wb_default_load_options(void) {
+    WBLoadOptions options;
+    options.warmup = 0;
+    options.model_id = nullptr;
+    options.progress_callback = nullptr;
+    options.progress_user_data = nullptr;
+    return options;
+}
+
+/**
+ * Load or share weights, then warm them up if requested.
+ * A failed warm-up fails the load: the first session would fail the same way.
+ */
+static std::shared_ptr<LoadedModel> load_model_with_options(
+    const char* model_path,
+    const WBLoadOptions* options,
+    WBErrorCode* err
+) {
+    std::shared_ptr<LoadedModel> model = 
+        load_shared_model(model_path, options, err);
+    if (!model || !options || !options->warmup) {
+        return model;
     }
     
-    g_model_path = model_path;
+    *err = warm_up_model(*model);
+    return *err == WB_OK ? model : nullptr;
+}
+
+WBErrorCode wb_load_model(const char* model_path) {
+    return wb_load_model_with_options(model_path, nullptr);
+}
+
+WBErrorCode wb_load_model_with_options(const char* model_path, const WBLoadOptions* options) {
+    if (!model_path || strlen(model_path) == 0) {
+        return WB_ERROR_MODEL_NOT_FOUND;
+    }
     
-    // Estimate memory usage (rough)
-    // whisper.cpp doesn't expose exact memory, using file size as proxy
-    // In real implementation, would use system memory APIs
-    g_metrics.model_memory_bytes = 0;  // TODO: Measure actual memory
+    {
+        // Release previous model (running sessions keep their reference)
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_model.reset();
+    }
     
-    printf("[whisper_backend] Model loaded in %.2f ms\n", 
-           g_metrics.model_load_time_ms);
+    WBErrorCode err = WB_OK;
+    std::shared_ptr<LoadedModel> model = load_model_with_options(model_path, options, &err);
+    if (!model) {
+        return err;
+    }
     
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_model = model;
     return WB_OK;
 }
 
+WBErrorCode wb_model_acquire(const char* model_path, WBModel** out_model) {
+    return wb_model_acquire_with_options(model_path, nullptr, out_model);
+}
+
+WBErrorCode wb_model_acquire_with_options(
+    const char* model_path,
+    const WBLoadOptions* options,
+    WBModel** out_model
+) {
+    if (!out_model) {
+        return WB_ERROR_MODEL_LOAD_FAILED;
+    }
+    *out_model = nullptr;
+    
+    if (!model_path || strlen(model_path) == 0) {
+        return WB_ERROR_MODEL_NOT_FOUND;
+    }
+    
+    WBErrorCode err = WB_OK;
+    std::shared_ptr<LoadedModel> model = load_model_with_options(model_path, options, &err);
+    if (!model) {
+        return err;
+    }
+    
+    *out_model = new (std::nothrow) WBModel{model};
+    return *out_model ? WB_OK : WB_ERROR_OUT_OF_MEMORY;
+}
+
+void wb_model_release(WBModel* model) {
+    delete model;
+}
+
 WBErrorCode wb_unload_model(void) {
     std::lock_guard<std::mutex> lock(g_mutex);
     
-    if (g_ctx) {
-        whisper_free(g_ctx);
-        g_ctx = nullptr;
-        g_model_path.clear();
+    if (g_model) {
+        g_model.reset();
         printf("[whisper_backend] Model unloaded\n");
     }
     
@@ -159,13 +690,13 @@ WBErrorCode wb_unload_model(void) {
 
 int wb_is_model_loaded(void) {
     std::lock_guard<std::mutex> lock(g_mutex);
-    return g_ctx != nullptr ? 1 : 0;
+    return g_model != nullptr ? 1 : 0;
 }
 
 WBErrorCode wb_get_model_info(char* out_info, size_t info_size) {
     std::lock_guard<std::mutex> lock(g_mutex);
     
-    if (!g_ctx) {
+    if (!g_model) {
         snprintf(out_info, info_size, "No model loaded");
         return WB_OK;
     }
@@ -173,7 +704,7 @@ WBErrorCode wb_get_model_info(char* out_info, size_t info_size) {
     snprintf(out_info, info_size, 
              "Model: %s\n"
              "Load time: %.2f ms",
-             g_model_path.c_str(),
+             g_model->path.c_str(),
              g_metrics.model_load_time_ms);
     
     return WB_OK;
@@ -198,13 +729,18 @@ WBErrorCode wb_transcribe(
     char* out_text,
     size_t text_size
 ) {
-    std::lock_guard<std::mutex> lock(g_mutex);
-    
-    if (!g_initialized) {
-        return WB_ERROR_NOT_INITIALIZED;
+    TraceScope trace("transcribe", "backend", "samples", (int64_t)n_samples);
+    std::shared_ptr<LoadedModel> model;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        
+        if (!g_initialized) {
+            return WB_ERROR_NOT_INITIALIZED;
+        }
+        model = g_model;
     }
     
-    if (!g_ctx) {
+    if (!model) {
         return WB_ERROR_MODEL_LOAD_FAILED;
     }
     
@@ -216,6 +752,17 @@ WBErrorCode wb_transcribe(
         return WB_ERROR_INFERENCE_FAILED;
     }
     
+    // Single-shot calls share one state per model; streaming sessions
+    // are unaffected
+    std::lock_guard<std::mutex> transcribe_lock(model->transcribe_mutex);
+    if (!model->transcribe_state) {
+        model->transcribe_state = take_state(*model);
+        if (!model->transcribe_state) {
+            return WB_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    struct whisper_state* state = model->transcribe_state;
+    
     // Set up whisper parameters
     struct whisper_full_params wparams = 
         whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
@@ -242,11 +789,14 @@ WBErrorCode wb_transcribe(
     auto start = std::chrono::high_resolution_clock::now();
     
     // Run inference
-    int result = whisper_full(g_ctx, wparams, pcm_data, (int)n_samples);
+    int result = whisper_full_with_state(model->ctx, state, wparams, pcm_data, (int)n_samples);
     
     auto end = std::chrono::high_resolution_clock::now();
-    g_metrics.last_inference_time_ms = 
-        std::chrono::duration<double, std::milli>(end - start).count();
+    double inference_time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    {
+        MetricsUpdate update;
+        g_metrics.last_inference_time_ms = inference_time_ms;
+    }
     
     if (result != 0) {
         printf("[whisper_backend] Inference failed with code %d\n", result);
@@ -255,10 +805,10 @@ WBErrorCode wb_transcribe(
     
     // Extract text from all segments
     std::string full_text;
-    int n_segments = whisper_full_n_segments(g_ctx);
+    int n_segments = whisper_full_n_segments_from_state(state);
     
     for (int i = 0; i < n_segments; i++) {
-        const char* segment_text = whisper_full_get_segment_text(g_ctx, i);
+        const char* segment_text = whisper_full_get_segment_text_from_state(state, i);
         if (segment_text) {
             full_text += segment_text;
         }
@@ -269,7 +819,7 @@ WBErrorCode wb_transcribe(
     out_text[text_size - 1] = '\0';
     
     printf("[whisper_backend] Inference completed in %.2f ms, %d segments\n",
-           g_metrics.last_inference_time_ms, n_segments);
+           inference_time_ms, n_segments);
     
     return WB_OK;
 }
@@ -279,8 +829,60 @@ WBErrorCode wb_transcribe(
  * ============================================ */
 
 WBMetrics wb_get_metrics(void) {
+    MemoryUsage usage;
+    memory_probe_read(usage, true);
+    
     std::lock_guard<std::mutex> lock(g_mutex);
-    return g_metrics;
+    WBMetrics metrics = g_metrics;
+    metrics.resident_model_bytes = registry_resident_bytes();
+    metrics.resident_models = (int)g_registry.size();
+    metrics.mapped_resident_bytes = usage.file_bytes;
+    metrics.private_resident_bytes = usage.anonymous_bytes;
+    metrics.proportional_resident_bytes = usage.proportional_bytes;
+    metrics.peak_memory_bytes = std::max(metrics.peak_memory_bytes, usage.peak_resident_bytes);
+    return metrics;
+}
+
+static WBLatencyStats latency_stats(const LatencyHistogram& histogram) {
+    LatencySummary summary = histogram.summarize();
+    WBLatencyStats stats;
+    stats.count = summary.count;
+    stats.mean_ms = summary.mean_us / 1000.0;
+    stats.p50_ms = summary.p50_us / 1000.0;
+    stats.p90_ms = summary.p90_us / 1000.0;
+    stats.p99_ms = summary.p99_us / 1000.0;
+    stats.p999_ms = summary.p999_us / 1000.0;
+    stats.max_ms = summary.max_us / 1000.0;
+    return stats;
+}
+
+WBMetricsSnapshot wb_get_metrics_snapshot(void) {
+    WBMetricsSnapshot snapshot;
+    snapshot.metrics = g_published_metrics.load();
+    snapshot.chunk_latency = latency_stats(g_chunk_latency);
+    snapshot.queue_wait = latency_stats(g_queue_wait);
+    snapshot.first_partial = latency_stats(g_first_partial);
+    snapshot.finalize = latency_stats(g_finalize_latency);
+    return snapshot;
+}
+
+WBErrorCode wb_trace_start(size_t max_events_per_thread) {
+    trace_start(max_events_per_thread);
+    return WB_OK;
+}
+
+WBErrorCode wb_trace_stop(const char* output_path) {
+    trace_stop();
+    if (!output_path) {
+        return WB_OK;
+    }
+    std::string error;
+    if (!trace_write_json(output_path, &error)) {
+        printf("[whisper_backend] Trace not written: %s\n", error.c_str());
+        return WB_ERROR_INIT_FAILED;
+    }
+    printf("[whisper_backend] Trace written to %s\n", output_path);
+    return WB_OK;
 }
 
 /* ============================================
@@ -289,84 +891,1342 @@ WBMetrics wb_get_metrics(void) {
 
 #include <vector>
 #include <atomic>
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <thread>
 
 // Silence detection threshold (energy-based)
 static const float SILENCE_THRESHOLD = 0.001f;
 
-// Session state
+// VAD classifies frames of this length (30 ms), aligned to session start
+static const size_t VAD_FRAME_SAMPLES = 480;
+
+// Audio kept after the last speech frame when an utterance ends
+static const int ENDPOINT_TAIL_MS = 200;
+
+// Audio kept before the first speech frame of an utterance
+static const int PRE_ROLL_MS = 300;
+
+static const int SAMPLE_RATE = 16000;
+
+// whisper_full returns no segments for input shorter than 1 s
+static const size_t MIN_INFERENCE_SAMPLES = SAMPLE_RATE + SAMPLE_RATE / 20;
+
+// Longest run of words checked when removing boundary duplicates
+static const size_t MAX_DUPLICATE_RUN = 3;
+
+// Duplicate words must start within this distance of each other
+static const int64_t DUPLICATE_TOLERANCE_MS = 400;
+
+// One encoder frame covers 20 ms of audio (1500 frames = 30 s)
+static const int MS_PER_AUDIO_CTX_FRAME = 20;
+
+// Adaptive windows: weight of the newest RTF sample, windows run at a
+// size before it changes again, and the shortest step allowed
+static const double RTF_SMOOTHING = 0.3;
+static const int ADAPT_SETTLE_WINDOWS = 2;
+static const int MIN_ADAPTIVE_STEP_MS = 200;
+
+// Degradation: windows over degrade_rtf before stepping down, windows
+// under half of it before stepping up (doubled by each step up that is
+// undone before this many windows, up to the maximum)
+static const int DEGRADE_SETTLE_WINDOWS = 3;
+static const int UPGRADE_SETTLE_WINDOWS = 8;
+static const int MAX_UPGRADE_SETTLE_WINDOWS = 64;
+static const float UPGRADE_RTF_FRACTION = 0.5f;
+
+/**
+ * A decoded word with absolute session timestamps
+ */
+struct TimedWord {
+    std::string text;   // As decoded, including leading space
+    int64_t t0_ms;
+    int64_t t1_ms;
+};
+
+/**
+ * A closed utterance waiting for the final model (two-tier sessions)
+ */
+struct FinalJob {
+    int utterance;
+    std::vector<float> audio;
+    std::string draft_text;     // Delivered instead if the final pass fails
+};
+
+/**
+ * Session state.
+ * Owns a whisper_state on the shared model; mutex serializes calls on
+ * this session only. Lock order: session mutex, then g_mutex.
+ */
 struct StreamingSession {
-    uint32_t id;
-    bool active;
-    WBPartialCallback callback;
-    void* user_data;
-    std::vector<std::string> partial_transcripts;
+    std::mutex mutex;
+    std::shared_ptr<LoadedModel> model;
+    struct whisper_state* state = nullptr;
+    
+    uint32_t id = 0;
+    bool active = false;
+    WBPartialCallback callback = nullptr;
+    void* user_data = nullptr;
+    WBSessionConfig config = {};
+    std::string language;
     std::chrono::time_point<std::chrono::high_resolution_clock> start_time;
+    
+    // Current wb_process_chunk_queued / finalize call (queue wait of its windows)
+    std::chrono::time_point<std::chrono::high_resolution_clock> call_start;
+    double caller_wait_ms = 0.0;
+    
+    // Time to first partial: from the first audio as pushed to the caller
+    std::chrono::time_point<std::chrono::high_resolution_clock> first_audio_time;
+    bool has_audio = false;
+    bool first_partial_sent = false;
+    
+    // Session audio: window_audio[0] is at buffer_start_sample, the
+    // sliding window starts at window_start_sample. Audio before the
+    // window is only kept for a two-tier final pass.
+    std::vector<float> window_audio;
+    std::vector<float> pad_audio;   // Short windows padded to MIN_INFERENCE_SAMPLES
+    int64_t buffer_start_sample = 0;
+    int64_t window_start_sample = 0;
+    int windows_run = 0;
+    int windows_skipped = 0;
+    
+    // Everything before committed_until_ms has been emitted
+    int64_t committed_until_ms = 0;
+    std::vector<TimedWord> committed_words;     // Current utterance
+    
+    // VAD (vad_enabled): one flag per frame, classified as audio arrives.
+    // frame_speech[0] is frame first_flag_frame; frames entirely before
+    // the window are dropped with it.
+    VoiceDetector vad;
+    std::vector<uint8_t> frame_speech;
+    int64_t first_flag_frame = 0;
+    int64_t vad_sample = 0;             // First sample not yet classified
+    
+    // Endpointing (see detect_endpoints); sample positions are absolute
+    bool endpointing = false;
+    bool in_utterance = false;
+    int64_t last_speech_end_sample = 0;
+    size_t silence_samples = 0;         // Continuous silence since last speech
+    int utterances = 0;
+    
+    // Adaptive windows (config.adaptive_window, see adapt_window)
+    double rtf_avg = 0.0;               // 0 = not measured at this size yet
+    int windows_at_size = 0;
+    
+    // Degradation (config.degrade_rtf, see update_quality)
+    WBQualityLevel quality = WB_QUALITY_FULL;
+    std::shared_ptr<LoadedModel> fallback_model;
+    struct whisper_state* fallback_state = nullptr;     // Created on first use
+    double level_rtf = 0.0;             // 0 = not measured at this level yet
+    int windows_at_level = 0;
+    int upgrade_settle_windows = UPGRADE_SETTLE_WINDOWS;
+    bool upgraded = false;              // Current level was reached by a step up
+    
+    // Two-tier (config.final_model, see run_final_passes). Jobs, texts
+    // and final_stopping are guarded by final_mutex; final_state is used
+    // by the final thread, or by finalize once it has been joined.
+    std::shared_ptr<LoadedModel> final_model;
+    struct whisper_state* final_state = nullptr;
+    int64_t utterance_start_sample = 0;     // Audio kept for the final pass
+    std::thread final_thread;
+    std::mutex final_mutex;
+    std::condition_variable final_cv;
+    std::deque<FinalJob> final_jobs;
+    std::vector<std::string> final_texts;   // Finished, not yet delivered
+    bool final_stopping = false;
+    std::atomic<bool> final_abort{false};
+    
+    ~StreamingSession() {
+        if (final_thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(final_mutex);
+                final_stopping = true;
+            }
+            final_abort = true;
+            final_cv.notify_one();
+            final_thread.join();
+        }
+        
+        // States must go before the (possibly last) model references
+        if (final_state) {
+            whisper_free_state(final_state);
+        }
+        if (fallback_state) {
+            whisper_free_state(fallback_state);
+        }
+        if (state) {
+            whisper_free_state(state);
+        }
+    }
 };
 
-static StreamingSession g_session = {0};
 static std::atomic<uint32_t> g_next_session_id{1};
 
-uint32_t wb_start_session(WBPartialCallback callback, void* user_data) {
+static std::shared_ptr<StreamingSession> find_session(uint32_t session_id) {
     std::lock_guard<std::mutex> lock(g_mutex);
-    
-    if (!g_initialized) {
-        return 0;
-    }
-    
-    if (!g_ctx) {
-        printf("[whisper_backend] Cannot start session: no model loaded\n");
-        return 0;
-    }
-    
-    if (g_session.active) {
-        printf("[whisper_backend] Cannot start session: one already active\n");
-        return 0;
-    }
-    
-    // Initialize session
-    g_session.id = g_next_session_id++;
-    g_session.active = true;
-    g_session.callback = callback;
-    g_session.user_data = user_data;
-    g_session.partial_transcripts.clear();
-    g_session.start_time = std::chrono::high_resolution_clock::now();
-    
-    printf("[whisper_backend] Session %u started\n", g_session.id);
-    return g_session.id;
+    auto it = g_sessions.find(session_id);
+    return it != g_sessions.end() ? it->second : nullptr;
 }
 
-int wb_is_session_active(uint32_t session_id) {
+static std::shared_ptr<StreamingSession> take_session(uint32_t session_id) {
     std::lock_guard<std::mutex> lock(g_mutex);
-    return (g_session.active && g_session.id == session_id) ? 1 : 0;
+    auto it = g_sessions.find(session_id);
+    if (it == g_sessions.end()) {
+        return nullptr;
+    }
+    std::shared_ptr<StreamingSession> session = it->second;
+    g_sessions.erase(it);
+    return session;
 }
 
-int wb_is_silent(const float* pcm_data, size_t n_samples) {
-    if (!pcm_data || n_samples == 0) {
-        return 1;  // Treat invalid input as silent
-    }
-    
-    // Calculate RMS energy
-    float energy = 0.0f;
-    for (size_t i = 0; i < n_samples; i++) {
-        energy += pcm_data[i] * pcm_data[i];
-    }
-    energy = energy / (float)n_samples;
-    
-    return (energy < SILENCE_THRESHOLD) ? 1 : 0;
+static size_t ms_to_samples(int ms) {
+    return (size_t)ms * SAMPLE_RATE / 1000;
 }
 
-WBErrorCode wb_process_chunk(
-    uint32_t session_id,
-    const float* pcm_data,
-    size_t n_samples
-) {
+static int64_t samples_to_ms(int64_t samples) {
+    return samples * 1000 / SAMPLE_RATE;
+}
+
+WBSessionConfig wb_default_session_config(void) {
+    WBSessionConfig config;
+    config.language = nullptr;  // "en"
+    config.window_ms = 1500;
+    config.step_ms = 1200;
+    config.max_window_ms = 0;   // Fixed-size windows
+    config.reduce_audio_ctx = 1;
+    config.audio_ctx_margin_ms = 200;
+    config.audio_ctx_min = 128;
+    config.n_threads = 0;       // Auto
+    config.vad_enabled = 1;
+    config.endpoint_silence_ms = 700;
+    config.utterance_callback = nullptr;
+    config.adaptive_window = 0;
+    config.min_window_ms = 0;   // window_ms
+    config.target_rtf = 0.5f;
+    config.final_model = nullptr;
+    config.final_n_threads = 0; // Auto
+    config.degrade_rtf = 0.0f;  // Never degrade
+    config.fallback_model = nullptr;
+    config.quality_callback = nullptr;
+    config.timing_callback = nullptr;
+    return config;
+}
+
+/**
+ * Encoder context for a window of n_samples (0 = whisper default, full 30 s)
+ */
+static int window_audio_ctx(
+    struct whisper_context* ctx,
+    const WBSessionConfig& config,
+    size_t n_samples
+) {
+    if (!config.reduce_audio_ctx) {
+        return 0;
+    }
+    
+    int full_ctx = whisper_model_n_audio_ctx(ctx);
+    int64_t span_ms = samples_to_ms((int64_t)n_samples) + config.audio_ctx_margin_ms;
+    int frames = (int)((span_ms + MS_PER_AUDIO_CTX_FRAME - 1) / MS_PER_AUDIO_CTX_FRAME);
+    
+    frames = std::max(frames, config.audio_ctx_min);
+    return frames >= full_ctx ? 0 : frames;
+}
+
+/**
+ * Run one short inference on silence so whisper.cpp allocates the
+ * state's KV caches and compute buffers (and touches the weights) at
+ * load time instead of on the first window. Uses the encoder context of
+ * a default streaming window. The warmed state is kept for the next
+ * session or wb_transcribe. Runs once per loaded model.
+ */
+static WBErrorCode warm_up_model(LoadedModel& model) {
+    TraceScope trace("warm_up", "backend");
+    std::lock_guard<std::mutex> lock(model.spare_mutex);
+    if (model.warmed_up) {
+        return WB_OK;
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t private_before = private_resident_bytes();
+    
+    struct whisper_state* state = whisper_init_state(model.ctx);
+    if (!state) {
+        printf("[whisper_backend] Warm-up failed: state allocation failed\n");
+        return WB_ERROR_OUT_OF_MEMORY;
+    }
+    size_t private_state = private_resident_bytes();
+    
+    std::vector<float> silence(MIN_INFERENCE_SAMPLES, 0.0f);
+    WBSessionConfig config = wb_default_session_config();
+    
+    struct whisper_full_params wparams = 
+        whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+    wparams.print_progress = false;
+    wparams.print_special = false;
+    wparams.print_realtime = false;
+    wparams.print_timestamps = false;
+    wparams.single_segment = true;
+    wparams.no_context = true;
+    wparams.token_timestamps = true;  // Same buffers as streaming windows
+    wparams.language = "en";          // Skip language detection
+    wparams.audio_ctx = window_audio_ctx(model.ctx, config, silence.size());
+    
+    int result = whisper_full_with_state(model.ctx, state, wparams, 
+                                         silence.data(), (int)silence.size());
+    size_t private_after = private_resident_bytes();
+    double warmup_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    
+    if (result != 0) {
+        printf("[whisper_backend] Warm-up inference failed with code %d\n", result);
+        whisper_free_state(state);
+        return WB_ERROR_INFERENCE_FAILED;
+    }
+    
+    model.spare_state = state;
+    model.warmed_up = true;
+    
+    // Private memory growth approximates buffer sizes (other threads add noise)
+    size_t state_bytes = private_state > private_before ? private_state - private_before : 0;
+    size_t compute_bytes = private_after > private_state ? private_after - private_state : 0;
+    {
+        MetricsUpdate update;
+        g_metrics.warmup_time_ms = warmup_ms;
+        g_metrics.state_buffer_bytes = state_bytes;
+        g_metrics.warmup_compute_bytes = compute_bytes;
+        g_metrics.peak_memory_bytes = std::max<size_t>(g_metrics.peak_memory_bytes, memory_peak_kb() * 1024);
+    }
+    
+    printf("[whisper_backend] Warm-up done in %.2f ms (state %.1f MB, first inference +%.1f MB)\n",
+           warmup_ms, state_bytes / (1024.0 * 1024.0), compute_bytes / (1024.0 * 1024.0));
+    return WB_OK;
+}
+
+/**
+ * Normalize a word for duplicate comparison (lowercase alphanumerics)
+ */
+static std::string normalize_word(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (std::isalnum((unsigned char)c)) {
+            out += (char)std::tolower((unsigned char)c);
+        }
+    }
+    return out;
+}
+
+/**
+ * Collect words from the last whisper_full call.
+ * Tokens starting with a space begin a new word; token timestamps are
+ * used when valid, otherwise the segment span is split by text length.
+ */
+static void collect_words(
+    struct whisper_context* ctx,
+    struct whisper_state* state,
+    int64_t offset_ms,
+    std::vector<TimedWord>& words
+) {
+    const whisper_token eot = whisper_token_eot(ctx);
+    int n_segments = whisper_full_n_segments_from_state(state);
+    
+    for (int i = 0; i < n_segments; i++) {
+        size_t first_word = words.size();
+        int n_tokens = whisper_full_n_tokens_from_state(state, i);
+        bool token_times_valid = true;
+        
+        for (int j = 0; j < n_tokens; j++) {
+            whisper_token_data data = whisper_full_get_token_data_from_state(state, i, j);
+            if (data.id >= eot) {
+                continue;  // Special / timestamp tokens
+            }
+            const char* text = whisper_full_get_token_text_from_state(ctx, state, i, j);
+            if (!text || !*text) {
+                continue;
+            }
+            if (data.t0 < 0 || data.t1 < data.t0) {
+                token_times_valid = false;
+            }
+            
+            int64_t t0 = offset_ms + data.t0 * 10;  // centiseconds
+            int64_t t1 = offset_ms + data.t1 * 10;
+            
+            if (text[0] == ' ' || words.size() == first_word) {
+                words.push_back({text, t0, t1});
+            } else {
+                words.back().text += text;
+                words.back().t1_ms = t1;
+            }
+        }
+        
+        if (!token_times_valid && words.size() > first_word) {
+            int64_t seg_t0 = offset_ms + whisper_full_get_segment_t0_from_state(state, i) * 10;
+            int64_t seg_t1 = offset_ms + whisper_full_get_segment_t1_from_state(state, i) * 10;
+            size_t total_chars = 0;
+            for (size_t w = first_word; w < words.size(); w++) {
+                total_chars += words[w].text.size();
+            }
+            size_t chars = 0;
+            for (size_t w = first_word; w < words.size(); w++) {
+                words[w].t0_ms = seg_t0 + (seg_t1 - seg_t0) * (int64_t)chars / (int64_t)total_chars;
+                chars += words[w].text.size();
+                words[w].t1_ms = seg_t0 + (seg_t1 - seg_t0) * (int64_t)chars / (int64_t)total_chars;
+            }
+        }
+    }
+}
+
+/**
+ * Drop leading words of fresh that repeat the tail of committed.
+ * A run matches when the normalized text is equal and each pair starts
+ * within DUPLICATE_TOLERANCE_MS (timestamps drift between windows).
+ */
+static void drop_boundary_duplicates(
+    const std::vector<TimedWord>& committed,
+    std::vector<TimedWord>& fresh
+) {
+    size_t max_run = std::min({MAX_DUPLICATE_RUN, committed.size(), fresh.size()});
+    
+    for (size_t run = max_run; run > 0; run--) {
+        bool match = true;
+        for (size_t k = 0; k < run && match; k++) {
+            const TimedWord& a = committed[committed.size() - run + k];
+            const TimedWord& b = fresh[k];
+            std::string na = normalize_word(a.text);
+            match = !na.empty() && na == normalize_word(b.text) &&
+                    std::llabs(a.t0_ms - b.t0_ms) <= DUPLICATE_TOLERANCE_MS;
+        }
+        if (match) {
+            fresh.erase(fresh.begin(), fresh.begin() + run);
+            return;
+        }
+    }
+}
+
+/**
+ * First sample of the window in the session buffer
+ */
+static const float* window_data(const StreamingSession& session) {
+    return session.window_audio.data() + (session.window_start_sample - session.buffer_start_sample);
+}
+
+/**
+ * Samples buffered from the window start on
+ */
+static size_t window_size(const StreamingSession& session) {
+    return (size_t)(session.buffer_start_sample + (int64_t)session.window_audio.size() - 
+                    session.window_start_sample);
+}
+
+/**
+ * True if any VAD frame overlapping the first n_samples of the window is
+ * speech. Per-frame rather than whole-window energy, so a short word
+ * inside a mostly silent window still counts. A trailing partial frame
+ * is checked against the current threshold without updating the detector.
+ */
+static bool window_has_speech(const StreamingSession& session, size_t n_samples) {
+    const int64_t start = session.window_start_sample;
+    const int64_t end = start + (int64_t)n_samples;
+    const int64_t frame = (int64_t)VAD_FRAME_SAMPLES;
+    
+    for (int64_t k = start / frame; k * frame < end; k++) {
+        int64_t index = k - session.first_flag_frame;
+        if (index >= 0 && index < (int64_t)session.frame_speech.size()) {
+            if (session.frame_speech[(size_t)index]) {
+                return true;
+            }
+            continue;
+        }
+        
+        int64_t from = std::max(k * frame, start);
+        int64_t to = std::min((k + 1) * frame, end);
+        VadFeatures features = vad_compute_features(
+            window_data(session) + (from - start), (size_t)(to - from));
+        if (session.vad.is_speech(features)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Resize the session's windows from the RTF of the window just run
+ * (adaptive_window). Only the next windows change; overlap is kept.
+ */
+static void adapt_window(StreamingSession& session, double rtf) {
+    WBSessionConfig& cfg = session.config;
+    const int overlap_ms = cfg.window_ms - cfg.step_ms;
+    session.rtf_avg = session.rtf_avg > 0 ? session.rtf_avg + RTF_SMOOTHING * (rtf - session.rtf_avg) 
+                                          : rtf;
+    {
+        MetricsUpdate update;
+        g_metrics.current_window_ms = cfg.window_ms;
+        g_metrics.window_rtf = session.rtf_avg;
+    }
+    if (++session.windows_at_size < ADAPT_SETTLE_WINDOWS) {
+        return;
+    }
+    
+    int step_ms = cfg.step_ms;
+    if (session.rtf_avg > cfg.target_rtf) {
+        // Cost is mostly per call: stretching the step by the overshoot
+        // brings the RTF back to about the target
+        step_ms = (int)(step_ms * std::min(2.0, session.rtf_avg / cfg.target_rtf)) + 1;
+    } else if (session.rtf_avg < cfg.target_rtf / 2) {
+        step_ms = step_ms * 3 / 4;
+    }
+    int window_ms = std::max(cfg.min_window_ms, std::min(cfg.max_window_ms, step_ms + overlap_ms));
+    if (window_ms == cfg.window_ms) {
+        return;
+    }
+    
+    printf("[whisper_backend] Session %u window %d -> %d ms (RTF %.3f, target %.3f)\n",
+           session.id, cfg.window_ms, window_ms, session.rtf_avg, cfg.target_rtf);
+    cfg.window_ms = window_ms;
+    cfg.step_ms = window_ms - overlap_ms;
+    session.rtf_avg = 0.0;
+    session.windows_at_size = 0;
+}
+
+/**
+ * Switch the session to level, reporting it to quality_callback
+ */
+static void set_quality(StreamingSession& session, WBQualityLevel level) {
+    printf("[whisper_backend] Session %u quality %d -> %d (RTF %.2f, threshold %.2f)\n",
+           session.id, (int)session.quality, (int)level, session.level_rtf, session.config.degrade_rtf);
+    
+    float rtf = (float)session.level_rtf;
+    session.upgraded = level < session.quality;
+    session.quality = level;
+    session.level_rtf = 0.0;
+    session.windows_at_level = 0;
+    {
+        MetricsUpdate update;
+        g_metrics.quality_level = (int)level;
+        g_metrics.quality_changes++;
+    }
+    if (session.config.quality_callback) {
+        session.config.quality_callback(level, rtf, session.user_data);
+    }
+}
+
+/**
+ * Stage boundaries of one whisper_full call, taken from its hooks
+ * (see WBStageTimings)
+ */
+struct StageClock {
+    std::chrono::time_point<std::chrono::high_resolution_clock> start;
+    std::chrono::time_point<std::chrono::high_resolution_clock> encoder_begin;
+    std::chrono::time_point<std::chrono::high_resolution_clock> first_token;
+    bool encoder_begun = false;
+    int decode_steps = 0;
+};
+
+static void attach_stage_clock(struct whisper_full_params& wparams, StageClock& clock) {
+    // Long audio is encoded once per 30 s; the first window's boundary is kept
+    wparams.encoder_begin_callback = [](struct whisper_context*, struct whisper_state*, void* user_data) {
+        StageClock* clock = static_cast<StageClock*>(user_data);
+        if (!clock->encoder_begun) {
+            clock->encoder_begin = std::chrono::high_resolution_clock::now();
+            clock->encoder_begun = true;
+        }
+        return true;
+    };
+    wparams.encoder_begin_callback_user_data = &clock;
+    wparams.logits_filter_callback = [](struct whisper_context*, struct whisper_state*,
+                                        const whisper_token_data*, int, float*, void* user_data) {
+        StageClock* clock = static_cast<StageClock*>(user_data);
+        if (clock->decode_steps++ == 0) {
+            clock->first_token = std::chrono::high_resolution_clock::now();
+        }
+    };
+    wparams.logits_filter_callback_user_data = &clock;
+}
+
+static double elapsed_ms(std::chrono::time_point<std::chrono::high_resolution_clock> from,
+                         std::chrono::time_point<std::chrono::high_resolution_clock> to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+static uint64_t ms_to_us(double ms) {
+    return ms > 0 ? (uint64_t)(ms * 1000.0 + 0.5) : 0;
+}
+
+/**
+ * Split a finished call into stages; hooks that never fired (failed or
+ * empty decode) leave the time in the last stage reached
+ */
+static void read_stage_clock(const StageClock& clock,
+                             std::chrono::time_point<std::chrono::high_resolution_clock> end,
+                             WBStageTimings& stages) {
+    auto encoder_begin = clock.encoder_begun ? clock.encoder_begin : end;
+    auto first_token = clock.decode_steps > 0 ? clock.first_token : end;
+    stages.mel_ms = elapsed_ms(clock.start, encoder_begin);
+    stages.encode_ms = elapsed_ms(encoder_begin, first_token);
+    stages.decode_ms = elapsed_ms(first_token, end);
+    stages.inference_ms = elapsed_ms(clock.start, end);
+}
+
+/**
+ * Trace a window's whisper_full call and its stages, starting at
+ * start_us on the trace clock
+ */
+static void trace_stages(int64_t start_us, const WBChunkTiming& timing) {
+    const WBStageTimings& stages = timing.stages;
+    int64_t mel_us = (int64_t)ms_to_us(stages.mel_ms);
+    int64_t encode_us = (int64_t)ms_to_us(stages.encode_ms);
+    trace_complete("whisper_full", "backend", start_us, (int64_t)ms_to_us(stages.inference_ms),
+                   "audio_ctx", timing.audio_ctx);
+    trace_complete("mel", "backend", start_us, mel_us);
+    trace_complete("encode", "backend", start_us + mel_us, encode_us);
+    trace_complete("decode", "backend", start_us + mel_us + encode_us, (int64_t)ms_to_us(stages.decode_ms),
+                   "steps", timing.decode_steps);
+}
+
+/**
+ * Publish a window's timing record: metrics, rolling history and the
+ * session's timing callback
+ */
+static void record_chunk_timing(StreamingSession& session, const WBChunkTiming& timing) {
+    const WBStageTimings& stages = timing.stages;
+    g_chunk_latency.record(ms_to_us(stages.queue_wait_ms + stages.inference_ms + stages.callback_ms));
+    g_queue_wait.record(ms_to_us(stages.queue_wait_ms));
+    {
+        MetricsUpdate update;
+        g_metrics.last_chunk = timing;
+        g_stage_history[g_stage_next] = stages;
+        g_stage_next = (g_stage_next + 1) % WB_STAGE_HISTORY;
+        g_stage_count = std::min(g_stage_count + 1, WB_STAGE_HISTORY);
+        
+        // Rolling aggregates
+        WBStageTimings& mean = g_metrics.stage_mean;
+        WBStageTimings& max = g_metrics.stage_max;
+        mean = {};
+        max = {};
+        g_metrics.stage_windows = g_stage_count;
+        auto add = [](double& mean_ms, double& max_ms, double value, int count) {
+            mean_ms += value / count;
+            max_ms = std::max(max_ms, value);
+        };
+        for (int i = 0; i < g_stage_count; i++) {
+            const WBStageTimings& t = g_stage_history[i];
+            add(mean.queue_wait_ms, max.queue_wait_ms, t.queue_wait_ms, g_stage_count);
+            add(mean.mel_ms, max.mel_ms, t.mel_ms, g_stage_count);
+            add(mean.encode_ms, max.encode_ms, t.encode_ms, g_stage_count);
+            add(mean.decode_ms, max.decode_ms, t.decode_ms, g_stage_count);
+            add(mean.callback_ms, max.callback_ms, t.callback_ms, g_stage_count);
+            add(mean.inference_ms, max.inference_ms, t.inference_ms, g_stage_count);
+        }
+    }
+    if (session.config.timing_callback) {
+        session.config.timing_callback(&timing, session.user_data);
+    }
+}
+
+/**
+ * Step the quality level down or up from the RTF of the window just run
+ * (degrade_rtf > 0). Levels are measured separately; a step in either
+ * direction needs several windows at the current level. With adaptive
+ * windows, quality is only given up while windows (adaptive or merged
+ * backed-up audio) are at max_window_ms.
+ */
+static void update_quality(StreamingSession& session, double rtf, size_t n_samples) {
+    const WBSessionConfig& cfg = session.config;
+    const double threshold = cfg.degrade_rtf;
+    session.level_rtf = session.level_rtf > 0 ? session.level_rtf + RTF_SMOOTHING * (rtf - session.level_rtf)
+                                              : rtf;
+    session.windows_at_level++;
+    
+    WBQualityLevel lowest = session.fallback_model ? WB_QUALITY_FALLBACK_MODEL : WB_QUALITY_FAST_DECODE;
+    bool windows_at_max = !cfg.adaptive_window || ms_to_samples(cfg.max_window_ms) <= n_samples;
+    if (session.quality < lowest && windows_at_max && 
+        session.windows_at_level >= DEGRADE_SETTLE_WINDOWS && session.level_rtf > threshold) {
+        if (session.upgraded && session.windows_at_level < session.upgrade_settle_windows) {
+            // The last step up did not hold; probe less often
+            session.upgrade_settle_windows = std::min(session.upgrade_settle_windows * 2, 
+                                                      MAX_UPGRADE_SETTLE_WINDOWS);
+        }
+        set_quality(session, (WBQualityLevel)(session.quality + 1));
+    } else if (session.quality > WB_QUALITY_FULL && 
+               session.windows_at_level >= session.upgrade_settle_windows &&
+               session.level_rtf < threshold * UPGRADE_RTF_FRACTION) {
+        set_quality(session, (WBQualityLevel)(session.quality - 1));
+    }
+}
+
+/**
+ * Run inference on one window and commit the words it owns.
+ * Called with session.mutex held; g_mutex is not held.
+ * A non-final window owns words whose midpoint falls before the middle
+ * of its trailing overlap; the next window owns the rest.
+ */
+static void run_window(StreamingSession& session, size_t n_samples, bool is_final) {
+    TraceScope trace("window", "backend", "session", session.id);
+    
+    // The fallback state is created the first time the session degrades
+    // that far, so sessions that never do pay nothing for it
+    struct whisper_context* ctx = session.model->ctx;
+    struct whisper_state* state = session.state;
+    if (session.quality == WB_QUALITY_FALLBACK_MODEL) {
+        if (!session.fallback_state) {
+            session.fallback_state = take_state(*session.fallback_model);
+        }
+        if (session.fallback_state) {
+            ctx = session.fallback_model->ctx;
+            state = session.fallback_state;
+        }
+    }
+    int64_t window_start_ms = samples_to_ms(session.window_start_sample);
+    int64_t window_end_ms = samples_to_ms(session.window_start_sample + (int64_t)n_samples);
+    int overlap_ms = session.config.window_ms - session.config.step_ms;
+    int64_t cut_ms = is_final ? INT64_MAX : window_end_ms - overlap_ms / 2;
+    int64_t committed_end_ms = is_final ? window_end_ms : cut_ms;
+    
+    if (session.config.vad_enabled && 
+        !window_has_speech(session, n_samples)) {
+        // Nothing to own in a silent window; move the boundary on
+        int64_t new_audio_ms = std::max<int64_t>(0, committed_end_ms - session.committed_until_ms);
+        session.committed_until_ms = committed_end_ms;
+        session.windows_skipped++;
+        {
+            MetricsUpdate update;
+            g_metrics.windows_skipped++;
+            g_metrics.skipped_audio_ms += (double)new_audio_ms;
+            g_metrics.last_skip_reason = WB_SKIP_SILENCE;
+        }
+        printf("[whisper_backend] Window %lld-%lldms skipped (silence)\n",
+               (long long)window_start_ms, (long long)window_end_ms);
+        return;
+    }
+    
+    // whisper_full ignores sub-second input; pad with silence (in a copy,
+    // audio past n_samples may belong to the next utterance)
+    const float* inference_audio = window_data(session);
+    if (n_samples < MIN_INFERENCE_SAMPLES) {
+        session.pad_audio.assign(inference_audio, inference_audio + n_samples);
+        session.pad_audio.resize(MIN_INFERENCE_SAMPLES, 0.0f);
+        inference_audio = session.pad_audio.data();
+    }
+    size_t inference_samples = std::max(n_samples, MIN_INFERENCE_SAMPLES);
+    
+    struct whisper_full_params wparams = 
+        whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+    
+    wparams.print_progress = false;
+    wparams.print_special = false;
+    wparams.print_realtime = false;
+    wparams.print_timestamps = false;
+    wparams.translate = 0;
+    wparams.single_segment = false;
+    wparams.no_context = true;
+    wparams.token_timestamps = true;  // Needed for boundary ownership
+    wparams.language = session.language.c_str();
+    wparams.audio_ctx = window_audio_ctx(ctx, session.config, inference_samples);
+    if (session.config.n_threads > 0) {
+        wparams.n_threads = session.config.n_threads;
+    }
+    if (session.quality >= WB_QUALITY_FAST_DECODE) {
+        wparams.greedy.best_of = 1;
+        wparams.temperature_inc = 0.0f;     // No re-decode at higher temperatures
+    }
+    StageClock clock;
+    attach_stage_clock(wparams, clock);
+    
+    int64_t trace_start_us = trace_enabled() ? trace_now_us() : -1;
+    auto start = std::chrono::high_resolution_clock::now();
+    clock.start = start;
+    int result = whisper_full_with_state(ctx, state, wparams,
+                                         inference_audio, (int)inference_samples);
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    double chunk_time = std::chrono::duration<double, std::milli>(end - start).count();
+    int audio_ctx = wparams.audio_ctx > 0 ? wparams.audio_ctx 
+                                          : whisper_model_n_audio_ctx(ctx);
+    
+    WBChunkTiming timing = {};
+    timing.session_id = session.id;
+    timing.window_start_ms = window_start_ms;
+    timing.window_end_ms = window_end_ms;
+    timing.audio_ctx = audio_ctx;
+    timing.decode_steps = clock.decode_steps;
+    read_stage_clock(clock, end, timing.stages);
+    timing.stages.queue_wait_ms = session.caller_wait_ms + elapsed_ms(session.call_start, start);
+    if (trace_start_us >= 0) {
+        trace_stages(trace_start_us, timing);
+    }
+    {
+        MetricsUpdate update;
+        g_metrics.last_inference_time_ms = chunk_time;
+        g_metrics.last_audio_ctx = audio_ctx;
+        g_metrics.windows_inferred++;
+        g_metrics.last_skip_reason = WB_SKIP_NONE;
+    }
+    session.windows_run++;
+    
+    // RTF over the new audio (the overlap was paid for by the last window)
+    double new_audio_ms = (double)(window_end_ms - window_start_ms - overlap_ms);
+    if (!is_final && new_audio_ms > 0) {
+        double rtf = chunk_time / new_audio_ms;
+        if (session.config.adaptive_window) {
+            adapt_window(session, rtf);
+        }
+        if (session.config.degrade_rtf > 0) {
+            update_quality(session, rtf, n_samples);
+        }
+    }
+    
+    if (result != 0) {
+        // Recoverable error: drop window, continue session
+        printf("[whisper_backend] Window inference failed (dropped)\n");
+        record_chunk_timing(session, timing);
+        return;
+    }
+    
+    std::vector<TimedWord> words;
+    collect_words(ctx, state, window_start_ms, words);
+    
+    std::vector<TimedWord> fresh;
+    for (const auto& word : words) {
+        int64_t mid = (word.t0_ms + word.t1_ms) / 2;
+        if (mid >= session.committed_until_ms && mid < cut_ms) {
+            fresh.push_back(word);
+        }
+    }
+    drop_boundary_duplicates(session.committed_words, fresh);
+    
+    session.committed_until_ms = committed_end_ms;
+    
+    std::string partial;
+    for (const auto& word : fresh) {
+        partial += word.text;
+        session.committed_words.push_back(word);
+    }
+    
+    if (!partial.empty() && session.callback) {
+        auto callback_start = std::chrono::high_resolution_clock::now();
+        if (!session.first_partial_sent) {
+            g_first_partial.record(ms_to_us(elapsed_ms(session.first_audio_time, callback_start)));
+            session.first_partial_sent = true;
+        }
+        {
+            TraceScope trace_callback("partial_callback", "backend", "session", session.id);
+            session.callback(partial.c_str(), session.user_data);
+        }
+        timing.stages.callback_ms = elapsed_ms(callback_start, std::chrono::high_resolution_clock::now());
+    }
+    record_chunk_timing(session, timing);
+    
+    printf("[whisper_backend] Window %lld-%lldms processed: %.2fms (mel %.2f, encode %.2f, decode %.2f), "
+           "audio_ctx %d, text: '%s'\n",
+           (long long)window_start_ms, (long long)window_end_ms, chunk_time,
+           timing.stages.mel_ms, timing.stages.encode_ms, timing.stages.decode_ms,
+           audio_ctx, partial.c_str());
+}
+
+/**
+ * Move the window start on by n samples and drop audio no longer
+ * needed (a two-tier session keeps the open utterance)
+ */
+static void advance_window(StreamingSession& session, size_t n) {
+    session.window_start_sample += (int64_t)n;
+    
+    int64_t keep_from = session.window_start_sample;
+    if (session.final_model) {
+        keep_from = std::min(keep_from, session.utterance_start_sample);
+    }
+    if (keep_from > session.buffer_start_sample) {
+        session.window_audio.erase(session.window_audio.begin(), 
+                                   session.window_audio.begin() + (keep_from - session.buffer_start_sample));
+        session.buffer_start_sample = keep_from;
+    }
+    
+    // Flags of frames that ended before the new window start
+    int64_t first_needed = session.window_start_sample / (int64_t)VAD_FRAME_SAMPLES;
+    int64_t drop = std::min<int64_t>(first_needed - session.first_flag_frame,
+                                     (int64_t)session.frame_speech.size());
+    if (drop > 0) {
+        session.frame_speech.erase(session.frame_speech.begin(), 
+                                   session.frame_speech.begin() + drop);
+        session.first_flag_frame += drop;
+    }
+}
+
+/**
+ * Classify the next complete buffered frame (at vad_sample)
+ * @return false if less than a frame is buffered past vad_sample
+ */
+static bool classify_next_frame(StreamingSession& session, bool* speech) {
+    const int64_t buffered_end = session.buffer_start_sample + (int64_t)session.window_audio.size();
+    if (session.vad_sample + (int64_t)VAD_FRAME_SAMPLES > buffered_end) {
+        return false;
+    }
+    
+    const float* frame = session.window_audio.data() + 
+                         (session.vad_sample - session.buffer_start_sample);
+    *speech = session.vad.classify_frame(frame, VAD_FRAME_SAMPLES);
+    
+    if (session.frame_speech.empty()) {
+        session.first_flag_frame = session.vad_sample / (int64_t)VAD_FRAME_SAMPLES;
+    }
+    session.frame_speech.push_back(*speech ? 1 : 0);
+    session.vad_sample += VAD_FRAME_SAMPLES;
+    return true;
+}
+
+/**
+ * Classify every complete buffered frame (VAD gating without endpointing)
+ */
+static void classify_frames(StreamingSession& session) {
+    bool speech = false;
+    while (classify_next_frame(session, &speech)) {
+    }
+}
+
+/**
+ * Run every complete window within the first limit samples of the buffer.
+ * Backed-up audio grows the window up to max_window_ms: one larger
+ * inference instead of several late ones. Audio is backed up when
+ * another full step is already buffered behind the window; a caller
+ * that keeps up always gets window_ms windows.
+ */
+static void run_complete_windows(StreamingSession& session, size_t limit) {
+    while (true) {
+        // Re-read each time: adaptive windows may have resized
+        const size_t window_samples = ms_to_samples(session.config.window_ms);
+        const size_t step_samples = ms_to_samples(session.config.step_ms);
+        const size_t max_window_samples = ms_to_samples(session.config.max_window_ms);
+        const size_t overlap_samples = window_samples - step_samples;
+        if (limit < window_samples) {
+            break;
+        }
+        
+        size_t n = limit >= window_samples + step_samples 
+                 ? std::min(limit, max_window_samples) 
+                 : window_samples;
+        run_window(session, n, false);
+        
+        // Next window starts overlap_samples before this one ended
+        size_t advance = n - overlap_samples;
+        advance_window(session, advance);
+        limit -= advance;
+    }
+}
+
+/**
+ * Text without leading and trailing whitespace
+ */
+static std::string trim_text(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t\n");
+    size_t end_pos = text.find_last_not_of(" \t\n");
+    if (start == std::string::npos || end_pos == std::string::npos) {
+        return std::string();
+    }
+    return text.substr(start, end_pos - start + 1);
+}
+
+/**
+ * Join committed words into trimmed text
+ */
+static std::string committed_text(const StreamingSession& session) {
+    std::string text;
+    for (const auto& word : session.committed_words) {
+        text += word.text;
+    }
+    return trim_text(text);
+}
+
+/**
+ * Transcribe a whole utterance with the final model (final_state).
+ * Falls back to the draft text if inference fails or is aborted.
+ */
+static std::string transcribe_final(StreamingSession& session, FinalJob& job) {
+    TraceScope trace("final_pass", "backend", "session", session.id);
+    struct whisper_context* ctx = session.final_model->ctx;
+    if (job.audio.size() < MIN_INFERENCE_SAMPLES) {
+        job.audio.resize(MIN_INFERENCE_SAMPLES, 0.0f);
+    }
+    
+    struct whisper_full_params wparams = 
+        whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+    
+    wparams.print_progress = false;
+    wparams.print_special = false;
+    wparams.print_realtime = false;
+    wparams.print_timestamps = false;
+    wparams.translate = 0;
+    wparams.single_segment = false;
+    wparams.no_context = true;
+    wparams.language = session.language.c_str();
+    wparams.audio_ctx = window_audio_ctx(ctx, session.config, job.audio.size());
+    if (session.config.final_n_threads > 0) {
+        wparams.n_threads = session.config.final_n_threads;
+    }
+    wparams.abort_callback = [](void* user_data) {
+        return static_cast<StreamingSession*>(user_data)->final_abort.load();
+    };
+    wparams.abort_callback_user_data = &session;
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    int result = whisper_full_with_state(ctx, session.final_state, wparams,
+                                         job.audio.data(), (int)job.audio.size());
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    double final_time = std::chrono::duration<double, std::milli>(end - start).count();
+    if (result != 0) {
+        printf("[whisper_backend] Final pass of utterance %d failed (draft kept)\n", job.utterance);
+        return job.draft_text;
+    }
+    {
+        MetricsUpdate update;
+        g_metrics.final_passes++;
+        g_metrics.last_final_time_ms = final_time;
+    }
+    
+    std::string text;
+    int n_segments = whisper_full_n_segments_from_state(session.final_state);
+    for (int i = 0; i < n_segments; i++) {
+        const char* segment_text = whisper_full_get_segment_text_from_state(session.final_state, i);
+        if (segment_text) {
+            text += segment_text;
+        }
+    }
+    text = trim_text(text);
+    
+    printf("[whisper_backend] Utterance %d final pass: %.2fms, draft '%s', final '%s'\n",
+           job.utterance, final_time, job.draft_text.c_str(), text.c_str());
+    return text;
+}
+
+/**
+ * Final thread of a two-tier session: runs queued utterances in order
+ * until stopped and drained
+ */
+static void run_final_passes(StreamingSession* session) {
+    std::unique_lock<std::mutex> lock(session->final_mutex);
+    while (true) {
+        session->final_cv.wait(lock, [session] {
+            return session->final_stopping || !session->final_jobs.empty();
+        });
+        if (session->final_jobs.empty()) {
+            break;
+        }
+        
+        FinalJob job = std::move(session->final_jobs.front());
+        session->final_jobs.pop_front();
+        lock.unlock();
+        std::string text = transcribe_final(*session, job);
+        lock.lock();
+        session->final_texts.push_back(std::move(text));
+    }
+}
+
+/**
+ * Copy of the utterance [utterance_start_sample, end_sample) from the
+ * session buffer (session.mutex held)
+ */
+static FinalJob utterance_job(const StreamingSession& session, int64_t end_sample, 
+                              const std::string& draft) {
+    const float* begin = session.window_audio.data() + 
+                         (session.utterance_start_sample - session.buffer_start_sample);
+    
+    FinalJob job;
+    job.utterance = session.utterances;
+    job.audio.assign(begin, begin + (end_sample - session.utterance_start_sample));
+    job.draft_text = draft;
+    return job;
+}
+
+/**
+ * Queue a closed utterance for the final thread (session.mutex held)
+ */
+static void queue_final_pass(StreamingSession& session, int64_t end_sample, const std::string& draft) {
+    FinalJob job = utterance_job(session, end_sample, draft);
+    {
+        std::lock_guard<std::mutex> lock(session.final_mutex);
+        session.final_jobs.push_back(std::move(job));
+    }
+    session.final_cv.notify_one();
+}
+
+/**
+ * Wait for queued final passes and stop the final thread. With discard,
+ * queued passes are dropped and a running one is aborted.
+ */
+static void stop_final_passes(StreamingSession& session, bool discard) {
+    if (!session.final_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(session.final_mutex);
+        if (discard) {
+            session.final_jobs.clear();
+            session.final_abort = true;
+        }
+        session.final_stopping = true;
+    }
+    session.final_cv.notify_one();
+    session.final_thread.join();
+}
+
+/**
+ * Hand finished final passes to utterance_callback, in utterance order
+ * (session.mutex held, so never concurrently with a partial)
+ */
+static void deliver_finals(StreamingSession& session) {
+    std::vector<std::string> texts;
+    {
+        std::lock_guard<std::mutex> lock(session.final_mutex);
+        texts.swap(session.final_texts);
+    }
+    for (const auto& text : texts) {
+        if (!text.empty()) {
+            TraceScope trace("utterance_callback", "backend", "session", session.id);
+            session.config.utterance_callback(text.c_str(), session.user_data);
+        }
+    }
+}
+
+/**
+ * Close the current utterance at absolute sample end_sample: transcribe
+ * what remains of it, deliver its text (two-tier: queue its final pass)
+ * and restart windowing there.
+ */
+static void end_utterance(StreamingSession& session, int64_t end_sample) {
+    size_t limit = (size_t)(end_sample - session.window_start_sample);
+    run_complete_windows(session, limit);
+    
+    size_t remaining = (size_t)(end_sample - session.window_start_sample);
+    if (remaining > 0 && samples_to_ms(end_sample) > session.committed_until_ms) {
+        run_window(session, remaining, true);
+    }
+    
+    std::string text = committed_text(session);
+    session.utterances++;
+    {
+        MetricsUpdate update;
+        g_metrics.utterances_endpointed++;
+    }
+    printf("[whisper_backend] Utterance %d ended at %lldms: '%s'\n",
+           session.utterances, (long long)samples_to_ms(end_sample), text.c_str());
+    
+    if (session.final_model) {
+        queue_final_pass(session, end_sample, text);
+    } else if (!text.empty()) {
+        TraceScope trace("utterance_callback", "backend", "session", session.id);
+        session.config.utterance_callback(text.c_str(), session.user_data);
+    }
+    
+    // Next utterance starts from scratch at the endpoint
+    session.committed_words.clear();
+    session.utterance_start_sample = end_sample;
+    advance_window(session, remaining);
+    session.committed_until_ms = samples_to_ms(end_sample);
+    session.in_utterance = false;
+    session.silence_samples = 0;
+}
+
+/**
+ * Classify newly buffered audio frame by frame and end the utterance
+ * after endpoint_silence_ms of continuous silence following speech.
+ * Between utterances only PRE_ROLL_MS of audio is kept, so the next
+ * utterance's windows start at its speech onset.
+ */
+static void detect_endpoints(StreamingSession& session) {
+    const size_t endpoint_samples = ms_to_samples(session.config.endpoint_silence_ms);
+    const int64_t tail_samples = (int64_t)ms_to_samples(ENDPOINT_TAIL_MS);
+    
+    bool speech = false;
+    while (classify_next_frame(session, &speech)) {
+        if (speech) {
+            session.in_utterance = true;
+            session.silence_samples = 0;
+            session.last_speech_end_sample = session.vad_sample;
+        } else if (session.in_utterance) {
+            session.silence_samples += VAD_FRAME_SAMPLES;
+            if (session.silence_samples >= endpoint_samples) {
+                end_utterance(session, std::min(session.last_speech_end_sample + tail_samples,
+                                                session.vad_sample));
+            }
+        }
+    }
+    
+    if (!session.in_utterance) {
+        int64_t keep_from = session.vad_sample - (int64_t)ms_to_samples(PRE_ROLL_MS);
+        if (keep_from > session.window_start_sample) {
+            session.utterance_start_sample = keep_from;
+            advance_window(session, (size_t)(keep_from - session.window_start_sample));
+            session.committed_until_ms = std::max(session.committed_until_ms, 
+                                                  samples_to_ms(keep_from));
+        }
+    }
+}
+
+uint32_t wb_start_session(WBPartialCallback callback, void* user_data) {
+    return wb_start_session_with_config(nullptr, callback, user_data);
+}
+
+/**
+ * Create a session with its own state on model (g_mutex not held)
+ */
+static uint32_t start_session_on_model(
+    const std::shared_ptr<LoadedModel>& model,
+    const WBSessionConfig* config,
+    WBPartialCallback callback,
+    void* user_data
+) {
+    if (!model) {
+        printf("[whisper_backend] Cannot start session: no model loaded\n");
+        return 0;
+    }
+    
+    WBSessionConfig cfg = config ? *config : wb_default_session_config();
+    if (cfg.window_ms <= 0 || cfg.step_ms <= 0 || cfg.step_ms > cfg.window_ms) {
+        printf("[whisper_backend] Cannot start session: invalid window %d/%d ms\n",
+               cfg.window_ms, cfg.step_ms);
+        return 0;
+    }
+    if (cfg.max_window_ms < cfg.window_ms) {
+        cfg.max_window_ms = cfg.window_ms;
+    }
+    if (cfg.adaptive_window) {
+        // Every size keeps the overlap and at least a minimal step
+        int overlap_ms = cfg.window_ms - cfg.step_ms;
+        if (cfg.min_window_ms <= 0 || cfg.min_window_ms > cfg.window_ms) {
+            cfg.min_window_ms = cfg.window_ms;
+        }
+        cfg.min_window_ms = std::max(cfg.min_window_ms, overlap_ms + MIN_ADAPTIVE_STEP_MS);
+        cfg.max_window_ms = std::max(cfg.max_window_ms, cfg.min_window_ms);
+        if (cfg.target_rtf <= 0.0f) {
+            cfg.target_rtf = 0.5f;
+        }
+    }
+    if (cfg.audio_ctx_margin_ms < 0) {
+        cfg.audio_ctx_margin_ms = 0;
+    }
+    
+    // Per-session KV cache and buffers; weights stay shared in model->ctx
+    auto session = std::make_shared<StreamingSession>();
+    session->state = take_state(*model);
+    if (!session->state) {
+        printf("[whisper_backend] Cannot start session: state allocation failed\n");
+        return 0;
+    }
+    
+    // Initialize session
+    session->model = model;
+    session->id = g_next_session_id++;
+    session->active = true;
+    session->callback = callback;
+    session->user_data = user_data;
+    session->config = cfg;
+    session->language = cfg.language ? cfg.language : "en";
+    session->config.language = session->language.c_str();
+    session->endpointing = cfg.vad_enabled && cfg.endpoint_silence_ms > 0 && 
+                           cfg.utterance_callback != nullptr;
+    session->window_audio.reserve(ms_to_samples(cfg.max_window_ms) + SAMPLE_RATE);
+    session->start_time = std::chrono::high_resolution_clock::now();
+    
+    if (cfg.final_model && !session->endpointing) {
+        // Without utterances the whole session would have to be kept
+        printf("[whisper_backend] Final model ignored: two-tier sessions need endpointing\n");
+        session->config.final_model = nullptr;
+    } else if (cfg.final_model) {
+        session->final_model = cfg.final_model->model;
+        session->final_state = take_state(*session->final_model);
+        if (!session->final_state) {
+            printf("[whisper_backend] Cannot start session: final state allocation failed\n");
+            return 0;
+        }
+        session->final_thread = std::thread(run_final_passes, session.get());
+    }
+    if (cfg.fallback_model) {
+        session->fallback_model = cfg.fallback_model->model;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (!g_initialized) {
+            return 0;
+        }
+        g_sessions[session->id] = session;
+    }
+    
+    printf("[whisper_backend] Session %u started (window %d ms, step %d ms%s)\n", 
+           session->id, cfg.window_ms, cfg.step_ms, session->final_model ? ", two-tier" : "");
+    return session->id;
+}
+
+uint32_t wb_start_session_with_config(
+    const WBSessionConfig* config,
+    WBPartialCallback callback,
+    void* user_data
+) {
+    std::shared_ptr<LoadedModel> model;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        
+        if (!g_initialized) {
+            return 0;
+        }
+        model = g_model;
+    }
+    
+    return start_session_on_model(model, config, callback, user_data);
+}
+
+uint32_t wb_start_model_session(
+    WBModel* model,
+    const WBSessionConfig* config,
+    WBPartialCallback callback,
+    void* user_data
+) {
+    if (!model || !wb_is_initialized()) {
+        return 0;
+    }
+    return start_session_on_model(model->model, config, callback, user_data);
+}
+
+int wb_is_session_active(uint32_t session_id) {
     std::lock_guard<std::mutex> lock(g_mutex);
+    return g_sessions.count(session_id) ? 1 : 0;
+}
+
+int wb_is_silent(const float* pcm_data, size_t n_samples) {
+    if (!pcm_data || n_samples == 0) {
+        return 1;  // Treat invalid input as silent
+    }
     
-    if (!g_initialized) {
+    // Mean square energy (vectorized, see vad.cpp)
+    VadFeatures features = vad_compute_features(pcm_data, n_samples);
+    
+    return (features.energy < SILENCE_THRESHOLD) ? 1 : 0;
+}
+
+WBErrorCode wb_process_chunk(
+    uint32_t session_id,
+    const float* pcm_data,
+    size_t n_samples
+) {
+    return wb_process_chunk_queued(session_id, pcm_data, n_samples, 0.0);
+}
+
+WBErrorCode wb_process_chunk_queued(
+    uint32_t session_id,
+    const float* pcm_data,
+    size_t n_samples,
+    double queue_wait_ms
+) {
+    TraceScope trace("process_chunk", "backend", "samples", (int64_t)n_samples);
+    auto call_start = std::chrono::high_resolution_clock::now();
+    
+    if (!wb_is_initialized()) {
         return WB_ERROR_NOT_INITIALIZED;
     }
     
-    if (!g_session.active || g_session.id != session_id) {
+    std::shared_ptr<StreamingSession> handle = find_session(session_id);
+    if (!handle) {
         printf("[whisper_backend] Invalid session ID: %u\n", session_id);
         return WB_ERROR_INFERENCE_FAILED;
     }
@@ -375,11 +2235,192 @@ WBErrorCode wb_process_chunk(
         return WB_ERROR_INVALID_AUDIO;
     }
     
-    if (!g_ctx) {
-        return WB_ERROR_MODEL_LOAD_FAILED;
+    StreamingSession& session = *handle;
+    std::lock_guard<std::mutex> session_lock(session.mutex);
+    if (!session.active) {
+        return WB_ERROR_INFERENCE_FAILED;  // Finalized/aborted concurrently
+    }
+    session.call_start = call_start;
+    session.caller_wait_ms = queue_wait_ms;
+    if (!session.has_audio) {
+        session.first_audio_time = call_start - std::chrono::microseconds(ms_to_us(queue_wait_ms));
+        session.has_audio = true;
+    }
+    
+    session.window_audio.insert(session.window_audio.end(), pcm_data, pcm_data + n_samples);
+    
+    if (session.endpointing) {
+        detect_endpoints(session);
+    } else if (session.config.vad_enabled) {
+        classify_frames(session);
+    }
+    run_complete_windows(session, window_size(session));
+    deliver_finals(session);
+    
+    return WB_OK;
+}
+
+WBErrorCode wb_finalize_session(
+    uint32_t session_id,
+    char* out_text,
+    size_t text_size
+) {
+    TraceScope trace("finalize", "backend", "session", session_id);
+    if (!out_text || text_size == 0) {
+        return WB_ERROR_INVALID_AUDIO;
+    }
+    
+    // Removed from the table first so no new call can reach it
+    std::shared_ptr<StreamingSession> handle = take_session(session_id);
+    if (!handle) {
+        return WB_ERROR_INFERENCE_FAILED;
+    }
+    
+    StreamingSession& session = *handle;
+    std::lock_guard<std::mutex> session_lock(session.mutex);
+    if (!session.active) {
+        return WB_ERROR_INFERENCE_FAILED;
+    }
+    session.call_start = std::chrono::high_resolution_clock::now();
+    session.caller_wait_ms = 0.0;
+    
+    // Transcribe the tail that never filled a complete window
+    const size_t tail = window_size(session);
+    int64_t buffered_end_ms = samples_to_ms(session.window_start_sample + (int64_t)tail);
+    if (tail > 0 && buffered_end_ms > session.committed_until_ms) {
+        run_window(session, tail, true);
+    }
+    
+    // Calculate session duration
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(
+        end - session.start_time).count();
+    
+    // Committed words are already de-duplicated across windows; with
+    // endpointing they only cover the utterance still open
+    std::string final_text = committed_text(session);
+    
+    if (session.final_model) {
+        // Earlier utterances first, then the open one on this thread
+        stop_final_passes(session, false);
+        deliver_finals(session);
+        
+        int64_t buffered_end = session.buffer_start_sample + (int64_t)session.window_audio.size();
+        if ((session.in_utterance || !final_text.empty()) && 
+            buffered_end > session.utterance_start_sample) {
+            FinalJob job = utterance_job(session, buffered_end, final_text);
+            job.utterance++;    // Still open, not counted yet
+            final_text = transcribe_final(session, job);
+        }
+    }
+    
+    // Copy to output
+    strncpy(out_text, final_text.c_str(), text_size - 1);
+    out_text[text_size - 1] = '\0';
+    
+    g_finalize_latency.record(ms_to_us(elapsed_ms(session.call_start, std::chrono::high_resolution_clock::now())));
+    
+    printf("[whisper_backend] Session %u finalized: %.2fms, %d windows, %d skipped, final: '%s'\n",
+           session_id, duration, session.windows_run, session.windows_skipped,
+           final_text.substr(0, 50).c_str());
+    
+    // Session destroyed (state freed with the last reference)
+    session.active = false;
+    
+    return WB_OK;
+}
+
+WBErrorCode wb_abort_session(uint32_t session_id) {
+    std::shared_ptr<StreamingSession> handle = take_session(session_id);
+    if (!handle) {
+        return WB_OK;  // Already inactive
+    }
+    
+    // Waits for an in-flight window on this session to finish
+    std::lock_guard<std::mutex> session_lock(handle->mutex);
+    handle->active = false;
+    stop_final_passes(*handle, true);
+    
+    printf("[whisper_backend] Session %u aborted\n", session_id);
+    
+    return WB_OK;
+}
+
+/* ============================================
+ * Batch Transcription Implementation
+ * ============================================ */
+
+// Batch segment lengths (one whisper window holds 30 s)
+static const int BATCH_TARGET_SEGMENT_MS = 20000;
+static const int BATCH_MAX_SEGMENT_MS = 28000;
+static const int WHISPER_WINDOW_MS = 30000;
+static const int BATCH_THREADS_PER_SEGMENT = 4;
+
+/**
+ * Result of one batch run
+ */
+struct BatchRun {
+    std::string text;
+    int segments = 0;       // Including segments without speech
+    int transcribed = 0;
+    int workers = 0;
+    double wall_ms = 0.0;
+};
+
+WBBatchParams wb_default_batch_params(void) {
+    WBBatchParams params;
+    params.language = nullptr;  // Auto-detect
+    params.translate = 0;
+    params.n_threads = 0;       // BATCH_THREADS_PER_SEGMENT
+    params.n_workers = 0;       // Hardware threads / n_threads
+    params.target_segment_ms = BATCH_TARGET_SEGMENT_MS;
+    params.max_segment_ms = BATCH_MAX_SEGMENT_MS;
+    return params;
+}
+
+/**
+ * Idle batch state of the model, or a new one (NULL when out of memory)
+ */
+static struct whisper_state* take_batch_state(LoadedModel& model) {
+    {
+        std::lock_guard<std::mutex> lock(model.batch_mutex);
+        if (!model.batch_states.empty()) {
+            struct whisper_state* state = model.batch_states.back();
+            model.batch_states.pop_back();
+            return state;
+        }
+    }
+    return take_state(model);
+}
+
+static void return_batch_state(LoadedModel& model, struct whisper_state* state) {
+    std::lock_guard<std::mutex> lock(model.batch_mutex);
+    model.batch_states.push_back(state);
+}
+
+/**
+ * Transcribe one segment on a worker state
+ * @return false if inference failed
+ */
+static bool transcribe_segment(
+    LoadedModel& model,
+    struct whisper_state* state,
+    const WBBatchParams& params,
+    int n_threads,
+    const float* pcm,
+    size_t n_samples,
+    std::string& out_text
+) {
+    TraceScope trace("batch_segment", "backend", "samples", (int64_t)n_samples);
+    // whisper drops audio shorter than about a second
+    std::vector<float> padded;
+    if (n_samples < MIN_INFERENCE_SAMPLES) {
+        padded.assign(pcm, pcm + n_samples);
+        padded.resize(MIN_INFERENCE_SAMPLES, 0.0f);
+        pcm = padded.data();
+        n_samples = padded.size();
     }
     
-    // Per-chunk inference (stateless at whisper.cpp level)
     struct whisper_full_params wparams = 
         whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
     
@@ -387,127 +2428,547 @@ WBErrorCode wb_process_chunk(
     wparams.print_special = false;
     wparams.print_realtime = false;
     wparams.print_timestamps = false;
-    wparams.translate = 0;
-    wparams.single_segment = true;  // Force single segment for chunk
-    wparams.no_context = true;      // Stateless - no state reuse
-    wparams.language = "en";
-    
-    // Run inference on chunk
-    auto start = std::chrono::high_resolution_clock::now();
-    int result = whisper_full(g_ctx, wparams, pcm_data, (int)n_samples);
-    auto end = std::chrono::high_resolution_clock::now();
-    
-    double chunk_time = std::chrono::duration<double, std::milli>(end - start).count();
+    wparams.translate = params.translate;
+    wparams.single_segment = false;
+    wparams.no_context = true;
+    wparams.n_threads = n_threads;
+    if (params.language) {
+        wparams.language = params.language;
+    }
     
-    if (result != 0) {
-        // Recoverable error: drop chunk, continue session
-        printf("[whisper_backend] Chunk inference failed (dropped)\n");
-        return WB_OK;  // Continue session
+    if (whisper_full_with_state(model.ctx, state, wparams, pcm, (int)n_samples) != 0) {
+        return false;
     }
     
-    // Extract partial transcript
-    std::string partial;
-    int n_segments = whisper_full_n_segments(g_ctx);
+    std::string text;
+    int n_segments = whisper_full_n_segments_from_state(state);
     for (int i = 0; i < n_segments; i++) {
-        const char* text = whisper_full_get_segment_text(g_ctx, i);
-        if (text) {
-            partial += text;
+        const char* segment_text = whisper_full_get_segment_text_from_state(state, i);
+        if (segment_text) {
+            text += segment_text;
+        }
+    }
+    out_text = trim_text(text);
+    return true;
+}
+
+/**
+ * Split a recording at pauses and transcribe the segments on parallel
+ * workers. Each worker pulls the next segment index, so a slow segment
+ * never holds back the others.
+ */
+static WBErrorCode run_batch(
+    LoadedModel& model,
+    const float* pcm_data,
+    size_t n_samples,
+    const WBBatchParams& params,
+    BatchRun& run
+) {
+    int max_ms = params.max_segment_ms > 0 ? params.max_segment_ms : BATCH_MAX_SEGMENT_MS;
+    max_ms = std::min(max_ms, WHISPER_WINDOW_MS);
+    int target_ms = params.target_segment_ms > 0 ? params.target_segment_ms : BATCH_TARGET_SEGMENT_MS;
+    target_ms = std::min(target_ms, max_ms);
+    
+    int n_threads = params.n_threads > 0 ? params.n_threads : BATCH_THREADS_PER_SEGMENT;
+    int n_workers = params.n_workers;
+    if (n_workers <= 0) {
+        n_workers = std::max(1, (int)std::thread::hardware_concurrency() / n_threads);
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    std::vector<VadSegment> segments = vad_split_segments(
+        pcm_data, n_samples, VAD_FRAME_SAMPLES, ms_to_samples(target_ms), ms_to_samples(max_ms));
+    
+    std::vector<size_t> speech;
+    for (size_t i = 0; i < segments.size(); i++) {
+        if (segments[i].has_speech) {
+            speech.push_back(i);
         }
     }
+    n_workers = std::max(1, std::min(n_workers, (int)speech.size()));
     
-    // Store partial transcript (for final merge)
-    if (!partial.empty()) {
-        g_session.partial_transcripts.push_back(partial);
-        
-        // Emit partial via callback
-        if (g_session.callback) {
-            g_session.callback(partial.c_str(), g_session.user_data);
+    std::vector<std::string> texts(segments.size());
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::atomic<int> started{0};
+    
+    auto worker = [&]() {
+        struct whisper_state* state = take_batch_state(model);
+        if (!state) {
+            return;     // The other workers take its share
+        }
+        started++;
+        for (size_t i = next++; i < speech.size() && !failed; i = next++) {
+            const VadSegment& segment = segments[speech[i]];
+            if (!transcribe_segment(model, state, params, n_threads,
+                                    pcm_data + segment.start, segment.end - segment.start,
+                                    texts[speech[i]])) {
+                failed = true;
+            }
         }
+        return_batch_state(model, state);
+    };
+    
+    std::vector<std::thread> threads;
+    for (int i = 1; i < n_workers && i < (int)speech.size(); i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
     }
     
-    printf("[whisper_backend] Chunk processed: %.2fms, text: '%s'\n", 
-           chunk_time, partial.c_str());
+    auto end = std::chrono::high_resolution_clock::now();
+    run.wall_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    run.segments = (int)segments.size();
+    run.transcribed = (int)speech.size();
+    run.workers = started.load();
     
-    // Transient buffers freed automatically by whisper_full
+    if (!speech.empty() && run.workers == 0) {
+        return WB_ERROR_OUT_OF_MEMORY;
+    }
+    if (failed) {
+        return WB_ERROR_INFERENCE_FAILED;
+    }
     
+    // Stitch in time order
+    run.text.clear();
+    for (const std::string& text : texts) {
+        if (text.empty()) {
+            continue;
+        }
+        if (!run.text.empty()) {
+            run.text += ' ';
+        }
+        run.text += text;
+    }
     return WB_OK;
 }
 
-WBErrorCode wb_finalize_session(
-    uint32_t session_id,
+WBErrorCode wb_transcribe_batch(
+    const float* pcm_data,
+    size_t n_samples,
+    const WBBatchParams* params,
     char* out_text,
     size_t text_size
 ) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    TraceScope trace("transcribe_batch", "backend", "samples", (int64_t)n_samples);
+    std::shared_ptr<LoadedModel> model;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        
+        if (!g_initialized) {
+            return WB_ERROR_NOT_INITIALIZED;
+        }
+        model = g_model;
+    }
     
-    if (!g_session.active || g_session.id != session_id) {
-        return WB_ERROR_INFERENCE_FAILED;
+    if (!model) {
+        return WB_ERROR_MODEL_LOAD_FAILED;
     }
     
-    if (!out_text || text_size == 0) {
+    if (!pcm_data || n_samples == 0) {
         return WB_ERROR_INVALID_AUDIO;
     }
     
-    // Calculate session duration
-    auto end = std::chrono::high_resolution_clock::now();
-    double duration = std::chrono::duration<double, std::milli>(
-        end - g_session.start_time).count();
-    
-    // Merge partial transcripts
-    // Strategy: Simple concatenation with space deduplication
-    // Phase 2.3: No overlap, so simple join works
-    std::string final_text;
-    
-    for (const auto& partial : g_session.partial_transcripts) {
-        if (!partial.empty()) {
-            // Avoid leading space duplication
-            if (!final_text.empty() && 
-                final_text.back() != ' ' && 
-                partial.front() != ' ') {
-                final_text += ' ';
-            }
-            final_text += partial;
-        }
+    if (!out_text || text_size == 0) {
+        return WB_ERROR_INFERENCE_FAILED;
     }
     
-    // Trim leading/trailing whitespace
-    size_t start = final_text.find_first_not_of(" \t\n");
-    size_t end_pos = final_text.find_last_not_of(" \t\n");
-    if (start != std::string::npos && end_pos != std::string::npos) {
-        final_text = final_text.substr(start, end_pos - start + 1);
+    WBBatchParams batch_params = params ? *params : wb_default_batch_params();
+    
+    printf("[whisper_backend] Batch transcription of %zu samples...\n", n_samples);
+    
+    BatchRun run;
+    WBErrorCode result = run_batch(*model, pcm_data, n_samples, batch_params, run);
+    {
+        MetricsUpdate update;
+        g_metrics.last_inference_time_ms = run.wall_ms;
+        g_metrics.last_batch_segments = run.segments;
+        g_metrics.last_batch_workers = run.workers;
     }
     
-    // Copy to output
-    strncpy(out_text, final_text.c_str(), text_size - 1);
-    out_text[text_size - 1] = '\0';
+    if (result != WB_OK) {
+        printf("[whisper_backend] Batch transcription failed: %s\n", wb_error_message(result));
+        return result;
+    }
     
-    printf("[whisper_backend] Session %u finalized: %.2fms, %zu partials, final: '%s'\n",
-           session_id, duration, g_session.partial_transcripts.size(), 
-           final_text.substr(0, 50).c_str());
+    strncpy(out_text, run.text.c_str(), text_size - 1);
+    out_text[text_size - 1] = '\0';
     
-    // Session destroyed
-    g_session.active = false;
-    g_session.partial_transcripts.clear();
-    g_session.callback = nullptr;
-    g_session.user_data = nullptr;
+    double audio_ms = (double)samples_to_ms((int64_t)n_samples);
+    printf("[whisper_backend] Batch completed in %.2f ms: %d segments (%d with speech) on %d workers, RTF %.3f\n",
+           run.wall_ms, run.segments, run.transcribed, run.workers,
+           audio_ms > 0 ? run.wall_ms / audio_ms : 0.0);
     
     return WB_OK;
 }
 
-WBErrorCode wb_abort_session(uint32_t session_id) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+/* ============================================
+ * Batch Job Implementation
+ * ============================================ */
+
+static const int BATCH_JOB_IO_THREADS = 2;
+
+/**
+ * File of a batch job, in scheduling order
+ */
+struct JobFile {
+    std::string path;
+    double duration_ms = 0.0;   // From the header; 0 if it cannot be read
+};
+
+/**
+ * File read by an I/O thread, waiting for a worker
+ */
+struct DecodedFile {
+    size_t index = 0;           // Into the job's file list (lower = longer)
+    std::vector<float> pcm;
+    std::string error;          // Empty when the file was read
+    double decode_ms = 0.0;
+};
+
+/**
+ * State shared by the I/O threads and workers of one job
+ */
+struct BatchJob {
+    std::vector<JobFile> files;
+    WBBatchParams params;
+    int n_threads = 0;
+    
+    std::mutex mutex;
+    std::condition_variable ready_cv;   // Decoded file available or input done
+    std::condition_variable space_cv;   // Room to decode another file
+    size_t next_decode = 0;
+    int decoding = 0;
+    size_t capacity = 0;
+    std::vector<DecodedFile> ready;
+    
+    // Output side, under output_mutex
+    std::mutex output_mutex;
+    FILE* output = nullptr;
+    FILE* checkpoint = nullptr;
+    WBBatchFileCallback on_file = nullptr;
+    void* user_data = nullptr;
+    WBBatchJobSummary summary = {};
+    size_t reported = 0;
+};
+
+WBBatchJobConfig wb_default_batch_job_config(void) {
+    WBBatchJobConfig config;
+    config.files = nullptr;
+    config.n_files = 0;
+    config.output_path = nullptr;
+    config.checkpoint_path = nullptr;
+    config.language = nullptr;      // Auto-detect
+    config.translate = 0;
+    config.n_workers = 0;           // Hardware threads / n_threads
+    config.n_threads = 0;           // BATCH_THREADS_PER_SEGMENT
+    config.n_io_threads = 0;        // BATCH_JOB_IO_THREADS
+    config.on_file = nullptr;
+    config.user_data = nullptr;
+    return config;
+}
+
+/**
+ * Append text to out as a JSON string literal
+ */
+static void append_json_string(std::string& out, const char* text) {
+    out += '"';
+    for (const char* p = text; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += (char)c;
+                }
+        }
+    }
+    out += '"';
+}
+
+/**
+ * Paths listed in a checkpoint file, one per line
+ */
+static std::vector<std::string> read_checkpoint(const std::string& path) {
+    std::vector<std::string> done;
+    FILE* file = fopen(path.c_str(), "r");
+    if (!file) {
+        return done;
+    }
+    std::string line;
+    int c;
+    while ((c = fgetc(file)) != EOF) {
+        if (c == '\n') {
+            if (!line.empty()) {
+                done.push_back(line);
+            }
+            line.clear();
+        } else {
+            line += (char)c;
+        }
+    }
+    // A line without newline was cut off mid-write
+    fclose(file);
+    std::sort(done.begin(), done.end());
+    return done;
+}
+
+/**
+ * I/O thread: read files in scheduling order while there is room
+ */
+static void batch_io_thread(BatchJob& job) {
+    std::unique_lock<std::mutex> lock(job.mutex);
+    while (true) {
+        job.space_cv.wait(lock, [&job] {
+            return job.next_decode >= job.files.size() ||
+                   job.ready.size() + (size_t)job.decoding < job.capacity;
+        });
+        if (job.next_decode >= job.files.size()) {
+            break;
+        }
+        DecodedFile decoded;
+        decoded.index = job.next_decode++;
+        job.decoding++;
+        lock.unlock();
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        if (!wav_load_16k_mono(job.files[decoded.index].path.c_str(), decoded.pcm, &decoded.error) &&
+            decoded.error.empty()) {
+            decoded.error = "cannot read file";
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        decoded.decode_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        
+        lock.lock();
+        job.decoding--;
+        job.ready.push_back(std::move(decoded));
+        job.ready_cv.notify_one();
+    }
+    // Workers waiting for the last file must see input is done
+    job.ready_cv.notify_all();
+}
+
+/**
+ * Write one result line (then the checkpoint entry) and report it
+ */
+static void report_batch_file(BatchJob& job, const WBBatchFileResult& result) {
+    std::string line = "{\"file\":";
+    append_json_string(line, result.path);
+    char numbers[192];
+    snprintf(numbers, sizeof(numbers),
+             ",\"status\":\"%s\",\"audio_s\":%.3f,\"decode_ms\":%.2f,\"inference_ms\":%.2f,\"rtf\":%.4f",
+             result.status == WB_OK ? "ok" : "error",
+             result.audio_ms / 1000.0, result.decode_ms, result.inference_ms, result.rtf);
+    line += numbers;
+    if (result.status == WB_OK) {
+        line += ",\"text\":";
+        append_json_string(line, result.text);
+    } else {
+        line += ",\"error\":";
+        append_json_string(line, result.error);
+    }
+    line += "}\n";
+    
+    std::lock_guard<std::mutex> lock(job.output_mutex);
+    fputs(line.c_str(), job.output);
+    fflush(job.output);
+    if (result.status == WB_OK) {
+        fprintf(job.checkpoint, "%s\n", result.path);
+        fflush(job.checkpoint);
+        job.summary.files_done++;
+        job.summary.audio_ms += result.audio_ms;
+    } else {
+        job.summary.files_failed++;
+    }
+    job.reported++;
     
-    if (!g_session.active || g_session.id != session_id) {
-        return WB_OK;  // Already inactive
+    printf("[whisper_backend] Batch file %zu/%zu %s: %s (%.1fs audio, RTF %.3f)\n",
+           job.reported, job.files.size(), result.status == WB_OK ? "done" : "failed",
+           result.path, result.audio_ms / 1000.0, result.rtf);
+    
+    if (job.on_file) {
+        job.on_file(&result, job.user_data);
+    }
+}
+
+/**
+ * Worker: transcribe the longest decoded file until input is done
+ */
+static void batch_worker(BatchJob& job, LoadedModel& model, struct whisper_state* state) {
+    while (true) {
+        DecodedFile decoded;
+        {
+            std::unique_lock<std::mutex> lock(job.mutex);
+            job.ready_cv.wait(lock, [&job] {
+                return !job.ready.empty() ||
+                       (job.next_decode >= job.files.size() && job.decoding == 0);
+            });
+            if (job.ready.empty()) {
+                return;
+            }
+            auto longest = std::min_element(job.ready.begin(), job.ready.end(),
+                [](const DecodedFile& a, const DecodedFile& b) { return a.index < b.index; });
+            decoded = std::move(*longest);
+            job.ready.erase(longest);
+            job.space_cv.notify_one();
+        }
+        
+        WBBatchFileResult result = {};
+        result.path = job.files[decoded.index].path.c_str();
+        result.decode_ms = decoded.decode_ms;
+        result.audio_ms = (double)samples_to_ms((int64_t)decoded.pcm.size());
+        
+        std::string text;
+        if (!decoded.error.empty()) {
+            result.status = WB_ERROR_INVALID_AUDIO;
+            result.error = decoded.error.c_str();
+        } else {
+            auto start = std::chrono::high_resolution_clock::now();
+            bool ok = transcribe_segment(model, state, job.params, job.n_threads,
+                                         decoded.pcm.data(), decoded.pcm.size(), text);
+            auto end = std::chrono::high_resolution_clock::now();
+            result.inference_ms = std::chrono::duration<double, std::milli>(end - start).count();
+            result.status = ok ? WB_OK : WB_ERROR_INFERENCE_FAILED;
+            result.error = ok ? nullptr : wb_error_message(WB_ERROR_INFERENCE_FAILED);
+            result.text = text.c_str();
+            result.rtf = result.audio_ms > 0 ? (float)(result.inference_ms / result.audio_ms) : 0.0f;
+        }
+        
+        // Free the audio before the next file is decoded into its place
+        decoded.pcm = std::vector<float>();
+        report_batch_file(job, result);
+    }
+}
+
+WBErrorCode wb_run_batch_job(const WBBatchJobConfig* config, WBBatchJobSummary* out_summary) {
+    std::shared_ptr<LoadedModel> model;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        
+        if (!g_initialized) {
+            return WB_ERROR_NOT_INITIALIZED;
+        }
+        model = g_model;
     }
     
-    printf("[whisper_backend] Session %u aborted\n", session_id);
+    if (!model) {
+        return WB_ERROR_MODEL_LOAD_FAILED;
+    }
     
-    g_session.active = false;
-    g_session.partial_transcripts.clear();
-    g_session.callback = nullptr;
-    g_session.user_data = nullptr;
+    if (!config || !config->output_path || (config->n_files > 0 && !config->files)) {
+        return WB_ERROR_INIT_FAILED;
+    }
     
-    return WB_OK;
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    BatchJob job;
+    job.params = wb_default_batch_params();
+    job.params.language = config->language;
+    job.params.translate = config->translate;
+    job.n_threads = config->n_threads > 0 ? config->n_threads : BATCH_THREADS_PER_SEGMENT;
+    job.on_file = config->on_file;
+    job.user_data = config->user_data;
+    
+    std::string checkpoint_path = config->checkpoint_path ? config->checkpoint_path
+                                                          : std::string(config->output_path) + ".checkpoint";
+    std::vector<std::string> done = read_checkpoint(checkpoint_path);
+    
+    // Longest first, so the last files to finish are short ones
+    for (size_t i = 0; i < config->n_files; i++) {
+        const char* path = config->files[i];
+        if (!path) {
+            continue;
+        }
+        if (std::binary_search(done.begin(), done.end(), std::string(path))) {
+            job.summary.files_skipped++;
+            continue;
+        }
+        JobFile file;
+        file.path = path;
+        WavInfo info = {};
+        if (wav_probe(path, info)) {
+            file.duration_ms = wav_duration_ms(info);
+        }
+        job.files.push_back(std::move(file));
+    }
+    std::stable_sort(job.files.begin(), job.files.end(), [](const JobFile& a, const JobFile& b) {
+        return a.duration_ms > b.duration_ms;
+    });
+    
+    job.output = fopen(config->output_path, "a");
+    job.checkpoint = fopen(checkpoint_path.c_str(), "a");
+    if (!job.output || !job.checkpoint) {
+        printf("[whisper_backend] Batch job cannot open %s\n",
+               job.output ? checkpoint_path.c_str() : config->output_path);
+        if (job.output) fclose(job.output);
+        if (job.checkpoint) fclose(job.checkpoint);
+        return WB_ERROR_INIT_FAILED;
+    }
+    
+    int n_workers = config->n_workers;
+    if (n_workers <= 0) {
+        n_workers = std::max(1, (int)std::thread::hardware_concurrency() / job.n_threads);
+    }
+    n_workers = std::max(1, std::min(n_workers, (int)job.files.size()));
+    int n_io_threads = config->n_io_threads > 0 ? config->n_io_threads : BATCH_JOB_IO_THREADS;
+    n_io_threads = std::max(1, std::min(n_io_threads, (int)job.files.size()));
+    
+    // States are taken up front, so the job runs on however many fit
+    std::vector<struct whisper_state*> states;
+    for (int i = 0; i < n_workers && !job.files.empty(); i++) {
+        struct whisper_state* state = take_batch_state(*model);
+        if (!state) {
+            break;
+        }
+        states.push_back(state);
+    }
+    
+    WBErrorCode result = WB_OK;
+    if (!job.files.empty() && states.empty()) {
+        result = WB_ERROR_OUT_OF_MEMORY;
+    } else if (!job.files.empty()) {
+        job.capacity = states.size() + (size_t)n_io_threads;
+        printf("[whisper_backend] Batch job: %zu files (%d already done), %zu workers, %d I/O threads\n",
+               job.files.size(), job.summary.files_skipped, states.size(), n_io_threads);
+        
+        std::vector<std::thread> threads;
+        for (int i = 0; i < n_io_threads; i++) {
+            threads.emplace_back(batch_io_thread, std::ref(job));
+        }
+        for (struct whisper_state* state : states) {
+            threads.emplace_back(batch_worker, std::ref(job), std::ref(*model), state);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+    
+    for (struct whisper_state* state : states) {
+        return_batch_state(*model, state);
+    }
+    fclose(job.output);
+    fclose(job.checkpoint);
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    job.summary.wall_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    printf("[whisper_backend] Batch job finished in %.2f ms: %d done, %d failed, %d skipped\n",
+           job.summary.wall_ms, job.summary.files_done, job.summary.files_failed,
+           job.summary.files_skipped);
+    
+    if (out_summary) {
+        *out_summary = job.summary;
+    }
+    return result;
 }
-
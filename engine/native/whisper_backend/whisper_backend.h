@@ -1,18 +1,19 @@
 /**
  * WisprFlex whisper.cpp Backend - Header
  * 
- * Phase 2.2.1: Thin wrapper over whisper.cpp
+ * C interface over whisper.cpp used by the engine and tools.
  * 
- * Purpose:
- * - Initialize whisper context
- * - Load gguf models
- * - Run single-shot inference
- * - Return transcription text
+ * Provides:
+ * - Model loading (memory-mapped, cancellable, with progress), shared
+ *   weights per path and an LRU model memory budget
+ * - Single-shot, batch (long recordings) and batch-job (many files)
+ *   transcription
+ * - Streaming sessions: sliding windows sized by the measured RTF, VAD
+ *   endpointing with per-utterance finals, two-tier final passes and
+ *   fallback to a faster model under load
+ * - Metrics, latency histograms and tracing
  * 
- * Constraints:
- * - CPU-only (no GPU flags)
- * - No streaming (Phase 2.3)
- * - No audio chunking
+ * CPU-only (no GPU flags).
  */
 
 #ifndef WISPRFLEX_WHISPER_BACKEND_H
@@ -37,7 +38,8 @@ typedef enum WBErrorCode {
     WB_ERROR_OUT_OF_MEMORY = 4,
     WB_ERROR_INFERENCE_FAILED = 5,
     WB_ERROR_INVALID_AUDIO = 6,
-    WB_ERROR_NOT_INITIALIZED = 7
+    WB_ERROR_NOT_INITIALIZED = 7,
+    WB_ERROR_CANCELLED = 8
 } WBErrorCode;
 
 /**
@@ -75,11 +77,55 @@ WBErrorCode wb_shutdown(void);
 /**
  * Load a whisper model from file path
  * 
+ * The file is read through a read-only memory mapping, so the disk
+ * pages live in the OS page cache, shared by every process loading the
+ * same model; a recently used model reloads without disk I/O.
+ * whisper.cpp keeps its own copy of the tensors, which is private memory.
+ * 
  * @param model_path Absolute path to .gguf model file
  * @return WB_OK on success
  */
 WBErrorCode wb_load_model(const char* model_path);
 
+/**
+ * Model load progress, called on the loading thread as the file is read
+ * 
+ * @param bytes_loaded Bytes of the model file read so far
+ * @param total_bytes Model file size
+ * @return 1 to continue, 0 to cancel (the load fails with WB_ERROR_CANCELLED)
+ */
+typedef int (*WBLoadProgressCallback)(size_t bytes_loaded, size_t total_bytes, void* user_data);
+
+/**
+ * Model load options
+ * 
+ * whisper.cpp allocates a state's KV caches and compute buffers, and
+ * first touches the weights, on the first inference. With warmup the
+ * load runs one short inference on silence before returning, so that
+ * cost (time and memory) is paid at load; the warmed state is reused by
+ * the next session. Buffer sizes are reported in WBMetrics.
+ */
+typedef struct WBLoadOptions {
+    int warmup;             /* 1 = run a warm-up inference at load, 0 = lazy (default) */
+    const char* model_id;   /* Registry label, e.g. "base" (NULL = file name) */
+    WBLoadProgressCallback progress_callback; /* NULL = no progress (default) */
+    void* progress_user_data;
+} WBLoadOptions;
+
+/**
+ * Default load options (no warm-up)
+ */
+WBLoadOptions wb_default_load_options(void);
+
+/**
+ * Load a whisper model with options
+ * 
+ * @param model_path Absolute path to .gguf model file
+ * @param options Load options (NULL for defaults)
+ * @return WB_OK on success
+ */
+WBErrorCode wb_load_model_with_options(const char* model_path, const WBLoadOptions* options);
+
 /**
  * Unload the currently loaded model
  */
@@ -98,6 +144,57 @@ int wb_is_model_loaded(void);
  */
 WBErrorCode wb_get_model_info(char* out_info, size_t info_size);
 
+/**
+ * Reference to loaded model weights, independent of wb_load_model.
+ * Lets several owners (e.g. engine instances) each hold their own model.
+ * Handles for the same path share one copy of the weights while any
+ * of them is alive.
+ */
+typedef struct WBModel WBModel;
+
+/**
+ * Load a model (or share an already loaded one) and return a handle
+ * 
+ * @param model_path Absolute path to .gguf model file
+ * @param out_model Receives the handle; release with wb_model_release
+ * @return WB_OK on success
+ */
+WBErrorCode wb_model_acquire(const char* model_path, WBModel** out_model);
+
+/**
+ * wb_model_acquire with load options (NULL for defaults)
+ * A model already warmed up by another owner is not warmed again.
+ */
+WBErrorCode wb_model_acquire_with_options(
+    const char* model_path,
+    const WBLoadOptions* options,
+    WBModel** out_model
+);
+
+/**
+ * Release a handle from wb_model_acquire
+ * Weights are freed once no handle or session uses them. NULL is ignored.
+ */
+void wb_model_release(WBModel* model);
+
+/**
+ * Set the model memory budget (process-wide, kept across wb_init/wb_shutdown)
+ * 
+ * Loaded models are tracked in a registry by path. Each is charged a
+ * predicted size (1.5x its file: weights plus compute buffers).
+ * 
+ * With budget_bytes > 0 the registry keeps models resident after their
+ * last owner releases them, so switching back is instant. A load that
+ * would exceed the budget first evicts idle models, least recently used
+ * first; if models in use would still leave too little room it fails
+ * with WB_ERROR_OUT_OF_MEMORY and evicts nothing. Lowering the budget
+ * evicts immediately.
+ * 
+ * With 0 (default) there is no limit and no retention: a model is freed
+ * as soon as nothing uses it.
+ */
+WBErrorCode wb_set_model_budget(size_t budget_bytes);
+
 /* ============================================
  * Single-Shot Transcription
  * ============================================ */
@@ -134,22 +231,283 @@ WBErrorCode wb_transcribe(
     size_t text_size
 );
 
+/* ============================================
+ * Batch Transcription (long recordings)
+ * ============================================ */
+
+/**
+ * Batch transcription parameters
+ * 
+ * The recording is cut at VAD pauses into segments of about
+ * target_segment_ms (never more than max_segment_ms, so each fits one
+ * whisper window) and n_workers segments are transcribed at once, each
+ * on its own whisper_state with n_threads threads. Segments without
+ * speech are not transcribed.
+ */
+typedef struct WBBatchParams {
+    const char* language;   /* NULL for auto-detect */
+    int translate;          /* 1 = translate to English */
+    int n_threads;          /* Threads per segment, 0 = 4 */
+    int n_workers;          /* Segments in parallel, 0 = hardware threads / n_threads */
+    int target_segment_ms;  /* Preferred segment length (default 20000) */
+    int max_segment_ms;     /* Longest segment, at most 30000 (default 28000) */
+} WBBatchParams;
+
+/**
+ * Default batch parameters
+ */
+WBBatchParams wb_default_batch_params(void);
+
+/**
+ * Transcribe a long recording in parallel segments
+ * Segment texts are joined in time order. Worker states stay with the
+ * model for the next batch, so repeated calls do not reallocate them.
+ * 
+ * @param pcm_data PCM Float32 audio (16kHz, mono)
+ * @param n_samples Number of samples
+ * @param params Batch parameters (NULL for defaults)
+ * @param out_text Buffer to receive transcription
+ * @param text_size Size of output buffer
+ * @return WB_OK on success, WB_ERROR_INFERENCE_FAILED if any segment failed
+ */
+WBErrorCode wb_transcribe_batch(
+    const float* pcm_data,
+    size_t n_samples,
+    const WBBatchParams* params,
+    char* out_text,
+    size_t text_size
+);
+
+/* ============================================
+ * Batch Jobs (many files)
+ * ============================================ */
+
+/**
+ * Result of one file in a batch job
+ */
+typedef struct WBBatchFileResult {
+    const char* path;
+    WBErrorCode status;         /* WB_ERROR_INVALID_AUDIO if the WAV could not be read */
+    const char* error;          /* Reason on failure, NULL on success */
+    const char* text;           /* Transcript (valid during the callback only) */
+    double audio_ms;            /* Duration at 16kHz */
+    double decode_ms;           /* WAV read and resample (I/O thread) */
+    double inference_ms;
+    float rtf;                  /* inference_ms / audio_ms */
+} WBBatchFileResult;
+
+typedef void (*WBBatchFileCallback)(const WBBatchFileResult* result, void* user_data);
+
+/**
+ * Batch job configuration
+ * 
+ * Files are transcribed with the currently loaded model, longest first,
+ * n_workers at a time. I/O threads read and resample upcoming files while
+ * workers run; at most n_workers + n_io_threads files are held decoded.
+ * 
+ * Each result is appended to output_path as one JSON line. Successful
+ * files are then appended to checkpoint_path and skipped when the job is
+ * run again, so an interrupted job resumes where it stopped (a file cut
+ * off between the two writes is transcribed again).
+ */
+typedef struct WBBatchJobConfig {
+    const char* const* files;
+    size_t n_files;
+    const char* output_path;        /* JSON lines, appended */
+    const char* checkpoint_path;    /* NULL = output_path + ".checkpoint" */
+    const char* language;           /* NULL for auto-detect */
+    int translate;                  /* 1 = translate to English */
+    int n_workers;                  /* Files in parallel, 0 = hardware threads / n_threads */
+    int n_threads;                  /* Threads per file, 0 = 4 */
+    int n_io_threads;               /* Decode threads, 0 = 2 */
+    WBBatchFileCallback on_file;    /* Called after each file (may be NULL) */
+    void* user_data;
+} WBBatchJobConfig;
+
+/**
+ * Batch job totals
+ */
+typedef struct WBBatchJobSummary {
+    int files_done;
+    int files_failed;
+    int files_skipped;          /* Already in the checkpoint */
+    double audio_ms;            /* Of the files done */
+    double wall_ms;
+} WBBatchJobSummary;
+
+/**
+ * Default batch job configuration (no files, no output)
+ */
+WBBatchJobConfig wb_default_batch_job_config(void);
+
+/**
+ * Transcribe a list of WAV files with the loaded model
+ * Failed files do not stop the job; they get an error line.
+ * 
+ * @param config Job configuration
+ * @param out_summary Receives totals (may be NULL)
+ * @return WB_OK when every file was attempted, WB_ERROR_INIT_FAILED if
+ *         the output or checkpoint file cannot be opened
+ */
+WBErrorCode wb_run_batch_job(const WBBatchJobConfig* config, WBBatchJobSummary* out_summary);
+
 /* ============================================
  * Performance Metrics (for validation)
  * ============================================ */
 
+/**
+ * Why a streaming window did not run inference
+ */
+typedef enum WBSkipReason {
+    WB_SKIP_NONE = 0,           /* Window was transcribed */
+    WB_SKIP_SILENCE = 1         /* VAD found no speech; whisper_full not called */
+} WBSkipReason;
+
+/**
+ * Where the time of one streaming window went
+ * 
+ * Stage boundaries come from whisper's hooks: the mel spectrogram is
+ * computed before the encoder-begin hook, the encoder and the prompt
+ * pass run before the first logits-filter hook, and the rest is the
+ * token loop. whisper's public API reports no boundary between decoder
+ * passes and token sampling, so decode_ms covers both.
+ */
+typedef struct WBStageTimings {
+    double queue_wait_ms;       /* Caller-reported wait plus time behind earlier windows of the call */
+    double mel_ms;              /* PCM to log-mel spectrogram */
+    double encode_ms;           /* Encoder and prompt pass, up to the first token */
+    double decode_ms;           /* Token loop: decoder passes and sampling */
+    double callback_ms;         /* Partial callback */
+    double inference_ms;        /* Whole whisper_full call */
+} WBStageTimings;
+
+/**
+ * Per-window timing record (WBSessionConfig::timing_callback)
+ */
+typedef struct WBChunkTiming {
+    uint32_t session_id;
+    int64_t window_start_ms;    /* Session time of the window */
+    int64_t window_end_ms;
+    int audio_ctx;              /* Encoder frames used */
+    int decode_steps;           /* Tokens sampled (all decoders and temperatures) */
+    WBStageTimings stages;
+} WBChunkTiming;
+
+/* Transcribed windows the rolling stage aggregates cover */
+#define WB_STAGE_HISTORY 64
+
 typedef struct WBMetrics {
     double model_load_time_ms;
     double last_inference_time_ms;
-    size_t model_memory_bytes;
-    size_t peak_memory_bytes;
+    size_t model_memory_bytes;  /* Private memory growth across the last load (whisper's weight buffers) */
+    size_t peak_memory_bytes;   /* Process resident high-water mark (now; snapshot: as of the last load) */
+    int last_audio_ctx;         /* Encoder frames used by the last window (1500 = full 30 s) */
+    int windows_inferred;       /* Streaming windows passed to whisper_full since init */
+    int windows_skipped;        /* Streaming windows skipped since init */
+    double skipped_audio_ms;    /* New audio covered by skipped windows */
+    WBSkipReason last_skip_reason; /* Outcome of the most recent window */
+    int utterances_endpointed;  /* Utterances closed by VAD endpointing since init */
+    double warmup_time_ms;      /* Last warm-up at load (0 = none) */
+    size_t state_buffer_bytes;  /* Private memory growth allocating a state (KV caches, compute buffers) */
+    size_t warmup_compute_bytes;/* Further growth during the warm-up inference */
+    size_t model_mapped_bytes;  /* Model file mapped read-only by the last load (0 = read fallback) */
+    size_t mapped_resident_bytes;  /* Resident file-backed pages, shared via page cache (now) */
+    size_t private_resident_bytes; /* Resident memory private to this process (now) */
+    int resident_models;        /* Models held by the registry (now) */
+    size_t resident_model_bytes;/* Predicted size of those models (now) */
+    int model_cache_hits;       /* Loads served by an already resident model */
+    int model_evictions;        /* Idle models evicted to fit the budget */
+    int current_window_ms;      /* Window of the last adaptive session that measured one */
+    double window_rtf;          /* Its smoothed inference time / new audio */
+    int final_passes;           /* Utterances re-transcribed by a two-tier final model since init */
+    double last_final_time_ms;  /* whisper_full time of the last final pass */
+    int quality_level;          /* WBQualityLevel of the last session that changed level */
+    int quality_changes;        /* Level changes (both directions) since init */
+    int last_batch_segments;    /* Segments of the last wb_transcribe_batch (incl. silent) */
+    int last_batch_workers;     /* Workers it ran on */
+    WBChunkTiming last_chunk;   /* Most recent transcribed window, any session */
+    WBStageTimings stage_mean;  /* Mean over the last stage_windows transcribed windows */
+    WBStageTimings stage_max;   /* Maximum of each stage over the same windows */
+    int stage_windows;          /* Windows in the aggregates (up to WB_STAGE_HISTORY) */
+    size_t proportional_resident_bytes; /* PSS: resident with shared pages split among the
+                                           processes mapping them (now, Linux only) */
 } WBMetrics;
 
 /**
  * Get current performance metrics
+ * Resident memory fields are sampled at the time of the call. Memory is
+ * attributed to weights (model_memory_bytes) and compute buffers
+ * (state_buffer_bytes + warmup_compute_bytes per session state).
  */
 WBMetrics wb_get_metrics(void);
 
+/**
+ * Latency distribution of one pipeline stage
+ * Percentiles are accurate to about 6% (log-linear buckets).
+ */
+typedef struct WBLatencyStats {
+    uint64_t count;
+    double mean_ms;
+    double p50_ms;
+    double p90_ms;
+    double p99_ms;
+    double p999_ms;
+    double max_ms;
+} WBLatencyStats;
+
+/**
+ * Metrics for monitoring threads, read without taking any backend lock
+ * 
+ * Histograms cover every value since wb_init:
+ * - chunk_latency: queue wait + whisper_full + partial callback of each
+ *   transcribed window (the delay a partial adds after its audio)
+ * - queue_wait: queue_wait_ms of each transcribed window
+ * - first_partial: first audio of a session (as pushed, including the
+ *   caller's queue wait) to its first partial
+ * - finalize: duration of each wb_finalize_session call
+ */
+typedef struct WBMetricsSnapshot {
+    WBMetrics metrics;          /* As of the last update; fields sampled by wb_get_metrics
+                                   (resident memory, registry) are zero */
+    WBLatencyStats chunk_latency;
+    WBLatencyStats queue_wait;
+    WBLatencyStats first_partial;
+    WBLatencyStats finalize;
+} WBMetricsSnapshot;
+
+/**
+ * Lock-free metrics snapshot
+ * Never waits for inference, model loads or wb_get_metrics, so it can be
+ * polled from any thread at any rate.
+ */
+WBMetricsSnapshot wb_get_metrics_snapshot(void);
+
+/* ============================================
+ * Tracing
+ * ============================================ */
+
+/**
+ * Start capturing a pipeline trace (process-wide, discards the last one)
+ * Spans cover chunk processing, each window's whisper_full call split
+ * into mel/encode/decode, callbacks, finalization, final passes, batch
+ * segments and model loads; the engine adds its own (push, drain,
+ * events). Costs one relaxed atomic load per span when not capturing.
+ * 
+ * @param max_events_per_thread Events kept per thread; later ones are
+ *        dropped and counted (0 = 65536, about 3 MB per thread)
+ * @return WB_OK
+ */
+WBErrorCode wb_trace_start(size_t max_events_per_thread);
+
+/**
+ * Stop capturing and write the trace as Chrome trace-event JSON
+ * (open in ui.perfetto.dev or chrome://tracing)
+ * 
+ * @param output_path File to write (NULL = stop without writing)
+ * @return WB_OK, or WB_ERROR_INIT_FAILED if the file cannot be written
+ */
+WBErrorCode wb_trace_stop(const char* output_path);
+
 /* ============================================
  * Phase 2.3: Streaming Session APIs
  * ============================================ */
@@ -159,9 +517,122 @@ WBMetrics wb_get_metrics(void);
  */
 typedef void (*WBPartialCallback)(const char* partial_text, void* user_data);
 
+/**
+ * Callback for an utterance closed by VAD endpointing
+ * Receives the user_data passed at session start.
+ */
+typedef void (*WBUtteranceCallback)(const char* final_text, void* user_data);
+
+/**
+ * How a degrading session transcribes (see WBSessionConfig::degrade_rtf)
+ */
+typedef enum WBQualityLevel {
+    WB_QUALITY_FULL = 0,            /* Session model, default decoding */
+    WB_QUALITY_FAST_DECODE = 1,     /* Single greedy pass, no temperature fallback */
+    WB_QUALITY_FALLBACK_MODEL = 2   /* fallback_model, fast decoding */
+} WBQualityLevel;
+
+/**
+ * Callback for a quality level change
+ * rtf is the smoothed inference time per second of audio that caused it.
+ */
+typedef void (*WBQualityCallback)(WBQualityLevel level, float rtf, void* user_data);
+
+/**
+ * Callback with the timing record of each transcribed window
+ * Receives the user_data passed at session start.
+ */
+typedef void (*WBChunkTimingCallback)(const WBChunkTiming* timing, void* user_data);
+
+/**
+ * Streaming session configuration
+ * 
+ * Audio is transcribed in overlapping windows (STREAMING_STRATEGY.md 3.2):
+ * each window is window_ms long and starts step_ms after the previous one.
+ * Words inside the overlap are assigned to exactly one window by their
+ * timestamps, so text at window edges is neither cut nor duplicated.
+ * 
+ * Whisper pads every input to 30 s (1500 encoder frames, 20 ms each).
+ * With reduce_audio_ctx the encoder only runs over the window plus
+ * audio_ctx_margin_ms, never fewer than audio_ctx_min frames.
+ * 
+ * With vad_enabled a window without any speech frame is not transcribed
+ * at all (saves CPU, avoids hallucinated text on silence); it is counted
+ * in WBMetrics with WB_SKIP_SILENCE. Frames (30 ms) are classified as
+ * audio is pushed, by energy and zero-crossing rate against a threshold
+ * that rises with the session's background noise floor.
+ * 
+ * Endpointing (vad_enabled, endpoint_silence_ms > 0 and an
+ * utterance_callback): after endpoint_silence_ms of continuous silence
+ * following speech the utterance is transcribed to its end, delivered to
+ * utterance_callback and the session starts over at the next speech
+ * onset. wb_finalize_session then only returns the open utterance, so
+ * its cost does not grow with session length.
+ * 
+ * Adaptive windows (adaptive_window): after each transcribed window the
+ * session compares its whisper_full time with the new audio the window
+ * covered (RTF over the step, smoothed). Above target_rtf the step and
+ * window grow (overlap unchanged) up to max_window_ms, since most of the
+ * cost is per call; below half of target_rtf they shrink back towards
+ * min_window_ms so partials come as often as the hardware allows.
+ * The session starts at window_ms.
+ * 
+ * Two-tier sessions (final_model, requires endpointing): the session's
+ * own model only drafts partials on the short windows. Each closed
+ * utterance is re-transcribed in one pass by final_model on a background
+ * thread of the session (final_n_threads), while drafting of the next
+ * utterance continues; utterance_callback and wb_finalize_session return
+ * the final model's text. Both models read the session's one audio
+ * buffer, which keeps the open utterance until it is handed to the
+ * final pass. Finished finals are delivered from the next
+ * wb_process_chunk (or wb_finalize_session), so callbacks of a session
+ * still never run concurrently.
+ * 
+ * Degradation (degrade_rtf > 0): the session also keeps a smoothed RTF
+ * per quality level. When it stays above degrade_rtf (the session falls
+ * behind real time even after adaptive windows have grown) the session
+ * steps down one WBQualityLevel; the fallback model level is only used
+ * with a fallback_model. Once the RTF has stayed below half of
+ * degrade_rtf for a while it steps back up; a step up that has to be
+ * undone soon doubles the wait before the next one. Every change is
+ * reported to quality_callback.
+ */
+typedef struct WBSessionConfig {
+    const char* language;   /* NULL for "en" */
+    int window_ms;          /* Inference window length (default 1500) */
+    int step_ms;            /* Window advance; overlap = window_ms - step_ms (default 1200) */
+    int max_window_ms;      /* Longest window when audio backs up; 0 = window_ms */
+    int reduce_audio_ctx;   /* 1 = size encoder context to the window (default), 0 = full 30 s */
+    int audio_ctx_margin_ms;/* Extra context past the window end (default 200) */
+    int audio_ctx_min;      /* Floor in encoder frames (default 128) */
+    int n_threads;          /* Inference threads for this session, 0 = auto */
+    int vad_enabled;        /* 1 = skip silent windows (default), 0 = transcribe everything */
+    int endpoint_silence_ms;/* Silence that ends an utterance (default 700), 0 = no endpointing */
+    WBUtteranceCallback utterance_callback; /* NULL = no endpointing (default) */
+    int adaptive_window;    /* 1 = size windows from measured RTF, 0 = fixed (default) */
+    int min_window_ms;      /* Adaptive: smallest window, 0 = window_ms (default) */
+    float target_rtf;       /* Adaptive: inference time per second of new audio to stay below (default 0.5) */
+    WBModel* final_model;   /* Two-tier: model for utterance finals, NULL = single model (default) */
+    int final_n_threads;    /* Two-tier: threads of the final pass, 0 = auto */
+    float degrade_rtf;      /* Degrade above this smoothed RTF, 0 = never (default) */
+    WBModel* fallback_model;/* Degradation: smaller model for the last level, NULL = none (default) */
+    WBQualityCallback quality_callback; /* Degradation: level changes, NULL = not reported */
+    WBChunkTimingCallback timing_callback; /* Stage timings per transcribed window, NULL = none */
+} WBSessionConfig;
+
+/**
+ * Default session configuration (1.5 s windows, 0.3 s overlap)
+ */
+WBSessionConfig wb_default_session_config(void);
+
 /**
  * Start a new streaming session
- * Only one session active at a time.
+ * 
+ * Sessions share the loaded model weights; each owns its own inference
+ * state (~tens of MB), so several sessions can run concurrently from
+ * different threads. Calls for one session must not overlap.
+ * A session keeps its model alive until it is finalized or aborted,
+ * even if the model is unloaded meanwhile.
  * 
  * @param callback Called for each partial transcript
  * @param user_data Passed to callback
@@ -169,16 +640,47 @@ typedef void (*WBPartialCallback)(const char* partial_text, void* user_data);
  */
 uint32_t wb_start_session(WBPartialCallback callback, void* user_data);
 
+/**
+ * Start a new streaming session with explicit configuration
+ * 
+ * @param config Session configuration (NULL for defaults)
+ * @param callback Called for each partial transcript
+ * @param user_data Passed to callback
+ * @return Session ID (0 on failure)
+ */
+uint32_t wb_start_session_with_config(
+    const WBSessionConfig* config,
+    WBPartialCallback callback,
+    void* user_data
+);
+
+/**
+ * Start a streaming session on a model handle instead of the model
+ * from wb_load_model
+ * 
+ * @param model Handle from wb_model_acquire
+ * @param config Session configuration (NULL for defaults)
+ * @param callback Called for each partial transcript
+ * @param user_data Passed to callback
+ * @return Session ID (0 on failure)
+ */
+uint32_t wb_start_model_session(
+    WBModel* model,
+    const WBSessionConfig* config,
+    WBPartialCallback callback,
+    void* user_data
+);
+
 /**
  * Process an audio chunk in the current session
  * 
- * Chunk size: 800ms = 12800 samples @ 16kHz
- * Each chunk is processed independently (no state reuse).
- * Transient buffers are freed after processing.
+ * Audio is appended to the session window. Inference runs once per
+ * completed window, so a call may run zero, one or several windows.
+ * Each partial carries only text committed by that window.
  * 
  * @param session_id Session from wb_start_session
  * @param pcm_data PCM Float32 audio (16kHz, mono)
- * @param n_samples Number of samples (should be ~12800 for 800ms)
+ * @param n_samples Number of samples (any size)
  * @return WB_OK on success
  */
 WBErrorCode wb_process_chunk(
@@ -187,6 +689,19 @@ WBErrorCode wb_process_chunk(
     size_t n_samples
 );
 
+/**
+ * wb_process_chunk for callers that queue audio before handing it over
+ * 
+ * @param queue_wait_ms How long the oldest of these samples waited in the
+ *        caller's queue; added to queue_wait_ms of the windows this call runs
+ */
+WBErrorCode wb_process_chunk_queued(
+    uint32_t session_id,
+    const float* pcm_data,
+    size_t n_samples,
+    double queue_wait_ms
+);
+
 /**
  * Check if audio chunk is silent (energy-based)
  * Used for EOS detection (silence > 700ms)
@@ -199,8 +714,11 @@ int wb_is_silent(const float* pcm_data, size_t n_samples);
 
 /**
  * Finalize session and get final transcript
- * Merges all partial transcripts.
- * Exactly one final transcript per session.
+ * Transcribes any audio not yet covered by a full window, then returns
+ * the de-duplicated text of all windows (with endpointing: of the
+ * utterance not yet delivered to utterance_callback).
+ * Exactly one final transcript per session. A two-tier session first
+ * waits for queued final passes and delivers them to utterance_callback.
  * 
  * @param session_id Session to finalize
  * @param out_text Buffer for final transcript
@@ -220,7 +738,7 @@ int wb_is_session_active(uint32_t session_id);
 
 /**
  * Abort session without finalizing
- * Used for error recovery.
+ * Used for error recovery. Pending two-tier final passes are dropped.
  */
 WBErrorCode wb_abort_session(uint32_t session_id);
 
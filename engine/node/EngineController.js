@@ -308,7 +308,10 @@ class EngineController extends EventEmitter {
             this.emit(EventType.BACKPRESSURE_WARNING, {
                 type: EventType.BACKPRESSURE_WARNING,
                 sessionId,
-                droppedChunks: 1
+                droppedChunks: 1,
+                mergedChunks: 0,
+                // Queued 16 kHz mono audio not yet transcribed
+                lagMs: Math.round(this._audioQueue.reduce((n, chunk) => n + chunk.length, 0) / 16)
             });
 
             // Drop oldest chunk (per STREAMING_STRATEGY.md Section 7.2)
@@ -13,6 +13,7 @@ const ErrorCode = {
     DEVICE_NOT_SUPPORTED: 'DEVICE_NOT_SUPPORTED',
     MODEL_NOT_FOUND: 'MODEL_NOT_FOUND',
     MODEL_LOAD_FAILED: 'MODEL_LOAD_FAILED',
+    MODEL_LOAD_CANCELLED: 'MODEL_LOAD_CANCELLED',
     MODEL_NOT_LOADED: 'MODEL_NOT_LOADED',
     OUT_OF_MEMORY: 'OUT_OF_MEMORY',
     SESSION_ALREADY_ACTIVE: 'SESSION_ALREADY_ACTIVE',
@@ -70,6 +71,9 @@ const Errors = {
     modelLoadFailed: (modelId, reason = 'Unknown error') =>
         new EngineError(ErrorCode.MODEL_LOAD_FAILED, `Failed to load model '${modelId}': ${reason}`, true),
 
+    modelLoadCancelled: (modelId) =>
+        new EngineError(ErrorCode.MODEL_LOAD_CANCELLED, `Loading model '${modelId}' was cancelled`, true),
+
     modelNotLoaded: () =>
         new EngineError(ErrorCode.MODEL_NOT_LOADED, 'No model is currently loaded', true),
 
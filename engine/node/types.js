@@ -47,7 +47,8 @@ const EventType = {
     FINAL_TRANSCRIPT: 'final_transcript',
     ERROR: 'error',
     MODEL_PROGRESS: 'model_progress',
-    BACKPRESSURE_WARNING: 'backpressure_warning'
+    BACKPRESSURE_WARNING: 'backpressure_warning',
+    QUALITY_CHANGED: 'quality_changed'
 };
 
 /**
@@ -83,7 +84,18 @@ const EventType = {
  * @typedef {Object} BackpressureWarningEvent
  * @property {'backpressure_warning'} type
  * @property {SessionId} sessionId
- * @property {number} droppedChunks
+ * @property {number} droppedChunks - Pushes rejected for backpressure (session total)
+ * @property {number} mergedChunks - Pushed chunks transcribed in merged windows (session total)
+ * @property {number} lagMs - Age of the oldest audio not yet transcribed
+ */
+
+/**
+ * @typedef {Object} QualityChangedEvent
+ * @property {'quality_changed'} type
+ * @property {SessionId} sessionId
+ * @property {number} level - 0 = full, 1 = fast decoding, 2 = fallback model
+ * @property {string} modelId
+ * @property {number} rtf
  */
 
 module.exports = {